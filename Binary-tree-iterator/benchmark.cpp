@@ -0,0 +1,99 @@
+// To compile: g++ -O2 -o benchmark.exe benchmark.cpp
+// Usage: ./benchmark.exe [largest size, default 10000000]
+// Lookups and in-order scans per second for Node and for BPlusTree with several node sizes, at 1M keys and
+// each tenfold up to the largest size. Node is only built up to 10M keys, where it already needs 0.5 GB.
+
+#include "bintree.h"
+#include "bplustree.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <numeric>
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+// Lookups per measurement
+const int lookups = 2000000;
+
+// Entries per range scan
+const int scanLength = 100;
+
+// Run f once and return the elapsed time in seconds
+template<typename F>
+double time_s(F f){
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double>(stop - start).count();
+}
+
+// Operations per second, in millions
+void report(const string & name, double operations, double seconds){
+    cout << "  " << left << setw(32) << name << right << fixed << setprecision(2) << setw(9)
+         << operations / seconds / 1e6 << " M/s" << endl;
+}
+
+void nodeTest(const vector<int> & keys, const vector<int> & probes){
+    Node<int, int>* t = nullptr;
+    report("Node: insert", keys.size(), time_s([&] { for (int key : keys) insert(t, key, key); }));
+    long long sum = 0;
+    report("Node: find", probes.size(), time_s([&] { for (int key : probes) sum += find(t, key); }));
+    report("Node: in-order scan", keys.size(), time_s([&] {
+        for (auto p = t->cbegin(); p != t->cend(); ++p) sum += p->data;
+    }));
+    cout << "  Node: height " << max_height(t) << " (checksum " << sum << ")" << endl;
+    delete_tree(t);
+}
+
+template<size_t NodeBytes>
+void bplusTest(const vector<int> & keys, const vector<int> & probes){
+    const string name = "B+ " + to_string(NodeBytes) + " B: ";
+    BPlusTree<int, int, NodeBytes> t;
+    report(name + "insert", keys.size(), time_s([&] { for (int key : keys) insert(t, key, key); }));
+    long long sum = 0;
+    report(name + "find", probes.size(), time_s([&] { for (int key : probes) sum += find(t, key); }));
+    report(name + "in-order scan", keys.size(), time_s([&] {
+        for (auto p = t.cbegin(); p != t.cend(); ++p) sum += p->data;
+    }));
+    const size_t scans = probes.size() / scanLength;
+    report(name + "range scan, entries", scans * scanLength, time_s([&] {
+        for (size_t i = 0; i < scans; i++) {
+            auto p = t.lower_bound(probes[i]);
+            for (int k = 0; k < scanLength && p != t.end(); k++, ++p) sum += p->data;
+        }
+    }));
+    cout << "  " << name << "height " << max_height(t) << ", " << t.leaf_capacity << " entries per leaf, "
+         << t.inner_capacity << " children per inner node (checksum " << sum << ")" << endl;
+}
+
+int main(int argc, char **argv){
+    const int largest = (argc > 1) ? stoi(argv[1]) : 10000000;
+    for (int n = 1000000; n <= largest; n *= 10) {
+        cout << "Shuffled keys, n = " << n << endl;
+        vector<int> keys(n);
+        iota(keys.begin(), keys.end(), 1);
+        shuffle(keys.begin(), keys.end(), default_random_engine(020416));
+        vector<int> probes(lookups);
+        uniform_int_distribution<int> dist(1, n);
+        default_random_engine rng(1);
+        for (int & probe : probes) {
+            probe = dist(rng);
+        }
+
+        if (n <= 10000000) {
+            nodeTest(keys, probes);
+        }
+        bplusTest<128>(keys, probes);
+        bplusTest<256>(keys, probes);
+        bplusTest<512>(keys, probes);
+        bplusTest<1024>(keys, probes);
+        if (n > largest / 10) {
+            break;  // n * 10 would overflow int for the largest sizes
+        }
+    }
+}
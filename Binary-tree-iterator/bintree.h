@@ -22,8 +22,8 @@ using namespace std;
 
 // Create a node
 template<typename S, typename T>
-Node<S, T>* createNode(S key, T data) {
-    Node<S, T>* newNode = new Node<S, T>;
+Node<S, T>* createNode(S key, T data, NodePool<Node<S, T>>* pool) {
+    Node<S, T>* newNode = (pool != nullptr) ? pool->allocate() : new Node<S, T>;
     newNode->key = key;
     newNode->data = data;
     newNode->left = nullptr;
@@ -32,22 +32,32 @@ Node<S, T>* createNode(S key, T data) {
     return newNode;
 }
 
+// Return a node to where it came from
+template<typename S, typename T>
+void free_node(Node<S, T>* node, NodePool<Node<S, T>>* pool) {
+    if (pool != nullptr) {
+        pool->release(node);
+    } else {
+        delete node;
+    }
+}
+
 // Insert a new node in the tree
 template<typename S, typename T>
-void insert(Node<S, T>* &p, S key, T to_be_inserted){     
+void insert(Node<S, T>* &p, S key, T to_be_inserted, NodePool<Node<S, T>>* pool){     
   // Recursively search for where to place the new node
   if (p == nullptr) {  // Base case - no node exists in current position in tree, so correct position has been found and new node is inserted
-      p = createNode(key, to_be_inserted);
+      p = createNode(key, to_be_inserted, pool);
   } else if(p->key == key){ // Duplicate key, so only update data
       p->data = to_be_inserted;
   }
   else if (key < p->key) { // New node key is less than key of node that p points to, so go left
-      insert(p->left, key, to_be_inserted);
+      insert(p->left, key, to_be_inserted, pool);
       if (p->left != nullptr) {   // If left child exists, update its parent
           p->left->parent = p;
       }
   } else {            // New node key is greater than key of node that p points to, so go right
-      insert(p->right, key, to_be_inserted); 
+      insert(p->right, key, to_be_inserted, pool);
       if (p->right != nullptr) { // If right child exists, update its parent
           p->right->parent = p;
       }
@@ -56,30 +66,30 @@ void insert(Node<S, T>* &p, S key, T to_be_inserted){
 
 // Remove a node
 template<typename S, typename T>
-void remove(Node<S, T>* &p, const S &key) {
+void remove(Node<S, T>* &p, const S &key, NodePool<Node<S, T>>* pool) {
   if (p == nullptr) { // Key not found
     throw out_of_range("Key not found!");
   }
   // Search for correct node with matching key
   if (key < p->key) { // Key to be removed is less than current node's key (that p points to), so go left
-    remove(p->left, key);
+    remove(p->left, key, pool);
   } else if (key > p->key) { // Key to be removed is greater than current node's key (that p points to), so go right
-    remove(p->right, key);
+    remove(p->right, key, pool);
   } 
   // Correct node has been found
   else {                  
     if (p->left == nullptr && p->right == nullptr) { // Leaf node (no children) so node can be easily removed
-        delete p;
+        free_node(p, pool);
         p = nullptr;        
     } else if (p->left == nullptr) { // Has right but no left child, so delete the node and move right child to its position
         Node<S, T> *rightChild = p->right;
         rightChild->parent = p->parent;
-        delete p;
+        free_node(p, pool);
         p = rightChild;
     } else if (p->right == nullptr) { // Has left but no right child, so delete the node and move left child to its position
         Node<S, T> *leftChild = p->left;
         leftChild->parent = p->parent;
-        delete p;
+        free_node(p, pool);
         p = leftChild;
     } else { // Node has both left and right children            
         // 1. Find the minimum node in the right subtree 
@@ -91,7 +101,7 @@ void remove(Node<S, T>* &p, const S &key) {
         p->key = minNode->key; 
         p->data = minNode->data;
         // 3. Remove the minimum node instead. It is a leaf or only has a right child
-        remove(p->right, minNode->key); 
+        remove(p->right, minNode->key, pool);
         if (p->right != nullptr) {    // If minNode had right child, it gets new parent
             p->right->parent = p;
         }
@@ -133,11 +143,11 @@ T& edit(Node<S, T>* p, const S& to_be_changed) {
 
 // Deletes the entire tree at p
 template<typename S, typename T>
-void delete_tree(Node<S, T>* &p) {
+void delete_tree(Node<S, T>* &p, NodePool<Node<S, T>>* pool) {
   if (p != nullptr) {
-    delete_tree(p->left);  // Delete all subtrees
-    delete_tree(p->right);
-    delete p;             // Delete the remaining node 
+    delete_tree(p->left, pool);  // Delete all subtrees
+    delete_tree(p->right, pool);
+    free_node(p, pool);            // Delete the remaining node 
     p = nullptr;
   } 
 }
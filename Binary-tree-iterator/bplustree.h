@@ -0,0 +1,707 @@
+/*
+* B+ tree
+*
+* Author: Farhan Syed
+* Year: 2024
+
+  B+ tree map template with implementations: the key/data operations of bintree.h and the iterators of
+  iterator.h, on nodes that hold many keys each
+*/
+
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include "../Binary-tree/nodepool.h"
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+// One key and its data, what the iterators point to, like Node for NodeIterator
+template <class S, class T>
+struct BPlusEntry {
+    S key;
+    T data;
+};
+
+template <class S, class T, size_t NodeBytes, bool IsConst> struct BPlusIterator;
+
+// Map from keys S to data T. Inner nodes hold only keys and child pointers, and route a lookup down to the
+// leaves, which hold the entries in order and are linked both ways for iteration and range scans. All
+// leaves are at the same depth and every node but the root is at least half full, so the height is about
+// log(n) / log(fanout): a lookup reads 6 nodes for 10M int keys where the binary tree reads about 28.
+// Nodes are NodeBytes long, a few cache lines, searched with a scan the compiler can vectorize, and come from
+// node pools so neighbouring leaves tend to be neighbours in memory. Keys need operator<.
+template <class S, class T, size_t NodeBytes = 256>
+class BPlusTree {
+public:
+    typedef BPlusEntry<S, T> entry;
+    typedef BPlusIterator<S, T, NodeBytes, false> iterator;
+    typedef BPlusIterator<S, T, NodeBytes, true> const_iterator;
+
+    // Keys per leaf and children per inner node that fit in NodeBytes, at least 4
+    static constexpr size_t leaf_capacity = (NodeBytes - 3 * sizeof(void*)) / sizeof(BPlusEntry<S, T>) > 4
+                                          ? (NodeBytes - 3 * sizeof(void*)) / sizeof(BPlusEntry<S, T>) : 4;
+    static constexpr size_t inner_capacity = (NodeBytes - sizeof(void*)) / (sizeof(S) + sizeof(void*)) > 4
+                                           ? (NodeBytes - sizeof(void*)) / (sizeof(S) + sizeof(void*)) : 4;
+
+    BPlusTree();
+    ~BPlusTree();
+
+    BPlusTree(const BPlusTree &) = delete;
+    BPlusTree & operator=(const BPlusTree &) = delete;
+
+    void insert(S key, T to_be_inserted);   // Updates the data if the key exists
+    void remove(const S & key);             // Throws out_of_range if the key does not exist
+    const T & find(const S & to_be_found) const;
+    T & edit(const S & to_be_changed);
+    void clear();
+
+    size_t size() const;
+    unsigned int height() const;    // Levels of nodes, 0 for an empty tree
+
+    // In-order iterators as for Node: forward, const and reverse
+    iterator begin();
+    iterator end();
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    iterator rbegin();
+    iterator rend();
+
+    // First entry with key not less than key, the start of a range scan
+    iterator lower_bound(const S & key);
+    const_iterator lower_bound(const S & key) const;
+
+private:
+    struct alignas(64) Leaf {
+        entry entries[leaf_capacity];
+        size_t count;
+        Leaf* prev;
+        Leaf* next;
+    };
+    // children[i] holds the keys k with keys[i-1] <= k < keys[i]. Both node types start on a cache line.
+    struct alignas(64) Inner {
+        size_t count;   // Children
+        S keys[inner_capacity - 1];
+        void* children[inner_capacity];
+    };
+
+    static size_t leaf_position(const Leaf* leaf, const S & key);
+    static size_t child_position(const Inner* inner, const S & key);
+
+    Leaf* find_leaf(const S & key) const;
+    bool insert_into(void* node, unsigned int level, const S & key, const T & data, S & splitKey, void* & newNode);
+    bool remove_from(void* node, unsigned int level, const S & key);
+    void fix_child(Inner* parent, size_t i, unsigned int level);
+    void free_nodes(void* node, unsigned int level);
+
+    void* m_root;
+    unsigned int m_height;
+    size_t m_size;
+    Leaf* m_first;
+    Leaf* m_last;
+    NodePool<Leaf> m_leaves;
+    NodePool<Inner> m_inners;
+
+    friend struct BPlusIterator<S, T, NodeBytes, false>;
+    friend struct BPlusIterator<S, T, NodeBytes, true>;
+};
+
+// Iterator over the entries in key order, or reverse order; const_iterator when IsConst
+template <class S, class T, size_t NodeBytes, bool IsConst>
+struct BPlusIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = BPlusEntry<S, T>;
+    using pointer = typename std::conditional<IsConst, const BPlusEntry<S, T>*, BPlusEntry<S, T>*>::type;
+    using reference = typename std::conditional<IsConst, const BPlusEntry<S, T>&, BPlusEntry<S, T>&>::type;
+    using leaf_pointer = typename std::conditional<IsConst, const typename BPlusTree<S, T, NodeBytes>::Leaf*,
+                                                            typename BPlusTree<S, T, NodeBytes>::Leaf*>::type;
+
+    leaf_pointer leaf;  // nullptr at the end
+    size_t index;
+    bool reverse;
+
+    BPlusIterator();
+    BPlusIterator(leaf_pointer l, size_t i, bool rev);
+    template <bool WasConst, class = typename std::enable_if<IsConst && !WasConst>::type>
+    BPlusIterator(const BPlusIterator<S, T, NodeBytes, WasConst>& other);  // iterator to const_iterator
+
+    reference operator*() const;
+    pointer operator->() const;
+    BPlusIterator& operator++();
+    BPlusIterator operator++(int);
+    template <bool OtherConst> bool operator==(const BPlusIterator<S, T, NodeBytes, OtherConst>& other) const;
+    template <bool OtherConst> bool operator!=(const BPlusIterator<S, T, NodeBytes, OtherConst>& other) const;
+};
+
+// Free functions with the names and arguments of the bintree.h ones, so code can switch between the trees
+template <class S, class T, size_t B> void insert(BPlusTree<S, T, B> & tree, S key, T to_be_inserted);
+template <class S, class T, size_t B> void remove(BPlusTree<S, T, B> & tree, const S & key);
+template <class S, class T, size_t B> const T & find(const BPlusTree<S, T, B> & tree, const S & to_be_found);
+template <class S, class T, size_t B> T & edit(BPlusTree<S, T, B> & tree, const S & to_be_changed);
+template <class S, class T, size_t B> void delete_tree(BPlusTree<S, T, B> & tree);
+template <class S, class T, size_t B> unsigned int size(const BPlusTree<S, T, B> & tree);
+template <class S, class T, size_t B> unsigned int max_height(const BPlusTree<S, T, B> & tree);
+
+//
+// Implementations
+//
+
+// Empty tree; the pools allocate 64 nodes at a time, so small trees stay small
+template <class S, class T, size_t B>
+BPlusTree<S, T, B>::BPlusTree()
+    : m_root(nullptr), m_height(0), m_size(0), m_first(nullptr), m_last(nullptr), m_leaves(64), m_inners(64) {}
+
+// Destructor
+template <class S, class T, size_t B>
+BPlusTree<S, T, B>::~BPlusTree() {
+    clear();
+}
+
+// SEARCH
+
+// Entries of the leaf with keys less than key: the position of key, or where it would go
+template <class S, class T, size_t B>
+size_t BPlusTree<S, T, B>::leaf_position(const Leaf* leaf, const S & key) {
+    size_t position = 0;
+    for (size_t j = 0; j < leaf->count; j++) {  // Counts without branching, so small nodes need no binary search
+        position += leaf->entries[j].key < key;
+    }
+    return position;
+}
+
+// Child whose range holds key: the number of separator keys not greater than key
+template <class S, class T, size_t B>
+size_t BPlusTree<S, T, B>::child_position(const Inner* inner, const S & key) {
+    size_t position = 0;
+    for (size_t j = 0; j + 1 < inner->count; j++) {
+        position += !(key < inner->keys[j]);
+    }
+    return position;
+}
+
+// Leaf whose range holds key, nullptr for an empty tree
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::Leaf* BPlusTree<S, T, B>::find_leaf(const S & key) const {
+    void* node = m_root;
+    for (unsigned int level = m_height; level > 1; level--) {
+        const Inner* inner = static_cast<const Inner*>(node);
+        node = inner->children[child_position(inner, key)];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+// Find the entry with key and return its data
+template <class S, class T, size_t B>
+const T & BPlusTree<S, T, B>::find(const S & to_be_found) const {
+    const Leaf* leaf = find_leaf(to_be_found);
+    if (leaf != nullptr) {
+        size_t i = leaf_position(leaf, to_be_found);
+        if (i < leaf->count && !(to_be_found < leaf->entries[i].key)) {
+            return leaf->entries[i].data;
+        }
+    }
+    throw std::out_of_range("Key not found!");
+}
+
+// Find and return a reference to editable data associated with the key
+template <class S, class T, size_t B>
+T & BPlusTree<S, T, B>::edit(const S & to_be_changed) {
+    return const_cast<T &>(static_cast<const BPlusTree &>(*this).find(to_be_changed));
+}
+
+// INSERT
+
+// Insert a new entry, or update the data of an existing key. A root that splits gets a new root above it.
+template <class S, class T, size_t B>
+void BPlusTree<S, T, B>::insert(S key, T to_be_inserted) {
+    if (m_root == nullptr) {
+        Leaf* leaf = m_leaves.allocate();
+        leaf->count = 0;
+        leaf->prev = nullptr;
+        leaf->next = nullptr;
+        m_root = m_first = m_last = leaf;
+        m_height = 1;
+    }
+    S splitKey;
+    void* newNode = nullptr;
+    if (insert_into(m_root, m_height, key, to_be_inserted, splitKey, newNode)) {
+        Inner* root = m_inners.allocate();
+        root->count = 2;
+        root->keys[0] = splitKey;
+        root->children[0] = m_root;
+        root->children[1] = newNode;
+        m_root = root;
+        m_height++;
+    }
+}
+
+// Insert into the subtree at node, level levels above the leaves included. Returns true if node split, with
+// newNode the new right half and splitKey the smallest key under it.
+template <class S, class T, size_t B>
+bool BPlusTree<S, T, B>::insert_into(void* node, unsigned int level, const S & key, const T & data, S & splitKey, void* & newNode) {
+    if (level == 1) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        size_t i = leaf_position(leaf, key);
+        if (i < leaf->count && !(key < leaf->entries[i].key)) { // Duplicate key, so only update data
+            leaf->entries[i].data = data;
+            return false;
+        }
+        m_size++;
+        if (leaf->count < leaf_capacity) {
+            for (size_t j = leaf->count; j > i; j--) {
+                leaf->entries[j] = leaf->entries[j - 1];
+            }
+            leaf->entries[i] = entry{key, data};
+            leaf->count++;
+            return false;
+        }
+        // Full: the upper half moves to a new leaf linked in after this one, then the entry goes into its half
+        Leaf* right = m_leaves.allocate();
+        size_t half = (leaf_capacity + 1) / 2;
+        size_t moved = leaf_capacity - half;
+        for (size_t j = 0; j < moved; j++) {
+            right->entries[j] = leaf->entries[half + j];
+        }
+        leaf->count = half;
+        right->count = moved;
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next != nullptr) {
+            leaf->next->prev = right;
+        } else {
+            m_last = right;
+        }
+        leaf->next = right;
+        Leaf* target = (i <= half) ? leaf : right;
+        size_t position = (i <= half) ? i : i - half;
+        for (size_t j = target->count; j > position; j--) {
+            target->entries[j] = target->entries[j - 1];
+        }
+        target->entries[position] = entry{key, data};
+        target->count++;
+        splitKey = right->entries[0].key;
+        newNode = right;
+        return true;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    size_t i = child_position(inner, key);
+    S childKey;
+    void* childNode = nullptr;
+    if (!insert_into(inner->children[i], level - 1, key, data, childKey, childNode)) {
+        return false;
+    }
+    // The child split: its new right half goes in after it, with childKey as separator
+    if (inner->count < inner_capacity) {
+        for (size_t j = inner->count; j > i + 1; j--) {
+            inner->children[j] = inner->children[j - 1];
+            inner->keys[j - 1] = inner->keys[j - 2];
+        }
+        inner->children[i + 1] = childNode;
+        inner->keys[i] = childKey;
+        inner->count++;
+        return false;
+    }
+    // Full: lay out all keys and children with the new ones, then split around the middle key, which moves up
+    S keys[inner_capacity];
+    void* children[inner_capacity + 1];
+    for (size_t j = 0, k = 0; j <= inner_capacity; j++) {
+        children[j] = (j == i + 1) ? childNode : inner->children[k++];
+    }
+    for (size_t j = 0, k = 0; j < inner_capacity; j++) {
+        keys[j] = (j == i) ? childKey : inner->keys[k++];
+    }
+    Inner* right = m_inners.allocate();
+    size_t leftCount = (inner_capacity + 1) / 2;
+    size_t rightCount = inner_capacity + 1 - leftCount;
+    inner->count = leftCount;
+    for (size_t j = 0; j < leftCount; j++) {
+        inner->children[j] = children[j];
+    }
+    for (size_t j = 0; j + 1 < leftCount; j++) {
+        inner->keys[j] = keys[j];
+    }
+    right->count = rightCount;
+    for (size_t j = 0; j < rightCount; j++) {
+        right->children[j] = children[leftCount + j];
+    }
+    for (size_t j = 0; j + 1 < rightCount; j++) {
+        right->keys[j] = keys[leftCount + j];
+    }
+    splitKey = keys[leftCount - 1];
+    newNode = right;
+    return true;
+}
+
+// REMOVE
+
+// Remove the entry with key. A root inner node left with one child is replaced by the child.
+template <class S, class T, size_t B>
+void BPlusTree<S, T, B>::remove(const S & key) {
+    if (m_root == nullptr) {
+        throw std::out_of_range("Key not found!");
+    }
+    remove_from(m_root, m_height, key);
+    if (m_height > 1 && static_cast<Inner*>(m_root)->count == 1) {
+        Inner* root = static_cast<Inner*>(m_root);
+        m_root = root->children[0];
+        m_inners.release(root);
+        m_height--;
+    } else if (m_height == 1 && static_cast<Leaf*>(m_root)->count == 0) {
+        m_leaves.release(static_cast<Leaf*>(m_root));
+        m_root = m_first = m_last = nullptr;
+        m_height = 0;
+    }
+}
+
+// Remove key from the subtree at node. Returns true if node is now less than half full.
+template <class S, class T, size_t B>
+bool BPlusTree<S, T, B>::remove_from(void* node, unsigned int level, const S & key) {
+    if (level == 1) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        size_t i = leaf_position(leaf, key);
+        if (i == leaf->count || key < leaf->entries[i].key) { // Key not found
+            throw std::out_of_range("Key not found!");
+        }
+        for (size_t j = i + 1; j < leaf->count; j++) {
+            leaf->entries[j - 1] = leaf->entries[j];
+        }
+        leaf->count--;
+        m_size--;
+        return leaf->count < leaf_capacity / 2;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    size_t i = child_position(inner, key);
+    if (remove_from(inner->children[i], level - 1, key)) {
+        fix_child(inner, i, level - 1);
+    }
+    return inner->count < (inner_capacity + 1) / 2;
+}
+
+// Child i of parent, at the given level, is less than half full: borrow from a sibling that has entries to
+// spare, else merge it with a sibling, which removes one child from parent
+template <class S, class T, size_t B>
+void BPlusTree<S, T, B>::fix_child(Inner* parent, size_t i, unsigned int level) {
+    if (level == 1) {
+        Leaf* leaf = static_cast<Leaf*>(parent->children[i]);
+        Leaf* left = (i > 0) ? static_cast<Leaf*>(parent->children[i - 1]) : nullptr;
+        Leaf* right = (i + 1 < parent->count) ? static_cast<Leaf*>(parent->children[i + 1]) : nullptr;
+        if (left != nullptr && left->count > leaf_capacity / 2) {  // Last entry of the left sibling moves over
+            for (size_t j = leaf->count; j > 0; j--) {
+                leaf->entries[j] = leaf->entries[j - 1];
+            }
+            leaf->entries[0] = left->entries[--left->count];
+            leaf->count++;
+            parent->keys[i - 1] = leaf->entries[0].key;
+            return;
+        }
+        if (right != nullptr && right->count > leaf_capacity / 2) {  // First entry of the right sibling moves over
+            leaf->entries[leaf->count++] = right->entries[0];
+            for (size_t j = 1; j < right->count; j++) {
+                right->entries[j - 1] = right->entries[j];
+            }
+            right->count--;
+            parent->keys[i] = right->entries[0].key;
+            return;
+        }
+        // Merge: the right one of the pair moves into the left one and leaves the leaf list
+        size_t k = (left != nullptr) ? i - 1 : i;
+        Leaf* into = static_cast<Leaf*>(parent->children[k]);
+        Leaf* from = static_cast<Leaf*>(parent->children[k + 1]);
+        for (size_t j = 0; j < from->count; j++) {
+            into->entries[into->count++] = from->entries[j];
+        }
+        into->next = from->next;
+        if (from->next != nullptr) {
+            from->next->prev = into;
+        } else {
+            m_last = into;
+        }
+        m_leaves.release(from);
+        for (size_t j = k + 1; j + 1 < parent->count; j++) {
+            parent->children[j] = parent->children[j + 1];
+            parent->keys[j - 1] = parent->keys[j];
+        }
+        parent->count--;
+        return;
+    }
+
+    Inner* child = static_cast<Inner*>(parent->children[i]);
+    Inner* left = (i > 0) ? static_cast<Inner*>(parent->children[i - 1]) : nullptr;
+    Inner* right = (i + 1 < parent->count) ? static_cast<Inner*>(parent->children[i + 1]) : nullptr;
+    const size_t minimum = (inner_capacity + 1) / 2;
+    if (left != nullptr && left->count > minimum) {  // Rotate through the parent: separator down, left's last key up
+        for (size_t j = child->count; j > 0; j--) {
+            child->children[j] = child->children[j - 1];
+        }
+        for (size_t j = child->count - 1; j > 0; j--) {
+            child->keys[j] = child->keys[j - 1];
+        }
+        child->children[0] = left->children[left->count - 1];
+        child->keys[0] = parent->keys[i - 1];
+        child->count++;
+        parent->keys[i - 1] = left->keys[left->count - 2];
+        left->count--;
+        return;
+    }
+    if (right != nullptr && right->count > minimum) {  // Separator down, right's first key up
+        child->keys[child->count - 1] = parent->keys[i];
+        child->children[child->count] = right->children[0];
+        child->count++;
+        parent->keys[i] = right->keys[0];
+        for (size_t j = 1; j < right->count; j++) {
+            right->children[j - 1] = right->children[j];
+        }
+        for (size_t j = 1; j + 1 < right->count; j++) {
+            right->keys[j - 1] = right->keys[j];
+        }
+        right->count--;
+        return;
+    }
+    // Merge: the separator and the right one of the pair move into the left one
+    size_t k = (left != nullptr) ? i - 1 : i;
+    Inner* into = static_cast<Inner*>(parent->children[k]);
+    Inner* from = static_cast<Inner*>(parent->children[k + 1]);
+    into->keys[into->count - 1] = parent->keys[k];
+    for (size_t j = 0; j < from->count; j++) {
+        into->children[into->count + j] = from->children[j];
+    }
+    for (size_t j = 0; j + 1 < from->count; j++) {
+        into->keys[into->count + j] = from->keys[j];
+    }
+    into->count += from->count;
+    m_inners.release(from);
+    for (size_t j = k + 1; j + 1 < parent->count; j++) {
+        parent->children[j] = parent->children[j + 1];
+        parent->keys[j - 1] = parent->keys[j];
+    }
+    parent->count--;
+}
+
+// CLEAR
+
+// Release the nodes of the subtree at node one by one, running the destructors of keys and data
+template <class S, class T, size_t B>
+void BPlusTree<S, T, B>::free_nodes(void* node, unsigned int level) {
+    if (level == 1) {
+        m_leaves.release(static_cast<Leaf*>(node));
+        return;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    for (size_t j = 0; j < inner->count; j++) {
+        free_nodes(inner->children[j], level - 1);
+    }
+    m_inners.release(inner);
+}
+
+// Remove every entry. Trivially destructible keys and data need no walk: the pools drop all nodes at once
+template <class S, class T, size_t B>
+void BPlusTree<S, T, B>::clear() {
+    if constexpr (std::is_trivially_destructible<Leaf>::value && std::is_trivially_destructible<Inner>::value) {
+        m_leaves.clear();
+        m_inners.clear();
+    } else if (m_root != nullptr) {
+        free_nodes(m_root, m_height);
+    }
+    m_root = m_first = m_last = nullptr;
+    m_height = 0;
+    m_size = 0;
+}
+
+// ACCESSORS
+
+// Number of entries
+template <class S, class T, size_t B>
+size_t BPlusTree<S, T, B>::size() const {
+    return m_size;
+}
+
+// Levels of nodes, the same on every path
+template <class S, class T, size_t B>
+unsigned int BPlusTree<S, T, B>::height() const {
+    return m_height;
+}
+
+// ITERATORS
+
+// begin() - first entry of the first leaf
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::iterator BPlusTree<S, T, B>::begin() {
+    return iterator(m_first, 0, false);
+}
+
+// end() - past the last entry
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::iterator BPlusTree<S, T, B>::end() {
+    return iterator(nullptr, 0, false);
+}
+
+// cbegin() - first entry, read only
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::const_iterator BPlusTree<S, T, B>::cbegin() const {
+    return const_iterator(m_first, 0, false);
+}
+
+// cend() - past the last entry, read only
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::const_iterator BPlusTree<S, T, B>::cend() const {
+    return const_iterator(nullptr, 0, false);
+}
+
+// rbegin() - last entry of the last leaf, moving backwards
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::iterator BPlusTree<S, T, B>::rbegin() {
+    return iterator(m_last, (m_last != nullptr) ? m_last->count - 1 : 0, true);
+}
+
+// rend() - before the first entry
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::iterator BPlusTree<S, T, B>::rend() {
+    return iterator(nullptr, 0, true);
+}
+
+// First entry with key not less than key; the next leaf's first entry if key is past the end of its leaf
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::iterator BPlusTree<S, T, B>::lower_bound(const S & key) {
+    Leaf* leaf = find_leaf(key);
+    if (leaf == nullptr) {
+        return end();
+    }
+    size_t i = leaf_position(leaf, key);
+    if (i == leaf->count) {
+        return iterator(leaf->next, 0, false);
+    }
+    return iterator(leaf, i, false);
+}
+
+// First entry with key not less than key, read only
+template <class S, class T, size_t B>
+typename BPlusTree<S, T, B>::const_iterator BPlusTree<S, T, B>::lower_bound(const S & key) const {
+    const Leaf* leaf = find_leaf(key);
+    if (leaf == nullptr) {
+        return cend();
+    }
+    size_t i = leaf_position(leaf, key);
+    if (i == leaf->count) {
+        return const_iterator(leaf->next, 0, false);
+    }
+    return const_iterator(leaf, i, false);
+}
+
+// Default constructor - iterator that points nowhere, equal to end()
+template <class S, class T, size_t B, bool C>
+BPlusIterator<S, T, B, C>::BPlusIterator() : leaf(nullptr), index(0), reverse(false) {}
+
+// Constructor. Parameters: leaf and entry index the iterator starts at, type of iterator (true = reverse)
+template <class S, class T, size_t B, bool C>
+BPlusIterator<S, T, B, C>::BPlusIterator(leaf_pointer l, size_t i, bool rev) : leaf(l), index(i), reverse(rev) {}
+
+// Conversion from iterator to const_iterator, at the same position
+template <class S, class T, size_t B, bool C>
+template <bool WasConst, class>
+BPlusIterator<S, T, B, C>::BPlusIterator(const BPlusIterator<S, T, B, WasConst>& other)
+    : leaf(other.leaf), index(other.index), reverse(other.reverse) {}
+
+// Dereference (*) operator
+template <class S, class T, size_t B, bool C>
+typename BPlusIterator<S, T, B, C>::reference BPlusIterator<S, T, B, C>::operator*() const {
+    if (!leaf) throw std::out_of_range("Entry out of range!");
+    return leaf->entries[index];
+}
+
+// Arrow (->) operator
+template <class S, class T, size_t B, bool C>
+typename BPlusIterator<S, T, B, C>::pointer BPlusIterator<S, T, B, C>::operator->() const {
+    if (!leaf) throw std::out_of_range("Entry out of range!");
+    return &leaf->entries[index];
+}
+
+// Prefix increment - next entry in the leaf, else the first (last for reverse) entry of the next leaf
+template <class S, class T, size_t B, bool C>
+BPlusIterator<S, T, B, C>& BPlusIterator<S, T, B, C>::operator++() {
+    if (leaf == nullptr) {
+        return *this;
+    }
+    if (reverse) {
+        if (index > 0) {
+            index--;
+        } else {
+            leaf = leaf->prev;
+            index = (leaf != nullptr) ? leaf->count - 1 : 0;
+        }
+    } else if (++index == leaf->count) {
+        leaf = leaf->next;
+        index = 0;
+    }
+    return *this;
+}
+
+// Postfix increment - Iterator moves to the next entry but the old position is returned
+template <class S, class T, size_t B, bool C>
+BPlusIterator<S, T, B, C> BPlusIterator<S, T, B, C>::operator++(int) {
+    BPlusIterator tmp(*this);
+    ++(*this);
+    return tmp;
+}
+
+// Equality comparison, also between an iterator and a const_iterator
+template <class S, class T, size_t B, bool C>
+template <bool OtherConst>
+bool BPlusIterator<S, T, B, C>::operator==(const BPlusIterator<S, T, B, OtherConst>& other) const {
+    return leaf == other.leaf && index == other.index;
+}
+
+// Inequality comparison
+template <class S, class T, size_t B, bool C>
+template <bool OtherConst>
+bool BPlusIterator<S, T, B, C>::operator!=(const BPlusIterator<S, T, B, OtherConst>& other) const {
+    return !(*this == other);
+}
+
+// FREE FUNCTIONS
+
+// Insert a new entry in the tree, or update the data of an existing key
+template <class S, class T, size_t B>
+void insert(BPlusTree<S, T, B> & tree, S key, T to_be_inserted) {
+    tree.insert(key, to_be_inserted);
+}
+
+// Remove the entry with key
+template <class S, class T, size_t B>
+void remove(BPlusTree<S, T, B> & tree, const S & key) {
+    tree.remove(key);
+}
+
+// Find the entry with key and return its data
+template <class S, class T, size_t B>
+const T & find(const BPlusTree<S, T, B> & tree, const S & to_be_found) {
+    return tree.find(to_be_found);
+}
+
+// Find and return a reference to editable data associated with the key
+template <class S, class T, size_t B>
+T & edit(BPlusTree<S, T, B> & tree, const S & to_be_changed) {
+    return tree.edit(to_be_changed);
+}
+
+// Remove every entry
+template <class S, class T, size_t B>
+void delete_tree(BPlusTree<S, T, B> & tree) {
+    tree.clear();
+}
+
+// Number of entries
+template <class S, class T, size_t B>
+unsigned int size(const BPlusTree<S, T, B> & tree) {
+    return static_cast<unsigned int>(tree.size());
+}
+
+// Levels of nodes from the root to the leaves
+template <class S, class T, size_t B>
+unsigned int max_height(const BPlusTree<S, T, B> & tree) {
+    return tree.height();
+}
+
+#endif //BPLUSTREE_H
@@ -10,24 +10,25 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include "../Binary-tree/nodepool.h"
 
 // Forward declaration of the iterators
 template <class S, class T> struct Node;
 template <class S, class T> struct NodeIterator;
 template <class S, class T> struct ConstNodeIterator;
 
-// Forward declarations of the bintree functions
+// Forward declarations of the bintree functions. Nodes come from new and delete, or from pool when one is given
 template<typename S, typename T>
-Node<S, T>* createNode(S key, T data);
+Node<S, T>* createNode(S key, T data, NodePool<Node<S, T>>* pool = nullptr);
 
 template<typename S, typename T>
-void insert(Node<S, T>* &p, S key, T to_be_inserted);
+void insert(Node<S, T>* &p, S key, T to_be_inserted, NodePool<Node<S, T>>* pool = nullptr);
 
 template<typename S, typename T>
-void remove(Node<S, T>* &p, const S &key);
+void remove(Node<S, T>* &p, const S &key, NodePool<Node<S, T>>* pool = nullptr);
 
 template<typename S, typename T>
-void delete_tree(Node<S, T>* &p);
+void delete_tree(Node<S, T>* &p, NodePool<Node<S, T>>* pool = nullptr);
 
 template<typename S, typename T>
 const T& find(Node<S, T>* p, const S& to_be_found);
@@ -68,10 +69,10 @@ struct Node {
     friend struct NodeIterator<S, T>;
     friend struct ConstNodeIterator<S, T>;
 
-    friend Node<S, T>* createNode<S, T>(S, T);
-    friend void insert<S, T>(Node<S, T>*&, S, T);
-    friend void remove<S, T>(Node<S, T>*&, const S&);
-    friend void delete_tree<S, T>(Node<S, T>*&);
+    friend Node<S, T>* createNode<S, T>(S, T, NodePool<Node<S, T>>*);
+    friend void insert<S, T>(Node<S, T>*&, S, T, NodePool<Node<S, T>>*);
+    friend void remove<S, T>(Node<S, T>*&, const S&, NodePool<Node<S, T>>*);
+    friend void delete_tree<S, T>(Node<S, T>*&, NodePool<Node<S, T>>*);
     friend const T& find<S, T>(Node<S, T>*, const S&);
     friend T& edit<S, T>(Node<S, T>*, const S&);
     friend unsigned int max_height<S, T>(Node<S, T>*);
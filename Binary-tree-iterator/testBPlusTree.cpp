@@ -0,0 +1,191 @@
+#include "bplustree.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// To compile: g++ -o testBPlusTree.exe testBPlusTree.cpp -lgtest -lgtest_main -pthread
+// Running valgrind: valgrind --leak-check=full --show-leak-kinds=all ./testBPlusTree.exe
+
+using namespace std;
+
+// 64-byte nodes: 5 entries per leaf and 4 children per inner node, so a few keys already need several levels
+typedef BPlusTree<int, int, 64> SmallTree;
+
+// Forward and reverse iteration give the entries of m in order
+template <class Tree>
+void expectSameEntries(Tree & tree, const map<int, int> & m) {
+    EXPECT_EQ(tree.size(), m.size());
+    auto expected = m.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++expected) {
+        ASSERT_NE(expected, m.end());
+        EXPECT_EQ(it->key, expected->first);
+        EXPECT_EQ(it->data, expected->second);
+    }
+    EXPECT_EQ(expected, m.end());
+    auto reverseExpected = m.rbegin();
+    for (auto it = tree.rbegin(); it != tree.rend(); it++, ++reverseExpected) {
+        ASSERT_NE(reverseExpected, m.rend());
+        EXPECT_EQ((*it).key, reverseExpected->first);
+    }
+    EXPECT_EQ(reverseExpected, m.rend());
+}
+
+// EMPTY TREE
+
+TEST(BPlusEmptyTreeTest, outOfRangeError) {
+    BPlusTree<int, double> t;
+    EXPECT_THROW(remove(t, 1), out_of_range);
+    EXPECT_THROW(find(t, 1), out_of_range);
+    EXPECT_THROW(edit(t, 1), out_of_range);
+    EXPECT_THROW(*t.begin(), out_of_range);
+    EXPECT_EQ(t.begin(), t.end());
+    EXPECT_EQ(t.rbegin(), t.rend());
+    EXPECT_EQ(t.lower_bound(1), t.end());
+    EXPECT_EQ(size(t), 0);
+    EXPECT_EQ(max_height(t), 0);
+}
+
+// CORRECTNESS
+
+TEST(BPlusCorrectness, insertFindEditRemove) {
+    BPlusTree<int, double> t;
+    insert(t,10,2.0);
+    insert(t,20,3.0);
+    insert(t,9,1.0);
+    insert(t,9,1.5); // duplicate key
+    EXPECT_EQ(size(t), 3);
+    EXPECT_EQ(max_height(t), 1);
+    EXPECT_EQ(find(t,9), 1.5);
+
+    edit(t,20) = 4.0;
+    EXPECT_EQ(find(t,20), 4.0);
+
+    remove(t,10);
+    EXPECT_THROW(find(t, 10), out_of_range);
+    EXPECT_THROW(remove(t, 10), out_of_range);
+    EXPECT_EQ(size(t), 2);
+
+    remove(t,9);
+    remove(t,20);
+    EXPECT_EQ(size(t), 0);
+    EXPECT_EQ(max_height(t), 0);
+    insert(t,5,5.0);
+    EXPECT_EQ(find(t,5), 5.0);
+}
+
+TEST(BPlusCorrectness, sortedInsertGrowsLevels) {
+    SmallTree t;
+    map<int, int> m;
+    for (int key = 1; key <= 1000; key++) {
+        insert(t,key,key * 2);
+        m[key] = key * 2;
+    }
+    EXPECT_GE(max_height(t), 4);
+    EXPECT_LE(max_height(t), 8);
+    expectSameEntries(t, m);
+
+    for (int key = 1000; key >= 1; key -= 3) { // Merges and borrows back down
+        remove(t,key);
+        m.erase(key);
+    }
+    expectSameEntries(t, m);
+    for (const auto & entry : m) {
+        EXPECT_EQ(find(t,entry.first), entry.second);
+    }
+
+    delete_tree(t);
+    EXPECT_EQ(size(t), 0);
+    EXPECT_EQ(t.begin(), t.end());
+}
+
+TEST(BPlusCorrectness, randomOperationsMatchMap) {
+    SmallTree t;
+    map<int, int> m;
+    default_random_engine rng(020416);
+    uniform_int_distribution<int> keys(0, 2000);
+    for (int step = 0; step < 50000; step++) {
+        int key = keys(rng);
+        if (rng() % 3 == 0) {
+            if (m.erase(key)) {
+                remove(t,key);
+            } else {
+                EXPECT_THROW(remove(t, key), out_of_range);
+            }
+        } else {
+            insert(t,key,step);
+            m[key] = step;
+        }
+    }
+    expectSameEntries(t, m);
+    for (int key = 0; key <= 2000; key++) {
+        if (m.count(key)) {
+            EXPECT_EQ(find(t,key), m[key]);
+        } else {
+            EXPECT_THROW(find(t, key), out_of_range);
+        }
+    }
+    while (!m.empty()) { // Remove everything, down to an empty root
+        remove(t,m.begin()->first);
+        m.erase(m.begin());
+    }
+    EXPECT_EQ(size(t), 0);
+    EXPECT_EQ(max_height(t), 0);
+}
+
+// ITERATION
+
+TEST(BPlusIterator, constIterationAndRangeScan) {
+    BPlusTree<int, int> t;
+    for (int key = 0; key < 1000; key += 2) {
+        insert(t,key,key / 2);
+    }
+    const BPlusTree<int, int> & constTree = t;
+    int count = 0;
+    for (BPlusTree<int, int>::const_iterator p = constTree.cbegin(); p != constTree.cend(); ++p) {
+        EXPECT_EQ(p->data, count);
+        count++;
+    }
+    EXPECT_EQ(count, 500);
+
+    // Keys in [101, 121): 102, 104, ..., 120
+    vector<int> scanned;
+    for (auto p = t.lower_bound(101); p != t.end() && p->key < 121; ++p) {
+        scanned.push_back(p->key);
+    }
+    EXPECT_EQ(scanned, vector<int>({102, 104, 106, 108, 110, 112, 114, 116, 118, 120}));
+    EXPECT_EQ(constTree.lower_bound(998)->key, 998);
+    EXPECT_EQ(t.lower_bound(999), t.end());
+
+    for (auto p = t.begin(); p != t.end(); p++) { // Data is editable through the iterator
+        p->data = -p->data;
+    }
+    EXPECT_EQ(find(t,10), -5);
+
+    // Default-constructed iterators equal end(), iterators convert to const_iterators
+    BPlusTree<int, int>::iterator none;
+    EXPECT_TRUE(none == t.end());
+    BPlusTree<int, int>::const_iterator first = t.begin();
+    EXPECT_TRUE(first == t.begin());
+    EXPECT_TRUE(t.begin() == first);
+    EXPECT_EQ(first->key, 0);
+    BPlusTree<int, int>::const_iterator last = t.lower_bound(998);
+    EXPECT_TRUE(++last == constTree.cend());
+    EXPECT_FALSE((std::is_convertible<BPlusTree<int, int>::const_iterator, BPlusTree<int, int>::iterator>::value));
+}
+
+TEST(BPlusIterator, nonTrivialData) {
+    BPlusTree<string, string, 128> t;
+    for (int i = 0; i < 200; i++) {
+        insert(t, "key" + to_string(1000 + i), string(40, 'a' + i % 26));
+    }
+    EXPECT_EQ(find(t, string("key1025")), string(40, 'z'));
+    for (int i = 0; i < 200; i += 2) {
+        remove(t, "key" + to_string(1000 + i));
+    }
+    EXPECT_EQ(t.begin()->key, "key1001");
+    EXPECT_EQ(t.rbegin()->key, "key1199");
+    EXPECT_EQ(size(t), 100);
+    // Remaining strings are destroyed with the tree
+}
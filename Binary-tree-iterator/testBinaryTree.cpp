@@ -206,3 +206,34 @@ TEST(ThrowErrorSizeGreaterThanOne, remove) {
 
     delete_tree(t);
 }
+
+// NODE POOL
+
+TEST(NodePoolTest, insertRemoveAndIterate) {
+    NodePool<Node<int, string>> pool(2);
+    Node<int, string> *t = nullptr;
+    insert(t, 20, string("twenty"), &pool);
+    insert(t, 10, string("ten"), &pool);
+    insert(t, 30, string("thirty"), &pool);
+    insert(t, 25, string("twenty-five"), &pool);
+    EXPECT_EQ(pool.size(), 4);
+    EXPECT_EQ(pool.capacity(), 4);
+
+    remove(t, 20, &pool);
+    EXPECT_EQ(pool.size(), 3);
+    EXPECT_EQ(t->key, 25);
+    EXPECT_EQ(find(t, 30), "thirty");
+    EXPECT_EQ(t->getRight()->key, 30);
+
+    insert(t, 5, string("five"), &pool); // Reuses the released node
+    EXPECT_EQ(pool.capacity(), 4);
+    string joined;
+    for (auto it = t->begin(); it != t->end(); it++) {
+        joined += (*it).data + " ";
+    }
+    EXPECT_EQ(joined, "five ten twenty-five thirty ");
+
+    delete_tree(t, &pool); // Runs the string destructors, unlike pool.clear()
+    EXPECT_EQ(t, nullptr);
+    EXPECT_EQ(pool.size(), 0);
+}
@@ -0,0 +1,223 @@
+/*
+* AVL tree
+* 
+* Author: Farhan Syed
+* Year: 2024
+
+  AVL tree implementation
+
+  Every node stores its height, and the heights of the two subtrees of any node differ by at most 1.
+  Insert and remove work like in bintree.cpp and then rebalance each node on the way back up to the root,
+  so the height stays below 1.44 log2(n + 2) and sorted input no longer turns the tree into a list.
+*/
+
+#include "avltree.h"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+
+AVLNode* createAVLNode(int key, double data) {
+  AVLNode* newNode = new AVLNode;
+  newNode->key = key;
+  newNode->data = data;
+  newNode->left = nullptr;
+  newNode->right = nullptr;
+  newNode->height = 1;
+  return newNode;
+}
+
+// Stored height, 0 for an empty subtree
+static int height(AVLNode * p){
+  return (p == nullptr) ? 0 : p->height;
+}
+
+// Recompute the height of p from its children
+static void update_height(AVLNode * p){
+  int LHeight = height(p->left);
+  int RHeight = height(p->right);
+  p->height = (LHeight > RHeight) ? LHeight+1 : RHeight+1;
+}
+
+// Left subtree height minus right subtree height
+static int balance_factor(AVLNode * p){
+  return height(p->left) - height(p->right);
+}
+
+// The left child of p takes its place and p becomes its right child
+static void rotate_right(AVLNode * & p){
+  AVLNode *leftChild = p->left;
+  p->left = leftChild->right;
+  leftChild->right = p;
+  update_height(p);
+  update_height(leftChild);
+  p = leftChild;
+}
+
+// The right child of p takes its place and p becomes its left child
+static void rotate_left(AVLNode * & p){
+  AVLNode *rightChild = p->right;
+  p->right = rightChild->left;
+  rightChild->left = p;
+  update_height(p);
+  update_height(rightChild);
+  p = rightChild;
+}
+
+// Restore the AVL property at p, whose subtrees are AVL trees with heights differing by at most 2
+static void rebalance(AVLNode * & p){
+  update_height(p);
+  int balance = balance_factor(p);
+  if (balance > 1) {          // Left side too high
+    if (balance_factor(p->left) < 0) { // Left-right case: first turn it into the left-left case
+      rotate_left(p->left);
+    }
+    rotate_right(p);
+  } else if (balance < -1) {  // Right side too high
+    if (balance_factor(p->right) > 0) { // Right-left case: first turn it into the right-right case
+      rotate_right(p->right);
+    }
+    rotate_left(p);
+  }
+}
+
+// Insert a new node in the tree, or update the data if the key exists
+void insert(AVLNode * & p, int key, double to_be_inserted){
+  if (p == nullptr) {  // Correct position has been found, so the new node is inserted as a leaf
+      p = createAVLNode(key, to_be_inserted);
+      return;
+  }
+  if(p->key == key){ // Duplicate key, so only update data; no height changes
+      p->data = to_be_inserted;
+      return;
+  }
+  if (key < p->key) {
+      insert(p->left, key, to_be_inserted);
+  } else {
+      insert(p->right, key, to_be_inserted);
+  }
+  rebalance(p);
+}
+
+// Detach the minimum node of the subtree at p and return it, rebalancing on the way back up
+static AVLNode* remove_min(AVLNode * & p){
+  if (p->left == nullptr) {
+    AVLNode *minNode = p;
+    p = p->right;
+    return minNode;
+  }
+  AVLNode *minNode = remove_min(p->left);
+  rebalance(p);
+  return minNode;
+}
+
+void remove(AVLNode * & p, const int & key){
+  if (p == nullptr) { // Key not found
+    throw out_of_range("Key not found!");
+  }
+  if (key < p->key) {
+    remove(p->left, key);
+  } else if (key > p->key) {
+    remove(p->right, key);
+  } 
+  // Correct node has been found
+  else {
+    AVLNode *removed = p;
+    if (p->left == nullptr) {         // At most a right child, which takes the node's position
+      p = p->right;
+    } else if (p->right == nullptr) { // Only a left child, which takes the node's position
+      p = p->left;
+    } else { // Both children: the minimum node of the right subtree takes the node's position
+      AVLNode *minNode = remove_min(p->right);
+      minNode->left = p->left;
+      minNode->right = p->right;
+      p = minNode;
+    }
+    delete removed;
+    if (p == nullptr) {
+      return;
+    }
+  }
+  rebalance(p);
+}
+
+// Find the node with key and returns it associated data.
+const double & find(AVLNode * p, const int & to_be_found){
+  while (p != nullptr) { // Height is O(log n), so a loop down the tree
+    if (p->key == to_be_found) {
+      return p->data;
+    }
+    p = (p->key > to_be_found) ? p->left : p->right;
+  }
+  throw out_of_range("Key not found!");
+}
+
+// Find and return a reference to editable data associated with the key
+double & edit(AVLNode * p, const int & to_be_changed){
+  while (p != nullptr) {
+    if (p->key == to_be_changed) {
+      return p->data;
+    }
+    p = (p->key > to_be_changed) ? p->left : p->right;
+  }
+  throw out_of_range("Key not found!");
+}
+
+// Deletes the entire tree at p
+void delete_tree(AVLNode * & p){
+  if (p != nullptr) {
+    delete_tree(p->left);
+    delete_tree(p->right);
+    delete p;
+    p = nullptr;
+  } 
+}
+
+// Returns the height (longest chain) of the tree, which every node stores
+unsigned int max_height(AVLNode * p){
+  return height(p);
+}
+
+// Returns the shortest chain of the tree
+unsigned int min_height(AVLNode * p){
+  if (p == nullptr){
+    return 0;
+  }
+  int LHeight = min_height(p->left);
+  int RHeight = min_height(p->right);
+
+  return (LHeight < RHeight) ? LHeight+1 : RHeight+1;
+}
+
+// Returns the number of nodes (p included) in the tree
+unsigned int size(AVLNode * p){
+  if (p == nullptr) { 
+    return 0; 
+  }
+  return size(p->left) + size(p->right) + 1;
+}
+
+// Height of the tree computed from the leaves up, or -1 if some node is out of balance or stores a wrong height
+static int checked_height(AVLNode * p){
+  if (p == nullptr) {
+    return 0;
+  }
+  int LHeight = checked_height(p->left);
+  int RHeight = checked_height(p->right);
+  if (LHeight < 0 || RHeight < 0 || abs(LHeight - RHeight) > 1) {
+    return -1;
+  }
+  int h = (LHeight > RHeight) ? LHeight+1 : RHeight+1;
+  return (h == p->height) ? h : -1;
+}
+
+// Returns true if the tree is balanced. Recomputes every height instead of trusting the stored ones, so it
+// also catches a rebalancing bug, and visits each node once
+bool is_balanced(AVLNode * p){
+  return checked_height(p) >= 0;
+}
+
+// Returns size, heights, balance and depth distribution of the tree from one traversal
+TreeStats tree_stats(AVLNode * p){
+  return compute_tree_stats(p);
+}
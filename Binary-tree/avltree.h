@@ -0,0 +1,37 @@
+/*
+* AVL tree
+* 
+* Author: Farhan Syed
+* Year: 2024
+
+  AVL tree header file: the binary search tree of bintree.h with the same operations,
+  kept balanced by rotations so insert, remove, find and edit are O(log n) for any insertion order
+*/
+
+#ifndef AVLTREE_H
+#define AVLTREE_H
+
+#include "treestats.h"
+
+struct AVLNode {
+    int key;
+    double data;
+    AVLNode * right;
+    AVLNode * left;
+    int height;     // Nodes on the longest chain down from this node, 1 for a leaf
+};
+
+AVLNode* createAVLNode(int key, double data);
+void insert(AVLNode * & p, int key, double to_be_inserted);  // Note: reference to pointer, which rotations may change
+void remove(AVLNode * & p, const int & key);
+const double & find(AVLNode * p, const int & to_be_found);
+double & edit(AVLNode * p, const int & to_be_changed);
+void delete_tree(AVLNode * & p);
+
+unsigned int max_height(AVLNode * p);
+unsigned int min_height(AVLNode * p);
+unsigned int size(AVLNode * p);
+bool is_balanced(AVLNode * p);
+TreeStats tree_stats(AVLNode * p);
+
+#endif //AVLTREE_H
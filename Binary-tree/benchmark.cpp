@@ -0,0 +1,169 @@
+// To compile: g++ -O2 -o benchmark.exe benchmark.cpp
+// Usage: ./benchmark.exe [largest tree size, default 1000000]
+// Inserts and lookups per second for trees of shuffled keys, and for the list that sorted keys build,
+// then new and delete against a NodePool on the largest size times 10
+
+#include "bintree.cpp"
+#include "avltree.cpp"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <numeric>
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+// Lookups per measurement
+const int lookups = 2000000;
+
+// find as bintree.cpp did it before it became iterative: one call per level
+const double & recursive_find(Node * p, const int & to_be_found){
+  if (p == nullptr) {
+    throw out_of_range("Key not found!");
+  }
+  if (p->key == to_be_found) {
+    return p->data;
+  }
+  return (p->key > to_be_found) ? recursive_find(p->left, to_be_found) : recursive_find(p->right, to_be_found);
+}
+
+// Run f once and return the elapsed time in seconds
+template<typename F>
+double time_s(F f){
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double>(stop - start).count();
+}
+
+// Operations per second, in millions
+void report(const string & name, double operations, double seconds){
+    cout << "  " << left << setw(28) << name << right << fixed << setprecision(2) << setw(8)
+         << operations / seconds / 1e6 << " M/s" << endl;
+}
+
+// Lookups of random existing keys with find function f on tree t, returning the sum of the found data
+template<typename T, typename F>
+double lookupTest(T * t, const vector<int> & probes, F f, const string & name){
+    double sum = 0;
+    double seconds = time_s([&] {
+        for (int key : probes) {
+            sum += f(t, key);
+        }
+    });
+    report(name, probes.size(), seconds);
+    return sum;
+}
+
+void shuffledTest(int n){
+    cout << "Shuffled keys, n = " << n << endl;
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 1);
+    shuffle(keys.begin(), keys.end(), default_random_engine(020416));
+
+    Node* t = nullptr;
+    AVLNode* avl = nullptr;
+    report("insert", n, time_s([&] { for (int key : keys) insert(t, key, key); }));
+    report("insert (AVL)", n, time_s([&] { for (int key : keys) insert(avl, key, key); }));
+
+    vector<int> probes(lookups);
+    uniform_int_distribution<int> dist(1, n);
+    default_random_engine rng(1);
+    for (int & probe : probes) {
+        probe = dist(rng);
+    }
+    double sum = 0;
+    sum += lookupTest(t, probes, [](Node * p, int key) { return find(p, key); }, "find");
+    sum += lookupTest(t, probes, [](Node * p, int key) { return recursive_find(p, key); }, "find (recursive)");
+    sum += lookupTest(avl, probes, [](AVLNode * p, int key) { return find(p, key); }, "find (AVL)");
+    cout << "  heights: " << max_height(t) << ", AVL " << max_height(avl) << " (checksum " << sum << ")" << endl;
+
+    delete_tree(t);
+    delete_tree(avl);
+}
+
+// Sorted keys make the plain tree a list; built by linking nodes, since n sorted inserts take O(n^2)
+void degenerateTest(int n){
+    cout << "Sorted keys (degenerate tree), n = " << n << endl;
+    Node* t = createNode(1, 1);
+    Node* last = t;
+    for (int key = 2; key <= n; key++) {
+        last->right = createNode(key, key);
+        last = last->right;
+    }
+
+    // Finding key k walks k nodes, so a few lookups suffice; reported as nodes visited per second
+    vector<int> probes(20);
+    uniform_int_distribution<int> dist(1, n);
+    default_random_engine rng(1);
+    for (int & probe : probes) {
+        probe = dist(rng);
+    }
+    const double visited = accumulate(probes.begin(), probes.end(), 0.0);
+    double sum = 0;
+    report("find, nodes visited", visited, time_s([&] { for (int key : probes) sum += find(t, key); }));
+    if (n <= 100000) {  // Deeper recursion would overflow the stack
+        report("find (recursive), nodes", visited, time_s([&] { for (int key : probes) sum += recursive_find(t, key); }));
+    }
+    report("size", n, time_s([&] { sum += size(t); }));
+    report("max_height", n, time_s([&] { sum += max_height(t); }));
+    report("delete_tree", n, time_s([&] { delete_tree(t); }));
+    cout << "  (checksum " << sum << ")" << endl;
+}
+
+// new and delete against a NodePool: building, lookups, traversal, churn (remove and reinsert) and teardown
+void poolTest(int n){
+    cout << "Allocators, shuffled keys, n = " << n << endl;
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 1);
+    shuffle(keys.begin(), keys.end(), default_random_engine(020416));
+    vector<int> churn(keys.begin(), keys.begin() + n / 10);
+
+    vector<int> probes(lookups);
+    uniform_int_distribution<int> dist(1, n);
+    default_random_engine rng(1);
+    for (int & probe : probes) {
+        probe = dist(rng);
+    }
+
+    double sum = 0;
+    Node* t = nullptr;
+    report("insert (new)", n, time_s([&] { for (int key : keys) insert(t, key, key); }));
+    sum += lookupTest(t, probes, [](Node * p, int key) { return find(p, key); }, "find (new)");
+    report("size (new)", n, time_s([&] { sum += size(t); }));
+    report("remove + insert (new)", 2.0 * churn.size(), time_s([&] {
+        for (int key : churn) remove(t, key);
+        for (int key : churn) insert(t, key, key);
+    }));
+    report("delete_tree (new)", n, time_s([&] { delete_tree(t); }));
+
+    NodePool<Node> pool;
+    report("insert (pool)", n, time_s([&] { for (int key : keys) insert(t, key, key, &pool); }));
+    sum += lookupTest(t, probes, [](Node * p, int key) { return find(p, key); }, "find (pool)");
+    report("size (pool)", n, time_s([&] { sum += size(t); }));
+    report("remove + insert (pool)", 2.0 * churn.size(), time_s([&] {
+        for (int key : churn) remove(t, key, &pool);
+        for (int key : churn) insert(t, key, key, &pool);
+    }));
+    report("delete_tree (pool)", n, time_s([&] { delete_tree(t, &pool); }));
+    report("insert again (pool)", n, time_s([&] { for (int key : keys) insert(t, key, key, &pool); }));
+    cout << "  clear (pool), whole tree      " << time_s([&] { pool.clear(); }) * 1e9 << " ns" << endl;
+    t = nullptr;
+    cout << "  (checksum " << sum << ")" << endl;
+}
+
+int main(int argc, char **argv){
+    const int largest = (argc > 1) ? stoi(argv[1]) : 1000000;
+    for (int n = 1000; n <= largest; n *= 10) {
+        shuffledTest(n);
+    }
+    cout << "\n";
+    degenerateTest(100000);
+    degenerateTest(10 * largest);
+    cout << "\n";
+    poolTest(10 * largest);
+}
@@ -6,16 +6,30 @@
 
   Binary search tree implementation
 
+  Every operation walks the tree in a loop instead of recursing, so a degenerate tree (sorted input
+  makes a linked list) of any size cannot overflow the call stack.
+
 */
 
 #include "bintree.h"
 #include <iostream>
 #include <cmath>
+#include <stdexcept>
+#include <vector>
 
 using namespace std;
 
-Node* createNode(int key, double data) {
-  Node* newNode = new Node;
+// Return a node to where it came from
+static void free_node(Node * node, NodePool<Node> * pool) {
+  if (pool != nullptr) {
+    pool->release(node);
+  } else {
+    delete node;
+  }
+}
+
+Node* createNode(int key, double data, NodePool<Node> * pool) {
+  Node* newNode = (pool != nullptr) ? pool->allocate() : new Node;
   newNode->key = key;
   newNode->data = data;
   newNode->left = nullptr;
@@ -24,135 +38,164 @@ Node* createNode(int key, double data) {
 }
 
 // Insert a new node in the tree
-void insert(Node * & p, int key, double to_be_inserted){     
-  // Recursively search for where to place the new node
-  if (p == nullptr) {  // Base case - no node exists in current position in tree, so correct position has been found and new node is inserted
-      p = createNode(key, to_be_inserted);
-  } else if(p->key == key){ // Duplicate key, so only update data
-      p->data = to_be_inserted;
-  }
-  else if (key < p->key) { // New node key is less than key of node that p points to, so go left
-      insert(p->left, key, to_be_inserted);
-  } else {            // New node key is greater than key of node that p points to, so go right
-      insert(p->right, key, to_be_inserted); 
+void insert(Node * & p, int key, double to_be_inserted, NodePool<Node> * pool){     
+  // Walk down with a pointer to the link that will hold the new node, so no special case for the root
+  Node ** link = &p;
+  while (*link != nullptr) {
+    if ((*link)->key == key) { // Duplicate key, so only update data
+      (*link)->data = to_be_inserted;
+      return;
+    }
+    // New node key is less than the current key, so go left; otherwise go right
+    link = (key < (*link)->key) ? &(*link)->left : &(*link)->right;
   }
+  // No node exists in this position, so the correct position has been found and the new node is inserted
+  *link = createNode(key, to_be_inserted, pool);
 }
 
-void remove(Node * & p, const int & key){
-  if (p == nullptr) { // Key not found
+void remove(Node * & p, const int & key, NodePool<Node> * pool){
+  // Search for the link pointing to the node with matching key
+  Node ** link = &p;
+  while (*link != nullptr && (*link)->key != key) {
+    link = (key < (*link)->key) ? &(*link)->left : &(*link)->right;
+  }
+  if (*link == nullptr) { // Key not found
     throw out_of_range("Key not found!");
   }
-  // Search for correct node with matching key
-  if (key < p->key) { // Key to be removed is less than current node's key (that p points to), so go left
-    remove(p->left, key);
-  } else if (key > p->key) { // Key to be removed is greater than current node's key (that p points to), so go right
-    remove(p->right, key);
-  } 
   // Correct node has been found
-  else {                  
-    if (p->left == nullptr && p->right == nullptr) { // Leaf node (no children) so node can be easily removed
-        delete p;
-        p = nullptr;        
-    } else if (p->left == nullptr) { // Has right but no left child, so delete the node and move right child to its position
-        Node *rightChild = p->right;
-        delete p;
-        p = rightChild;
-    } else if (p->right == nullptr) { // Has left but no right child, so delete the node and move left child to its position
-        Node *leftChild = p->left;
-        delete p;
-        p = leftChild;
-    } else { // Node has both left and right children            
-        // 1. Find the minimum node in the right subtree 
-        Node* minNode = p->right; 
-        while (minNode->left != nullptr) {  // traverse through each left node until leaf is reached
-          minNode = minNode->left;
-        }
-        // 2. Replace the current node with the minimum node's key and data 
-        p->key = minNode->key; 
-        p->data = minNode->data;
-        // 3. Remove the minimum node instead, which is a leaf 
-        remove(p->right, minNode->key); 
+  Node *node = *link;
+  if (node->left == nullptr) { // No left child, so the right child (possibly none) moves to its position
+    *link = node->right;
+    free_node(node, pool);
+  } else if (node->right == nullptr) { // Has left but no right child, so the left child moves to its position
+    *link = node->left;
+    free_node(node, pool);
+  } else { // Node has both left and right children
+    // 1. Find the minimum node in the right subtree, and the link pointing to it
+    Node ** minLink = &node->right;
+    while ((*minLink)->left != nullptr) {
+      minLink = &(*minLink)->left;
     }
+    Node *minNode = *minLink;
+    // 2. Replace the current node's key and data with the minimum node's
+    node->key = minNode->key;
+    node->data = minNode->data;
+    // 3. Unlink the minimum node instead, which has no left child
+    *minLink = minNode->right;
+    free_node(minNode, pool);
   }
 }
 
 // Find the node with key and returns it associated data.
 const double & find(Node * p, const int & to_be_found){
-  if (p == nullptr) { // Leaf has been reached and key has not been found 
-    throw out_of_range("Key not found!");
-  }
-  if(p->key == to_be_found){ // Key is found, so return the node's data
-    return p->data;
-  }
-  else{
+  while (p != nullptr) {
+    if (p->key == to_be_found) { // Key is found, so return the node's data
+      return p->data;
+    }
     // If less than current key -> go left. 
     // If greater than current key -> go right
-    return (p->key > to_be_found) ? find(p->left, to_be_found) : find(p->right, to_be_found);
+    p = (p->key > to_be_found) ? p->left : p->right;
   }
+  // Leaf has been reached and key has not been found
+  throw out_of_range("Key not found!");
 }
 
 // Find and return a reference to editable data associated with the key
 double & edit(Node * p, const int & to_be_changed){
-  if (p == nullptr) { // Leaf has been reached and key has not been found 
-      throw out_of_range("Key not found!");
-  }
-  if(p->key == to_be_changed){ // Key is found, so return the node's data
+  while (p != nullptr) {
+    if (p->key == to_be_changed) { // Key is found, so return the node's data
       return p->data;
+    }
+    p = (p->key > to_be_changed) ? p->left : p->right;
   }
-  else{
-    // If less than current key -> go left. 
-    // If greater than current key -> go right
-    return (p->key > to_be_changed) ? edit(p->left, to_be_changed) : edit(p->right, to_be_changed);
-  }   
+  throw out_of_range("Key not found!");
 }
 
-// Deletes the entire tree at p
-void delete_tree(Node * & p){
-  if (p != nullptr) {
-    delete_tree(p->left);  // Delete all subtrees
-    delete_tree(p->right);
-    delete p;             // Delete the remaining node 
-    p = nullptr;
-  } 
+// Deletes the entire tree at p without a stack: while the current node has a left child, rotate it right,
+// which moves the left child up; a node without left child is deleted and its right child is next.
+// Every rotation moves one node onto the right spine for good, so this takes O(n) steps.
+void delete_tree(Node * & p, NodePool<Node> * pool){
+  while (p != nullptr) {
+    if (p->left != nullptr) {
+      Node *leftChild = p->left;
+      p->left = leftChild->right;
+      leftChild->right = p;
+      p = leftChild;
+    } else {
+      Node *rightChild = p->right;
+      free_node(p, pool);
+      p = rightChild;
+    }
+  }
 }
 
-// Returns the height (longest chain) of the tree
+// Returns the height (longest chain) of the tree: the number of levels, visited one level at a time
 unsigned int max_height(Node * p){
-  if (p == nullptr){
-    return 0;
+  unsigned int height = 0;
+  vector<Node*> level;
+  vector<Node*> nextLevel;
+  if (p != nullptr) {
+    level.push_back(p);
   }
-  int LHeight = max_height(p->left); // Calculate height of each subtree
-  int RHeight = max_height(p->right);
-
-  return (LHeight > RHeight) ? LHeight+1 : RHeight+1; // Height of current node is max height of subtrees plus 1  
+  while (!level.empty()) {
+    height++;
+    nextLevel.clear();
+    for (Node *node : level) {
+      if (node->left != nullptr) nextLevel.push_back(node->left);
+      if (node->right != nullptr) nextLevel.push_back(node->right);
+    }
+    level.swap(nextLevel);
+  }
+  return height;
 }
 
-// Returns the shortest chain of the tree
+// Returns the shortest chain of the tree: a missing child ends a chain, so this is the level of the first
+// node with fewer than two children, and only the levels above it are visited
 unsigned int min_height(Node * p){
   if (p == nullptr){
     return 0;
   }
-  int LHeight = min_height(p->left); // Calculate height of each subtree
-  int RHeight = min_height(p->right);
-
-  return (LHeight < RHeight) ? LHeight+1 : RHeight+1; // Height of current node is min height of subtrees plus 1  
+  unsigned int height = 1;
+  vector<Node*> level(1, p);
+  vector<Node*> nextLevel;
+  while (true) {
+    nextLevel.clear();
+    for (Node *node : level) {
+      if (node->left == nullptr || node->right == nullptr) {
+        return height;
+      }
+      nextLevel.push_back(node->left);
+      nextLevel.push_back(node->right);
+    }
+    level.swap(nextLevel);
+    height++;
+  }
 }
 
-// Returns the number of nodes (p included) in the tree
+// Returns the number of nodes (p included) in the tree, with an explicit stack of subtrees still to count
 unsigned int size(Node * p){
-  if (p == nullptr) { 
-    return 0; 
+  unsigned int count = 0;
+  vector<Node*> stack;
+  if (p != nullptr) {
+    stack.push_back(p);
+  }
+  while (!stack.empty()) {
+    Node *node = stack.back();
+    stack.pop_back();
+    count++;
+    if (node->left != nullptr) stack.push_back(node->left);
+    if (node->right != nullptr) stack.push_back(node->right);
   }
-  return size(p->left) + size(p->right) + 1; // Size of tree is sum of sizes of subtrees, plus 1 for the root node
+  return count;
 }
 
-// Returns true if the tree is balanced
-bool is_balanced(Node * p){  
-  if (p == nullptr) {
-      return true; 
-  }
-  // In a balanced tree, the heights of the subtrees of every node can only differ by 1  
-  int LHeight = max_height(p->left);
-  int RHeight = max_height(p->right);
-  return (abs(LHeight - RHeight) <= 1 && is_balanced(p->left) && is_balanced(p->right)); // Check that current node and both subtrees are balanced  
-}
\ No newline at end of file
+// Returns true if the tree is balanced: the heights of the subtrees of every node differ by at most 1.
+// All heights come from one post-order pass, instead of max_height calls at every node
+bool is_balanced(Node * p){
+  return compute_tree_stats(p).balanced;
+}
+
+// Returns size, heights, balance and depth distribution of the tree from one traversal
+TreeStats tree_stats(Node * p){
+  return compute_tree_stats(p);
+}
@@ -10,6 +10,9 @@
 #ifndef BINTREE_H
 #define BINTREE_H
 
+#include "nodepool.h"
+#include "treestats.h"
+
 struct Node {
     int key;
     double data;
@@ -17,16 +20,19 @@ struct Node {
     Node * left;
 };
 
-Node* createNode(int key, double data);
-void insert(Node * & p, int key, double to_be_inserted);  // Note: reference to pointer
-void remove(Node * & p, const int & key);
+// Nodes come from new and delete, or from pool when one is given. A tree must use the same pool throughout;
+// pool->clear() frees a whole pooled tree at once, after which the root must be set to nullptr.
+Node* createNode(int key, double data, NodePool<Node> * pool = nullptr);
+void insert(Node * & p, int key, double to_be_inserted, NodePool<Node> * pool = nullptr);  // Note: reference to pointer
+void remove(Node * & p, const int & key, NodePool<Node> * pool = nullptr);
 const double & find(Node * p, const int & to_be_found);
 double & edit(Node * p, const int & to_be_changed);
-void delete_tree(Node * & p);
+void delete_tree(Node * & p, NodePool<Node> * pool = nullptr);
 
 unsigned int max_height(Node * p);
 unsigned int min_height(Node * p);
 unsigned int size(Node * p);
 bool is_balanced(Node * p);
+TreeStats tree_stats(Node * p);  // All of the above and the depth distribution in one pass
 
 #endif //BINTREE_H
\ No newline at end of file
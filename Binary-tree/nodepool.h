@@ -0,0 +1,130 @@
+/*
+* Node pool
+*
+* Author: Farhan Syed
+* Year: 2024
+
+  Slab allocator for tree nodes, used by Binary-tree and Binary-tree-iterator
+*/
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Hands out nodes of type N from slabs of slabSize nodes. Released nodes go on a free list and are handed out
+// again first, so once a tree has reached its size, inserts no longer allocate. Nodes allocated one after the
+// other sit next to each other in memory, and clear() releases every node at once while keeping the slabs.
+// A tree must use the same pool for all its nodes. Nodes still in use when the pool is destroyed are freed
+// without running their destructors.
+template <class N>
+class NodePool {
+public:
+    explicit NodePool(size_t slabSize = 4096);
+    ~NodePool();
+
+    NodePool(const NodePool &) = delete;
+    NodePool & operator=(const NodePool &) = delete;
+
+    N* allocate();              // Default-initialized node
+    void release(N* node);      // Destroys the node and puts it on the free list, nullptr is ignored
+    void clear();               // Releases all nodes in O(1), only for trivially destructible N
+
+    size_t size() const;        // Nodes in use
+    size_t capacity() const;    // Nodes the slabs have room for
+
+private:
+    // Storage of one node, or the link to the next free slot while unused
+    union Slot {
+        Slot* next;
+        alignas(N) unsigned char storage[sizeof(N)];
+    };
+
+    std::vector<Slot*> m_slabs;
+    size_t m_slabSize;
+    size_t m_nextSlab;  // Slabs before this one have been handed out, at least in part
+    Slot* m_next;       // Next never used slot of the current slab
+    Slot* m_end;        // End of the current slab
+    Slot* m_free;       // Free list of released slots
+    size_t m_size;
+};
+
+//
+// Implementations
+//
+
+// Empty pool, slabs are allocated on demand
+template <class N>
+NodePool<N>::NodePool(size_t slabSize)
+    : m_slabSize(slabSize > 0 ? slabSize : 1), m_nextSlab(0), m_next(nullptr), m_end(nullptr), m_free(nullptr), m_size(0) {}
+
+// Frees the slabs
+template <class N>
+NodePool<N>::~NodePool() {
+    for (Slot* slab : m_slabs) {
+        ::operator delete(slab, std::align_val_t(alignof(Slot)));
+    }
+}
+
+// Take a slot from the free list, else the next unused one, opening a new slab when the current one is full
+template <class N>
+N* NodePool<N>::allocate() {
+    Slot* slot;
+    if (m_free != nullptr) {
+        slot = m_free;
+        m_free = m_free->next;
+    } else {
+        if (m_next == m_end) {
+            if (m_nextSlab == m_slabs.size()) {
+                // Aligned for N, which may ask for more than new gives, e.g. nodes aligned to cache lines
+                m_slabs.push_back(static_cast<Slot*>(::operator new(m_slabSize * sizeof(Slot), std::align_val_t(alignof(Slot)))));
+            }
+            m_next = m_slabs[m_nextSlab++];
+            m_end = m_next + m_slabSize;
+        }
+        slot = m_next++;
+    }
+    m_size++;
+    return new (slot->storage) N;
+}
+
+// Destroy the node and push its slot on the free list
+template <class N>
+void NodePool<N>::release(N* node) {
+    if (node == nullptr) {
+        return;
+    }
+    node->~N();
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = m_free;
+    m_free = slot;
+    m_size--;
+}
+
+// Forget every node: the slabs are handed out again from the start
+template <class N>
+void NodePool<N>::clear() {
+    static_assert(std::is_trivially_destructible<N>::value, "NodePool::clear would skip the node destructors");
+    m_nextSlab = 0;
+    m_next = nullptr;
+    m_end = nullptr;
+    m_free = nullptr;
+    m_size = 0;
+}
+
+// Nodes allocated and not yet released
+template <class N>
+size_t NodePool<N>::size() const {
+    return m_size;
+}
+
+// Nodes that fit in the slabs allocated so far
+template <class N>
+size_t NodePool<N>::capacity() const {
+    return m_slabs.size() * m_slabSize;
+}
+
+#endif //NODEPOOL_H
@@ -0,0 +1,188 @@
+#include "avltree.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// To compile: g++ -o testavl.exe testavl.cpp avltree.cpp -lgtest -lgtest_main -pthread
+// Running valgrind: valgrind --leak-check=full --show-leak-kinds=all ./testavl.exe
+
+using namespace std;
+
+// Largest height of an AVL tree with n nodes: 1.44 log2(n + 2)
+static unsigned int avl_height_bound(size_t n) {
+    return static_cast<unsigned int>(1.4405 * log2(n + 2.0));
+}
+
+// EMPTY TREE
+
+TEST(AVLEmptyTreeTest, insert) {
+    AVLNode *t = nullptr;
+    insert(t,1,10);
+    EXPECT_EQ(t->key, 1);
+    EXPECT_EQ(t->data, 10);
+    EXPECT_EQ(t->height, 1);
+    EXPECT_EQ(t->left, nullptr);
+    EXPECT_EQ(t->right, nullptr);
+
+    delete_tree(t);
+}
+
+TEST(AVLEmptyTreeTest, outOfRangeError) {
+    AVLNode *t = nullptr;
+    EXPECT_THROW(remove(t, 1), out_of_range);
+    EXPECT_THROW(find(t, 1), out_of_range);
+    EXPECT_THROW(edit(t, 1), out_of_range);
+    EXPECT_EQ(max_height(t), 0);
+    EXPECT_EQ(size(t), 0);
+    EXPECT_EQ(is_balanced(t), true);
+}
+
+// ROTATIONS
+
+TEST(AVLRotations, leftLeftAndRightRight) {
+    AVLNode *t = nullptr;
+    insert(t,3,3);
+    insert(t,2,2);
+    insert(t,1,1); // Left-left: single right rotation
+    EXPECT_EQ(t->key, 2);
+    EXPECT_EQ(t->left->key, 1);
+    EXPECT_EQ(t->right->key, 3);
+    EXPECT_EQ(max_height(t), 2);
+    delete_tree(t);
+
+    insert(t,1,1);
+    insert(t,2,2);
+    insert(t,3,3); // Right-right: single left rotation
+    EXPECT_EQ(t->key, 2);
+    EXPECT_EQ(t->left->key, 1);
+    EXPECT_EQ(t->right->key, 3);
+    EXPECT_EQ(is_balanced(t), true);
+
+    delete_tree(t);
+}
+
+TEST(AVLRotations, leftRightAndRightLeft) {
+    AVLNode *t = nullptr;
+    insert(t,3,3);
+    insert(t,1,1);
+    insert(t,2,2); // Left-right: double rotation
+    EXPECT_EQ(t->key, 2);
+    EXPECT_EQ(t->left->key, 1);
+    EXPECT_EQ(t->right->key, 3);
+    delete_tree(t);
+
+    insert(t,1,1);
+    insert(t,3,3);
+    insert(t,2,2); // Right-left: double rotation
+    EXPECT_EQ(t->key, 2);
+    EXPECT_EQ(t->left->key, 1);
+    EXPECT_EQ(t->right->key, 3);
+    EXPECT_EQ(is_balanced(t), true);
+
+    delete_tree(t);
+}
+
+// CORRECTNESS SIZE > 1
+
+TEST(AVLCorrectness, insertFindEditRemove) {
+    AVLNode *t = nullptr;
+    insert(t,10,2);
+    insert(t,20,3);
+    insert(t,9,1);
+    insert(t,7,6);
+    insert(t,8,8);
+    insert(t,8,9); // duplicate key
+
+    EXPECT_EQ(find(t,8), 9);
+    EXPECT_EQ(size(t), 5);
+    EXPECT_EQ(max_height(t), 3);
+    EXPECT_EQ(is_balanced(t), true);
+
+    edit(t,20) = 4;
+    EXPECT_EQ(find(t,20), 4);
+
+    remove(t,10); // Node with two children
+    EXPECT_THROW(find(t, 10), out_of_range);
+    EXPECT_THROW(remove(t, 10), out_of_range);
+    EXPECT_EQ(find(t,9), 1);
+    EXPECT_EQ(find(t,7), 6);
+    EXPECT_EQ(size(t), 4);
+    EXPECT_EQ(is_balanced(t), true);
+
+    delete_tree(t);
+    EXPECT_EQ(t, nullptr);
+}
+
+TEST(AVLCorrectness, removeRebalances) {
+    AVLNode *t = nullptr;
+    for (int key = 1; key <= 7; key++) { // Perfect tree with root 4
+        insert(t,key,key);
+    }
+    remove(t,1);
+    remove(t,3);
+    remove(t,2); // Left side is now empty, so the root must rotate
+    EXPECT_EQ(size(t), 4);
+    EXPECT_EQ(max_height(t), 3);
+    EXPECT_EQ(is_balanced(t), true);
+    for (int key = 4; key <= 7; key++) {
+        EXPECT_EQ(find(t,key), key);
+    }
+
+    delete_tree(t);
+}
+
+// HEIGHT BOUND
+
+TEST(AVLHeight, sortedInput) {
+    AVLNode *t = nullptr;
+    const int n = 100000;
+    for (int key = 1; key <= n; key++) {
+        insert(t,key,key);
+    }
+    EXPECT_EQ(size(t), n);
+    EXPECT_LE(max_height(t), avl_height_bound(n));
+    EXPECT_EQ(is_balanced(t), true);
+
+    for (int key = n; key > 0; key -= 2) { // Remove every other key from the top down
+        remove(t,key);
+    }
+    EXPECT_EQ(size(t), n / 2);
+    EXPECT_LE(max_height(t), avl_height_bound(n / 2));
+    EXPECT_EQ(is_balanced(t), true);
+    EXPECT_EQ(find(t,1), 1);
+    EXPECT_THROW(find(t, 2), out_of_range);
+
+    delete_tree(t);
+}
+
+TEST(AVLHeight, randomInsertAndRemove) {
+    vector<int> keys(20000);
+    iota(keys.begin(), keys.end(), 1);
+    shuffle(keys.begin(), keys.end(), default_random_engine(020416));
+
+    AVLNode *t = nullptr;
+    for (int key : keys) {
+        insert(t,key,key * 0.5);
+    }
+    shuffle(keys.begin(), keys.end(), default_random_engine(1));
+    for (size_t i = 0; i < keys.size() / 2; i++) {
+        remove(t,keys[i]);
+    }
+    EXPECT_EQ(size(t), keys.size() / 2);
+    EXPECT_LE(max_height(t), avl_height_bound(keys.size() / 2));
+    EXPECT_EQ(is_balanced(t), true);
+    TreeStats stats = tree_stats(t);
+    EXPECT_EQ(stats.size, size(t));
+    EXPECT_EQ(stats.max_height, max_height(t));
+    EXPECT_EQ(stats.min_height, min_height(t));
+    EXPECT_EQ(stats.balanced, true);
+    EXPECT_LT(stats.average_depth, max_height(t) - 1.0);
+    for (size_t i = keys.size() / 2; i < keys.size(); i++) {
+        EXPECT_EQ(find(t,keys[i]), keys[i] * 0.5);
+    }
+
+    delete_tree(t);
+}
@@ -3,6 +3,7 @@
 // Running valgrind: valgrind --leak-check=full --show-leak-kinds=all ./testbalance.exe
 
 #include "bintree.cpp"
+#include "avltree.cpp"
 
 #include <iostream>
 #include <vector>
@@ -31,8 +32,9 @@ void basicTest(){
         for (int num : randomNumbers) {
             insert(t, num, num);
         }
-        maxHeightResults[i] = max_height(t);
-        minHeightResults[i] = min_height(t);
+        TreeStats stats = tree_stats(t);  // Both heights from one traversal
+        maxHeightResults[i] = stats.max_height;
+        minHeightResults[i] = stats.min_height;
 
         delete_tree(t);
 
@@ -91,8 +93,9 @@ void improvedTest(){
         for (int num : randomNumbers) {
             insert(t, num, num);
         }
-        maxHeightResults[i] = max_height(t);
-        minHeightResults[i] = min_height(t);
+        TreeStats stats = tree_stats(t);  // Both heights from one traversal
+        maxHeightResults[i] = stats.max_height;
+        minHeightResults[i] = stats.min_height;
 
         delete_tree(t);
     }
@@ -129,8 +132,66 @@ void improvedTest(){
     cout << "Lowest height difference: " << lowestDifference << endl;
 }
 
+// Insert the keys in order into a tree of type T, print its shape and return the maximum height
+template<typename T>
+unsigned int insertAndMeasure(const vector<int> & keys, const string & name){
+    T* t = nullptr;
+    for (int num : keys) {
+        insert(t, num, num);
+    }
+    TreeStats stats = tree_stats(t);
+    cout << "  " << name << " maximum height: " << stats.max_height << ", minimum height: " << stats.min_height
+         << ", average depth: " << fixed << setprecision(1) << stats.average_depth
+         << ", balanced: " << (stats.balanced ? "yes" : "no") << endl;
+    delete_tree(t);
+    return stats.max_height;
+}
+
+// Orders that degrade the plain tree, against the AVL tree. The AVL height must stay below 1.44 log2(n + 2).
+void adversarialTest(){
+    cout << "Adversarial test" << endl;
+
+    const int n = 9000;
+    vector<int> ascending(n);
+    iota(ascending.begin(), ascending.end(), 1);
+
+    vector<int> descending(ascending.rbegin(), ascending.rend());
+
+    vector<int> zigzag;         // 1, n, 2, n-1, ...: every insert goes to the bottom of one long chain
+    for (int low = 1, high = n; low <= high; low++, high--) {
+        zigzag.push_back(low);
+        if (low != high) {
+            zigzag.push_back(high);
+        }
+    }
+
+    vector<int> organPipe;      // Middle first, then outwards: two sorted chains
+    for (int offset = 0; offset < n / 2; offset++) {
+        organPipe.push_back(n / 2 - offset);
+        organPipe.push_back(n / 2 + 1 + offset);
+    }
+
+    vector<int> shuffled = ascending;
+    shuffle(shuffled.begin(), shuffled.end(), default_random_engine(020416));
+
+    const unsigned int bound = static_cast<unsigned int>(1.4405 * log2(n + 2.0));
+    cout << "log2(n) = " << defaultfloat << setprecision(4) << log2(n) << ", AVL bound 1.44 log2(n + 2) = " << bound << endl;
+
+    vector<pair<string, vector<int>>> orders = {{"Ascending", ascending}, {"Descending", descending},
+        {"Zigzag", zigzag}, {"Organ pipe", organPipe}, {"Shuffled", shuffled}};
+    bool withinBound = true;
+    for (const auto & order : orders) {
+        cout << order.first << endl;
+        insertAndMeasure<Node>(order.second, "Binary tree");
+        withinBound = insertAndMeasure<AVLNode>(order.second, "AVL tree   ") <= bound && withinBound;
+    }
+    cout << "AVL heights within bound: " << (withinBound ? "yes" : "no") << endl;
+}
+
 int main(){
     basicTest();
     cout << "\n";
     improvedTest();
+    cout << "\n";
+    adversarialTest();
 }
\ No newline at end of file
@@ -150,6 +150,21 @@ TEST(CorrectnessSizeGreaterThanOne, findAndHeight) {
     delete_tree(t);
 }
 
+TEST(CorrectnessSizeGreaterThanOne, minHeightCountsMissingChildren) {
+    Node *t = createNode(10,2);
+
+    insert(t,5,3);
+    insert(t,15,1);
+    insert(t,3,6);
+    insert(t,7,8);
+    insert(t,20,4); // 15 has no left child, so the shortest chain is 10 -> 15
+
+    EXPECT_EQ(min_height(t), 2);
+    EXPECT_EQ(max_height(t), 3);
+
+    delete_tree(t);
+}
+
 TEST(CorrectnessSizeGreaterThanOne, deleteTree) {
     Node *t = createNode(10,2);
 
@@ -206,3 +221,131 @@ TEST(ThrowErrorSizeGreaterThanOne, remove) {
 
     delete_tree(t);
 }
+
+// TREE STATISTICS
+
+TEST(TreeStatsTest, emptyAndSizeOne) {
+    Node *t = nullptr;
+    TreeStats stats = tree_stats(t);
+    EXPECT_EQ(stats.size, 0);
+    EXPECT_EQ(stats.max_height, 0);
+    EXPECT_EQ(stats.min_height, 0);
+    EXPECT_EQ(stats.balanced, true);
+    EXPECT_EQ(stats.depth_counts.size(), 0);
+
+    insert(t,1,2);
+    stats = tree_stats(t);
+    EXPECT_EQ(stats.size, 1);
+    EXPECT_EQ(stats.max_height, 1);
+    EXPECT_EQ(stats.min_height, 1);
+    EXPECT_EQ(stats.depth_counts, vector<unsigned int>({1}));
+    EXPECT_EQ(stats.average_depth, 0);
+
+    delete_tree(t);
+}
+
+TEST(TreeStatsTest, matchesSeparateFunctions) {
+    Node *t = createNode(10,2);
+    insert(t,20,3);
+    insert(t,9,1);
+    insert(t,7,6);
+    insert(t,8,8);
+
+    TreeStats stats = tree_stats(t);
+    EXPECT_EQ(stats.size, size(t));
+    EXPECT_EQ(stats.max_height, max_height(t));
+    EXPECT_EQ(stats.min_height, min_height(t));
+    EXPECT_EQ(stats.balanced, false);
+    EXPECT_EQ(stats.depth_counts, vector<unsigned int>({1, 2, 1, 1}));
+    EXPECT_DOUBLE_EQ(stats.average_depth, (0 + 1 + 1 + 2 + 3) / 5.0);
+
+    remove(t,8);
+    insert(t,15,4);
+    EXPECT_EQ(is_balanced(t), true);
+    EXPECT_EQ(tree_stats(t).depth_counts, vector<unsigned int>({1, 2, 2}));
+
+    delete_tree(t);
+}
+
+// DEGENERATE TREE
+
+TEST(DegenerateTree, tenMillionNodes) {
+    // The list that inserting 1..n in order builds, linked directly to skip the O(n^2) inserts
+    const int n = 10000000;
+    Node *t = createNode(1,1);
+    Node *last = t;
+    for (int key = 2; key <= n; key++) {
+        last->right = createNode(key,key);
+        last = last->right;
+    }
+
+    EXPECT_EQ(size(t), n);
+    EXPECT_EQ(max_height(t), n);
+    EXPECT_EQ(min_height(t), 1);
+    EXPECT_EQ(is_balanced(t), false);
+    TreeStats stats = tree_stats(t);
+    EXPECT_EQ(stats.max_height, n);
+    EXPECT_EQ(stats.depth_counts.back(), 1);
+    EXPECT_DOUBLE_EQ(stats.average_depth, (n - 1) / 2.0);
+    EXPECT_EQ(find(t,n), n);
+    edit(t,n) = 0.5;
+    EXPECT_EQ(find(t,n), 0.5);
+    EXPECT_THROW(find(t, n + 1), out_of_range);
+
+    insert(t,n + 1,1);
+    EXPECT_EQ(max_height(t), n + 1);
+    remove(t,n + 1);
+    remove(t,1);
+    EXPECT_EQ(t->key, 2);
+    remove(t,n / 2);
+    EXPECT_THROW(find(t, n / 2), out_of_range);
+    EXPECT_EQ(size(t), n - 2);
+
+    delete_tree(t);
+    EXPECT_EQ(t, nullptr);
+}
+
+// NODE POOL
+
+TEST(NodePoolTest, insertRemoveAndClear) {
+    NodePool<Node> pool(4);
+    Node *t = nullptr;
+    for (int key : {5, 2, 8, 1, 3, 7, 9}) {
+        insert(t,key,key * 10,&pool);
+    }
+    EXPECT_EQ(pool.size(), 7);
+    EXPECT_EQ(pool.capacity(), 8);
+    EXPECT_EQ(find(t,3), 30);
+
+    remove(t,5,&pool); // Both children, so the successor's node is released
+    remove(t,1,&pool);
+    EXPECT_EQ(pool.size(), 5);
+    EXPECT_THROW(find(t, 5), out_of_range);
+    EXPECT_THROW(remove(t, 5, &pool), out_of_range);
+
+    insert(t,4,40,&pool); // Reuses a released node
+    insert(t,6,60,&pool);
+    EXPECT_EQ(pool.size(), 7);
+    EXPECT_EQ(pool.capacity(), 8);
+    EXPECT_EQ(size(t), 7);
+    EXPECT_EQ(find(t,6), 60);
+
+    delete_tree(t,&pool);
+    EXPECT_EQ(t, nullptr);
+    EXPECT_EQ(pool.size(), 0);
+
+    for (int key = 1; key <= 100; key++) {
+        insert(t,key,key,&pool);
+    }
+    EXPECT_EQ(pool.size(), 100);
+    size_t capacity = pool.capacity();
+    pool.clear(); // The whole tree at once
+    t = nullptr;
+    EXPECT_EQ(pool.size(), 0);
+    for (int key = 100; key >= 1; key--) { // Fills the same slabs again
+        insert(t,key,key,&pool);
+    }
+    EXPECT_EQ(pool.capacity(), capacity);
+    EXPECT_EQ(find(t,50), 50);
+    pool.clear();
+}
@@ -0,0 +1,97 @@
+/*
+* Tree statistics
+*
+* Author: Farhan Syed
+* Year: 2024
+
+  Shape of a binary tree in one traversal, for Node and AVLNode trees
+*/
+
+#ifndef TREESTATS_H
+#define TREESTATS_H
+
+#include <vector>
+
+struct TreeStats {
+    unsigned int size = 0;
+    unsigned int max_height = 0;    // As max_height(), longest chain
+    unsigned int min_height = 0;    // As min_height(), shortest chain to a missing child
+    bool balanced = true;           // As is_balanced()
+    std::vector<unsigned int> depth_counts; // Nodes at each depth, the root has depth 0; max_height entries
+    double average_depth = 0;       // Mean depth of the nodes: a lookup of an existing key compares 1 + this on average
+};
+
+// One post-order pass over the tree at p with an explicit stack, so O(n) time for any shape and O(height)
+// memory. N needs left and right pointers.
+template <class N>
+TreeStats compute_tree_stats(N * p);
+
+//
+// Implementations
+//
+
+template <class N>
+TreeStats compute_tree_stats(N * p) {
+    // Heights and balance of a finished subtree
+    struct Shape {
+        unsigned int max_height;
+        unsigned int min_height;
+        bool balanced;
+    };
+    // A node on the path from the root; expanded once its children have been pushed
+    struct Frame {
+        N * node;
+        unsigned int depth;
+        bool expanded;
+    };
+
+    TreeStats stats;
+    if (p == nullptr) {
+        return stats;
+    }
+    double depthSum = 0;
+    std::vector<Frame> stack(1, Frame{p, 0, false});
+    std::vector<Shape> shapes;  // Subtrees finished but not yet combined into their parent, left below right
+    while (!stack.empty()) {
+        Frame & frame = stack.back();
+        N * node = frame.node;
+        unsigned int depth = frame.depth;
+        if (!frame.expanded) {  // First visit: count the node, then its children are done before it
+            frame.expanded = true;
+            stats.size++;
+            depthSum += depth;
+            if (stats.depth_counts.size() <= depth) {
+                stats.depth_counts.push_back(0);
+            }
+            stats.depth_counts[depth]++;
+            if (node->right != nullptr) stack.push_back(Frame{node->right, depth + 1, false});
+            if (node->left != nullptr) stack.push_back(Frame{node->left, depth + 1, false});
+            continue;
+        }
+        // Second visit: both children are finished, combine them. A missing child is an empty subtree
+        stack.pop_back();
+        Shape right = {0, 0, true};
+        Shape left = {0, 0, true};
+        if (node->right != nullptr) {
+            right = shapes.back();
+            shapes.pop_back();
+        }
+        if (node->left != nullptr) {
+            left = shapes.back();
+            shapes.pop_back();
+        }
+        unsigned int difference = (left.max_height > right.max_height) ? left.max_height - right.max_height
+                                                                         : right.max_height - left.max_height;
+        shapes.push_back(Shape{
+            ((left.max_height > right.max_height) ? left.max_height : right.max_height) + 1,
+            ((left.min_height < right.min_height) ? left.min_height : right.min_height) + 1,
+            left.balanced && right.balanced && difference <= 1});
+    }
+    stats.max_height = shapes.back().max_height;
+    stats.min_height = shapes.back().min_height;
+    stats.balanced = shapes.back().balanced;
+    stats.average_depth = depthSum / stats.size;
+    return stats;
+}
+
+#endif //TREESTATS_H
@@ -13,110 +13,182 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <type_traits>
 
-class Complex{
+// Complex number with parts of type T: float, double, long double or a fixed-point type (see FixedPoint.h).
+// Complex, the double version, is the one used by the rest of the library. ComplexF holds half the bytes, so
+// float loops move half the data and fit twice as many numbers in a vector register.
+template<typename T>
+class BasicComplex{
 
     public:
+        typedef T value_type;
+
         // Constructors
-        Complex();
-        Complex(double real); 
-        constexpr Complex(double real,double imaginary);
+        constexpr BasicComplex() noexcept;
+        constexpr BasicComplex(T real) noexcept;
+        constexpr BasicComplex(T real,T imaginary) noexcept;
+
+        // Conversion from another precision, explicit since it may round
+        template<typename U>
+        explicit constexpr BasicComplex(const BasicComplex<U> &other) noexcept;
         
-        Complex(const Complex &rhs);
-        Complex &operator=(const Complex &other);
+        // Trivial copies, so arrays of Complex can be moved with memcpy and kept in vector registers
+        constexpr BasicComplex(const BasicComplex &rhs) noexcept = default;
+        constexpr BasicComplex &operator=(const BasicComplex &other) noexcept = default;
         
         // Accessors
-        double real() const;
-        double imag() const;
+        constexpr T real() const noexcept;
+        constexpr T imag() const noexcept;
 
         // Operators
-        Complex& operator+=(const Complex &other);
-        Complex& operator-=(const Complex &other);
-        Complex& operator*=(const Complex &other); 
-        Complex& operator/=(const Complex &other); 
+        constexpr BasicComplex& operator+=(const BasicComplex &other) noexcept;
+        constexpr BasicComplex& operator-=(const BasicComplex &other) noexcept;
+        constexpr BasicComplex& operator*=(const BasicComplex &other) noexcept; 
+        constexpr BasicComplex& operator/=(const BasicComplex &other); 
 
     private:
-        double re;
-        double im;
+        T re;
+        T im;
 
 };
 
-// Non-member functions 
-Complex operator+(const Complex &lhs, const Complex &rhs);
-Complex operator-(const Complex &lhs, const Complex &rhs);
-Complex operator*(const Complex &lhs, const Complex &rhs);
-Complex operator/(const Complex &lhs, const Complex &rhs);
-
-bool operator==(const Complex &lhs, const Complex &rhs);
-bool operator!=(const Complex &lhs, const Complex &rhs);
-
-double real(const Complex &number);
-double imag(const Complex &number);
-double abs(const Complex &number);
+typedef BasicComplex<float> ComplexF;
+typedef BasicComplex<double> Complex;
+typedef BasicComplex<long double> ComplexLD;
 
-bool operator<(const Complex &lhs, const Complex &rhs);
+// Makes T in the scalar overloads below a non-deduced parameter, so c * 2 converts 2 to the part type of c
+template<typename T>
+struct complex_identity { typedef T type; };
 
-std::istream & operator>>(std::istream & is, Complex &number);
-std::ostream & operator<<(std::ostream & os, const Complex &number);
+template<typename T>
+using complex_scalar_t = typename complex_identity<T>::type;
 
-constexpr Complex operator""_i(long double arg);
-constexpr Complex operator""_i(unsigned long long arg);
+// Non-member functions 
+template<typename T> constexpr BasicComplex<T> operator+(const BasicComplex<T> &number) noexcept;
+template<typename T> constexpr BasicComplex<T> operator-(const BasicComplex<T> &number) noexcept;
+
+template<typename T> constexpr BasicComplex<T> operator+(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator-(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator*(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator/(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs);
+template<typename T> constexpr BasicComplex<T> divide_unchecked(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+
+// Mixed with a real number, which skips the arithmetic on its zero imaginary part
+template<typename T> constexpr BasicComplex<T> operator+(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator+(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator-(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator-(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator*(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator*(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr BasicComplex<T> operator/(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs);
+template<typename T> constexpr BasicComplex<T> operator/(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs);
+
+template<typename T> constexpr bool operator==(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr bool operator!=(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+template<typename T> constexpr bool operator==(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept;
+template<typename T> constexpr bool operator!=(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept;
+
+template<typename T> constexpr T real(const BasicComplex<T> &number) noexcept;
+template<typename T> constexpr T imag(const BasicComplex<T> &number) noexcept;
+template<typename T> constexpr T norm(const BasicComplex<T> &number) noexcept;
+template<typename T> inline T abs(const BasicComplex<T> &number) noexcept;
+
+template<typename T> constexpr bool operator<(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept;
+
+// Transcendental functions for floating-point parts, with the branch cuts of std::complex
+template<typename T> inline T arg(const BasicComplex<T> &number) noexcept;
+template<typename T> inline BasicComplex<T> polar(T magnitude, T angle) noexcept;
+template<typename T> inline BasicComplex<T> exp(const BasicComplex<T> &number) noexcept;
+template<typename T> inline BasicComplex<T> log(const BasicComplex<T> &number) noexcept;
+template<typename T> inline BasicComplex<T> sqrt(const BasicComplex<T> &number) noexcept;
+template<typename T> inline BasicComplex<T> pow(const BasicComplex<T> &base, const BasicComplex<T> &exponent) noexcept;
+template<typename T> inline BasicComplex<T> pow(const BasicComplex<T> &base, const complex_scalar_t<T> &exponent) noexcept;
+template<typename T> inline BasicComplex<T> pow(const BasicComplex<T> &base, int exponent) noexcept;
+
+template<typename T> inline std::istream & operator>>(std::istream & is, BasicComplex<T> &number);
+template<typename T> inline std::ostream & operator<<(std::ostream & os, const BasicComplex<T> &number);
+
+constexpr Complex operator""_i(long double arg) noexcept;
+constexpr Complex operator""_i(unsigned long long arg) noexcept;
+constexpr ComplexF operator""_if(long double arg) noexcept;
+constexpr ComplexF operator""_if(unsigned long long arg) noexcept;
 
 /* Implementations of member functions */
 
+// Throw for division with 0, kept in its own noreturn function so the compiler treats it as the cold path
+[[noreturn]] inline void complex_division_by_zero(){
+    throw std::out_of_range("Invalid arguments. Cannot divide with 0!");
+}
+
 // CONSTRUCTORS
 // Standard constructors
-Complex::Complex() : re(0.0), im(0.0){}
-Complex::Complex(double real) : re(real), im(0.0){}
-constexpr Complex::Complex(double real, double imaginary) : re(real), im(imaginary){};
-
-// Copy constructor
-Complex::Complex(const Complex &rhs) : re{rhs.re}, im{rhs.im} {};
-
-// Copy assignment operator
-Complex &Complex::operator=(const Complex &other){
-    if(this != &other){
-        re = other.re;
-        im = other.im;
-    }
-    return *this;
-};
+template<typename T>
+constexpr BasicComplex<T>::BasicComplex() noexcept : re(0), im(0){}
+
+template<typename T>
+constexpr BasicComplex<T>::BasicComplex(T real) noexcept : re(real), im(0){}
+
+template<typename T>
+constexpr BasicComplex<T>::BasicComplex(T real, T imaginary) noexcept : re(real), im(imaginary){};
+
+// Conversion from another precision
+template<typename T>
+template<typename U>
+constexpr BasicComplex<T>::BasicComplex(const BasicComplex<U> &other) noexcept
+    : re(static_cast<T>(other.real())), im(static_cast<T>(other.imag())){}
 
 // ACCESSORS
 // Access real component
-double Complex::real() const{
+template<typename T>
+constexpr T BasicComplex<T>::real() const noexcept{
     return re;
 };
 
 // Access imaginary component
-double Complex::imag() const{
+template<typename T>
+constexpr T BasicComplex<T>::imag() const noexcept{
     return im;
 };
 
 // OPERATORS
-// These operators are chainable
+// These operators are chainable and work in place. other may be *this itself (c *= c),
+// so every part of other is read before the part of *this with the same name is written.
 
 // += operator
-Complex& Complex::operator+=(const Complex &other){
-    *this = *this + other;
+template<typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator+=(const BasicComplex &other) noexcept{
+    re += other.re;
+    im += other.im;
     return *this;
 };
 
 // -= operator
-Complex& Complex::operator-=(const Complex &other){
-    *this = *this - other;
+template<typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator-=(const BasicComplex &other) noexcept{
+    re -= other.re;
+    im -= other.im;
     return *this;
 };
 
 // *= operator
-Complex& Complex::operator*=(const Complex &other){
-    *this = *this * other;
+template<typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator*=(const BasicComplex &other) noexcept{
+    T realPart = (re * other.re) - (im * other.im);
+    im = (re * other.im) + (im * other.re);
+    re = realPart;
     return *this;
 };
 
-// /= operator
-Complex& Complex::operator/=(const Complex &other){
-    *this = *this / other;
+// /= operator, throws like operator/
+template<typename T>
+constexpr BasicComplex<T>& BasicComplex<T>::operator/=(const BasicComplex &other){
+    if(other.re == T(0) && other.im == T(0)){
+        complex_division_by_zero();
+    }
+    *this = divide_unchecked(*this, other);
     return *this;
 };
 
@@ -125,93 +197,334 @@ Complex& Complex::operator/=(const Complex &other){
 // ACCESSORS
 
 // Access real component
-double real(const Complex &number){
+template<typename T>
+constexpr T real(const BasicComplex<T> &number) noexcept{
     return number.real();
 };
 
 // Access imaginary component
-double imag(const Complex &number){
+template<typename T>
+constexpr T imag(const BasicComplex<T> &number) noexcept{
     return number.imag();
 };
 
-// Get the absolute value with formula sqrt(a^2+b^2)
-double abs(const Complex &number){
-    return sqrt(pow(number.real(),2) + pow(number.imag(),2)); 
+// Squared magnitude a^2+b^2, cheaper than abs when only comparing sizes
+template<typename T>
+constexpr T norm(const BasicComplex<T> &number) noexcept{
+    return number.real()*number.real() + number.imag()*number.imag();
+};
+
+// Get the absolute value sqrt(a^2+b^2) without overflow or underflow in a^2+b^2, like std::hypot.
+// The plain formula is exact enough whenever a^2+b^2 is a normal finite number, which is the common case;
+// otherwise the larger part is factored out: |a+bi| = big * sqrt(1 + (small/big)^2).
+// Fixed-point parts are converted to double, since a^2+b^2 easily leaves their range.
+template<typename T>
+inline T abs(const BasicComplex<T> &number) noexcept{
+    if constexpr(!std::is_floating_point<T>::value){
+        return T(std::hypot(static_cast<double>(number.real()), static_cast<double>(number.imag())));
+    } else {
+        const T squared = norm(number);
+        if(squared >= std::numeric_limits<T>::min() && squared <= std::numeric_limits<T>::max()){
+            return std::sqrt(squared);
+        }
+        const T a = std::fabs(number.real());
+        const T b = std::fabs(number.imag());
+        if(std::isinf(a) || std::isinf(b)){
+            return std::numeric_limits<T>::infinity(); // Even if the other part is nan
+        }
+        const T big = std::max(a, b);
+        const T small = std::min(a, b);
+        if(big == 0 || std::isnan(squared)){
+            return squared;     // 0 or nan
+        }
+        const T ratio = small / big;
+        return big * std::sqrt(1 + ratio * ratio);
+    }
 };
 
 // OPERATORS
 
 // Unary + for one complex number
-Complex operator+(const Complex &number){
+template<typename T>
+constexpr BasicComplex<T> operator+(const BasicComplex<T> &number) noexcept{
     return number;
 }
 
 // Unary - for one complex number
-Complex operator-(const Complex &number){
-    return Complex(-number.real(), -number.imag());
+template<typename T>
+constexpr BasicComplex<T> operator-(const BasicComplex<T> &number) noexcept{
+    return BasicComplex<T>(-number.real(), -number.imag());
 }
 
 // Addition of two complex numbers
-Complex operator+(const Complex &lhs, const Complex &rhs){
-    double realSum = lhs.real() + rhs.real();
-    double imagSum = lhs.imag() + rhs.imag();
-    return Complex(realSum,imagSum);
+template<typename T>
+constexpr BasicComplex<T> operator+(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    T realSum = lhs.real() + rhs.real();
+    T imagSum = lhs.imag() + rhs.imag();
+    return BasicComplex<T>(realSum,imagSum);
 };
 
 // Subtraction of two complex numbers
-Complex operator-(const Complex &lhs, const Complex &rhs){
-    double realDiff = lhs.real() - rhs.real();
-    double imagDiff = lhs.imag() - rhs.imag();
-    return Complex(realDiff,imagDiff);
+template<typename T>
+constexpr BasicComplex<T> operator-(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    T realDiff = lhs.real() - rhs.real();
+    T imagDiff = lhs.imag() - rhs.imag();
+    return BasicComplex<T>(realDiff,imagDiff);
 };
 
 // Multiplication of two complex numbers, with formula (a+bi)*(c+di) = (ac−bd)+(ad+bc)i
-Complex operator*(const Complex &lhs, const Complex &rhs){
-    double realPart = (lhs.real() * rhs.real()) - (lhs.imag() * rhs.imag());
-    double imagPart = (lhs.real() * rhs.imag()) + (lhs.imag() * rhs.real());
-    return Complex(realPart,imagPart);
-};
-
-// Division of two complex numbers, with formula (a+bi)/(c+di) = (ac+bd)/(c^2 + d^2) + (bc-ad)i/(c^2 + d^2)   
-Complex operator/(const Complex &lhs, const Complex &rhs){ 
-    double denominator = rhs.real()*rhs.real() + rhs.imag()*rhs.imag();
-    if(denominator != 0){
-        double realPart = (lhs.real() * rhs.real()) + (lhs.imag() * rhs.imag());
-        double imagPart = (lhs.imag() * rhs.real()) - (lhs.real() * rhs.imag());
-        return Complex(realPart/denominator,imagPart/denominator);
+template<typename T>
+constexpr BasicComplex<T> operator*(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    T realPart = (lhs.real() * rhs.real()) - (lhs.imag() * rhs.imag());
+    T imagPart = (lhs.real() * rhs.imag()) + (lhs.imag() * rhs.real());
+    return BasicComplex<T>(realPart,imagPart);
+};
+
+// Division of two complex numbers, see divide_unchecked
+// Throws std::out_of_range when dividing with 0
+template<typename T>
+constexpr BasicComplex<T> operator/(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs){ 
+    BasicComplex<T> quotient(lhs);
+    quotient /= rhs;
+    return quotient;
+};
+
+// Smith's algorithm for (a+bi)/(c+di): dividing through by the larger of c and d keeps every intermediate near
+// the size of the result. With r = d/c if |c| >= |d|, else r = c/d:
+// (a+bi)/(c+di) = ((a+br) + (b-ar)i)/(c+dr) if |c| >= |d|, else ((ar+b) + (br-a)i)/(cr+d).
+template<typename T>
+constexpr BasicComplex<T> complex_divide_smith(T a, T b, T c, T d) noexcept{
+    if(((c < T(0)) ? -c : c) >= ((d < T(0)) ? -d : d)){
+        const T r = d / c;
+        const T denominator = c + d * r;
+        return BasicComplex<T>((a + b * r) / denominator, (b - a * r) / denominator);
+    }
+    const T r = c / d;
+    const T denominator = c * r + d;
+    return BasicComplex<T>((a * r + b) / denominator, (b * r - a) / denominator);
+}
+
+// Division without the zero check, for loops that must not throw. Dividing with 0 gives nan parts instead.
+// The formula (a+bi)/(c+di) = ((ac+bd) + (bc-ad)i)/(c^2+d^2) is used whenever c^2+d^2 is a normal number and
+// the quotient is finite. Otherwise an intermediate over- or underflowed even though the quotient may well be
+// representable (for double, c^2+d^2 overflows once |c+di| passes 1e154), and Smith's algorithm is used instead.
+// The fallback is rare, so its branch is almost always predicted correctly. Fixed-point types always use
+// Smith's algorithm, which keeps the intermediates in range.
+template<typename T>
+constexpr BasicComplex<T> divide_unchecked(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    const T a = lhs.real();
+    const T b = lhs.imag();
+    const T c = rhs.real();
+    const T d = rhs.imag();
+    if constexpr(!std::is_floating_point<T>::value){
+        return complex_divide_smith(a, b, c, d);
+    } else {
+        const T denominator = c*c + d*d;
+        const T realPart = (a*c + b*d) / denominator;
+        const T imagPart = (b*c - a*d) / denominator;
+        constexpr T smallest = std::numeric_limits<T>::min();
+        constexpr T largest = std::numeric_limits<T>::max();
+        if(denominator >= smallest && denominator <= largest && realPart >= -largest && realPart <= largest &&
+           imagPart >= -largest && imagPart <= largest){
+            return BasicComplex<T>(realPart, imagPart);
+        }
+        return complex_divide_smith(a, b, c, d);
     }
-    throw std::out_of_range("Invalid arguments. Cannot divide with 0!");    
 };
 
+// Addition of a complex and a real number
+template<typename T>
+constexpr BasicComplex<T> operator+(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs.real() + rhs, lhs.imag());
+}
+
+// Addition of a real and a complex number
+template<typename T>
+constexpr BasicComplex<T> operator+(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs + rhs.real(), rhs.imag());
+}
+
+// Subtraction of a real number from a complex number
+template<typename T>
+constexpr BasicComplex<T> operator-(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs.real() - rhs, lhs.imag());
+}
+
+// Subtraction of a complex number from a real number
+template<typename T>
+constexpr BasicComplex<T> operator-(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs - rhs.real(), -rhs.imag());
+}
+
+// Multiplication of a complex and a real number
+template<typename T>
+constexpr BasicComplex<T> operator*(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs.real() * rhs, lhs.imag() * rhs);
+}
+
+// Multiplication of a real and a complex number
+template<typename T>
+constexpr BasicComplex<T> operator*(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    return BasicComplex<T>(lhs * rhs.real(), lhs * rhs.imag());
+}
+
+// Division of a complex number by a real number, throws std::out_of_range when dividing with 0
+template<typename T>
+constexpr BasicComplex<T> operator/(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs){
+    if(rhs == T(0)){
+        complex_division_by_zero();
+    }
+    return BasicComplex<T>(lhs.real() / rhs, lhs.imag() / rhs);
+}
+
+// Division of a real number by a complex number, throws std::out_of_range when dividing with 0
+template<typename T>
+constexpr BasicComplex<T> operator/(const complex_scalar_t<T> &lhs, const BasicComplex<T> &rhs){
+    return BasicComplex<T>(lhs) / rhs;
+}
+
 // Equality operator
-bool operator==(const Complex &lhs, const Complex &rhs){
-    if(lhs.real() == rhs.real() && lhs.imag() == rhs.imag()){
-        return true;
-    } 
-    return false;
+template<typename T>
+constexpr bool operator==(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    return lhs.real() == rhs.real() && lhs.imag() == rhs.imag();
 };
 
 // Not equal operator
-bool operator!=(const Complex &lhs, const Complex &rhs){
+template<typename T>
+constexpr bool operator!=(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    return !(lhs == rhs);
+};
+
+// Equality with a real number
+template<typename T>
+constexpr bool operator==(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept{
+    return lhs.real() == rhs && lhs.imag() == T(0);
+};
+
+// Not equal to a real number
+template<typename T>
+constexpr bool operator!=(const BasicComplex<T> &lhs, const complex_scalar_t<T> &rhs) noexcept{
     return !(lhs == rhs);
 };
 
-// Less than operator
-bool operator<(const Complex &lhs, const Complex &rhs){
-    if(abs(lhs) < abs(rhs)){
-        return true;
+// Less than operator, compares magnitudes through norm since sqrt does not change the order. When a norm is
+// not a normal finite number, a^2+b^2 overflowed or underflowed (|z| beyond about 1e154 or below 1e-154 for
+// double) and would tie with every other such number, so abs, which scales before squaring, decides instead.
+template<typename T>
+constexpr bool operator<(const BasicComplex<T> &lhs, const BasicComplex<T> &rhs) noexcept{
+    if constexpr(std::is_floating_point<T>::value){
+        const T lhsNorm = norm(lhs);
+        const T rhsNorm = norm(rhs);
+        const T low = std::numeric_limits<T>::min();
+        const T high = std::numeric_limits<T>::max();
+        if(lhsNorm >= low && lhsNorm <= high && rhsNorm >= low && rhsNorm <= high){
+            return lhsNorm < rhsNorm;
+        }
+        return abs(lhs) < abs(rhs);
+    } else {
+        return norm(lhs) < norm(rhs); // FixedPoint.h has an exact version for fixed-point parts
     }
-    return false;
 };
 
+// TRANSCENDENTAL FUNCTIONS
+
+// Angle from the positive real axis, in (-pi, pi]
+template<typename T>
+inline T arg(const BasicComplex<T> &number) noexcept{
+    return std::atan2(number.imag(), number.real());
+}
+
+// Number with the given magnitude and angle, r(cos t + i sin t)
+template<typename T>
+inline BasicComplex<T> polar(T magnitude, T angle) noexcept{
+    return BasicComplex<T>(magnitude * std::cos(angle), magnitude * std::sin(angle));
+}
+
+// e^(a+bi) = e^a (cos b + i sin b). A real argument stays real, also when e^a overflows (inf * sin 0 is nan).
+template<typename T>
+inline BasicComplex<T> exp(const BasicComplex<T> &number) noexcept{
+    const T magnitude = std::exp(number.real());
+    if(number.imag() == 0){
+        return BasicComplex<T>(magnitude, number.imag());
+    }
+    return polar(magnitude, number.imag());
+}
+
+// Principal logarithm, log|z| + i arg(z); log(0) is -inf
+template<typename T>
+inline BasicComplex<T> log(const BasicComplex<T> &number) noexcept{
+    return BasicComplex<T>(std::log(abs(number)), arg(number));
+}
+
+// Principal square root, with a non-negative real part. With t = sqrt((|a| + |z|) / 2):
+// sqrt(a+bi) = t + (b/2t)i if a >= 0, else |b|/2t + t i with the sign of b. Neither part is computed through a
+// difference of nearly equal numbers, so both keep full precision.
+template<typename T>
+inline BasicComplex<T> sqrt(const BasicComplex<T> &number) noexcept{
+    const T a = number.real();
+    const T b = number.imag();
+    if(a == 0 && b == 0){
+        return BasicComplex<T>(0, b);
+    }
+    // 2(|a| + |z|) is exact where halving would lose the last bit of a subnormal sum, but may overflow
+    const T magnitude = abs(number);
+    const T t = (magnitude < std::numeric_limits<T>::max() / 4) ? T(0.5) * std::sqrt(2 * (std::fabs(a) + magnitude))
+                                                                 : std::sqrt(T(0.5) * std::fabs(a) + T(0.5) * magnitude);
+    if(a >= 0){
+        return BasicComplex<T>(t, b / (2 * t));
+    }
+    return BasicComplex<T>(std::fabs(b) / (2 * t), std::copysign(t, b));
+}
+
+// base^exponent = e^(exponent log(base)); 0^w is 1 for w = 0 and 0 for w with a positive real part
+template<typename T>
+inline BasicComplex<T> pow(const BasicComplex<T> &base, const BasicComplex<T> &exponent) noexcept{
+    if(base.real() == 0 && base.imag() == 0){
+        if(exponent.real() == 0 && exponent.imag() == 0){
+            return BasicComplex<T>(1);
+        }
+        if(exponent.real() > 0){
+            return BasicComplex<T>();
+        }
+    }
+    return exp(exponent * log(base));
+}
+
+// base^x = |base|^x (cos(x arg) + i sin(x arg)) for a real x, more accurate than going through log
+template<typename T>
+inline BasicComplex<T> pow(const BasicComplex<T> &base, const complex_scalar_t<T> &exponent) noexcept{
+    if(base.real() == 0 && base.imag() == 0 && exponent > 0){
+        return BasicComplex<T>();
+    }
+    return polar(std::pow(abs(base), exponent), exponent * arg(base));
+}
+
+// base^n by repeated squaring: exact for small n where the products are, and no transcendental calls
+template<typename T>
+inline BasicComplex<T> pow(const BasicComplex<T> &base, int exponent) noexcept{
+    BasicComplex<T> result(1);
+    BasicComplex<T> square(base);
+    unsigned int n = (exponent < 0) ? 0u - static_cast<unsigned int>(exponent) : static_cast<unsigned int>(exponent);
+    while(n != 0){
+        if(n & 1u){
+            result *= square;
+        }
+        square *= square;
+        n >>= 1;
+    }
+    return (exponent < 0) ? divide_unchecked(BasicComplex<T>(1), result) : result;
+}
+
 // Output operator
-std::ostream & operator<<(std::ostream & os, const Complex &number){
+template<typename T>
+inline std::ostream & operator<<(std::ostream & os, const BasicComplex<T> &number){
     os << "(" << number.real() << "," << number.imag() << ")";
     return os;
 };
 
-// Input operator
-std::istream & operator>>(std::istream & is, Complex &number){
+// Input operator, the parts are read as double and converted to T
+template<typename T>
+inline std::istream & operator>>(std::istream & is, BasicComplex<T> &number){
     std::string line;
     double realPart = 0.0;
     double imagPart = 0.0;
@@ -228,19 +541,29 @@ std::istream & operator>>(std::istream & is, Complex &number){
         numberIS.ignore();  // Comma in (real,imaginary) is ignored
         numberIS >> imagPart; 
     }
-    number = Complex(realPart, imagPart);
+    number = BasicComplex<T>(static_cast<T>(realPart), static_cast<T>(imagPart));
 
     return is;
 };
 
 // double_i  literal form
-constexpr Complex operator""_i(long double arg) {
+constexpr Complex operator""_i(long double arg) noexcept{
     return Complex(0.0, static_cast<double>(arg));
 }
 
 // wholeNumber_i  literal form
-constexpr Complex operator""_i(unsigned long long arg) {
+constexpr Complex operator""_i(unsigned long long arg) noexcept{
     return Complex(0.0, static_cast<double>(arg));
 }
 
+// float_if  literal form
+constexpr ComplexF operator""_if(long double arg) noexcept{
+    return ComplexF(0.0f, static_cast<float>(arg));
+}
+
+// wholeNumber_if  literal form
+constexpr ComplexF operator""_if(unsigned long long arg) noexcept{
+    return ComplexF(0.0f, static_cast<float>(arg));
+}
+
 #endif //COMPLEX_H
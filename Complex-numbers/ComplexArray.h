@@ -0,0 +1,571 @@
+/*
+* Array of complex numbers stored as separate real and imaginary planes
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COMPLEXARRAY_H
+#define COMPLEXARRAY_H
+
+#include "Complex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+// Structure-of-arrays storage: all real parts in one 64-byte aligned plane and all imaginary parts in another.
+// Every element-wise loop then reads and writes whole vector registers of real or imaginary parts, with no
+// shuffling of interleaved (re, im) pairs, so GCC/Clang vectorize them at full SIMD width at -O2/-O3.
+// Use std::vector<Complex> for code that handles one number at a time and ComplexArray for bulk arithmetic.
+class ComplexArray {
+public:
+    // constructors, assignment operators and destructor
+    ComplexArray();
+    explicit ComplexArray(size_t size);
+    ComplexArray(size_t size, const Complex & value);
+    ComplexArray(const std::initializer_list<Complex> & list);
+    explicit ComplexArray(const std::vector<Complex> & numbers);
+
+    ComplexArray(const ComplexArray & other);
+    ComplexArray(ComplexArray && other) noexcept;
+    ComplexArray & operator=(const ComplexArray & other);
+    ComplexArray & operator=(ComplexArray && other) noexcept;
+    ~ComplexArray();
+
+    // accessors
+    size_t size() const;
+    bool empty() const;
+
+    Complex operator[](size_t index) const;
+    void set(size_t index, const Complex & value);
+
+    double * real_data();
+    const double * real_data() const;
+    double * imag_data();
+    const double * imag_data() const;
+
+    std::vector<Complex> to_vector() const;
+
+    // element-wise operators, the arrays must have the same size
+    ComplexArray & operator+=(const ComplexArray & other);
+    ComplexArray & operator-=(const ComplexArray & other);
+    ComplexArray & operator*=(const ComplexArray & other);
+    ComplexArray & operator/=(const ComplexArray & other);
+
+    // scaling of every element
+    ComplexArray & operator*=(double factor);
+    ComplexArray & operator*=(const Complex & factor);
+
+    // methods
+    void conjugate();
+
+private:
+    void check_size(const ComplexArray & other) const;
+
+    size_t m_size;
+    double * m_re;  // Both planes live in one allocation, m_im starts at the next 64-byte boundary after m_re
+    double * m_im;
+};
+
+ComplexArray operator+(const ComplexArray & lhs, const ComplexArray & rhs);
+ComplexArray operator-(const ComplexArray & lhs, const ComplexArray & rhs);
+ComplexArray operator*(const ComplexArray & lhs, const ComplexArray & rhs);
+ComplexArray operator/(const ComplexArray & lhs, const ComplexArray & rhs);
+ComplexArray divide_unchecked(const ComplexArray & lhs, const ComplexArray & rhs);
+ComplexArray operator*(const ComplexArray & lhs, double factor);
+ComplexArray operator*(double factor, const ComplexArray & rhs);
+ComplexArray operator*(const ComplexArray & lhs, const Complex & factor);
+ComplexArray operator*(const Complex & factor, const ComplexArray & rhs);
+
+ComplexArray conj(const ComplexArray & numbers);
+std::vector<double> abs(const ComplexArray & numbers);
+
+// reductions
+Complex sum(const ComplexArray & numbers);
+Complex dot(const ComplexArray & lhs, const ComplexArray & rhs);
+Complex dotc(const ComplexArray & lhs, const ComplexArray & rhs);
+
+bool operator==(const ComplexArray & lhs, const ComplexArray & rhs);
+bool operator!=(const ComplexArray & lhs, const ComplexArray & rhs);
+
+//
+// Implementations
+//
+
+// Doubles per 64 bytes, the alignment of both planes
+constexpr size_t complex_array_lanes = 64 / sizeof(double);
+
+// Number of partial sums kept by the reductions. Floating point addition is not associative, so the compiler
+// may not split a single running sum across vector lanes by itself; keeping this many independent sums lets it.
+constexpr size_t complex_array_partials = 16;
+
+// Room for one plane of size doubles, rounded up so the next plane stays aligned
+inline size_t complex_array_stride(size_t size) {
+    return (size + complex_array_lanes - 1) / complex_array_lanes * complex_array_lanes;
+}
+
+// Aligned storage for both planes, nullptr for an empty array
+inline double * complex_array_allocate(size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    return static_cast<double *>(::operator new(2 * complex_array_stride(size) * sizeof(double), std::align_val_t(64)));
+}
+
+// Release storage from complex_array_allocate
+inline void complex_array_free(double * data) {
+    if (data != nullptr) {
+        ::operator delete(data, std::align_val_t(64));
+    }
+}
+
+// CONSTRUCTORS
+
+// Empty array
+inline ComplexArray::ComplexArray() : m_size(0), m_re(nullptr), m_im(nullptr) {}
+
+// size zeroes
+inline ComplexArray::ComplexArray(size_t size) : ComplexArray(size, Complex()) {}
+
+// size copies of value
+inline ComplexArray::ComplexArray(size_t size, const Complex & value) : m_size(size), m_re(complex_array_allocate(size)),
+                                                                      m_im(m_re + complex_array_stride(size)) {
+    for (size_t i = 0; i < m_size; i++) {
+        m_re[i] = value.real();
+        m_im[i] = value.imag();
+    }
+}
+
+// Array from a list
+inline ComplexArray::ComplexArray(const std::initializer_list<Complex> & list) : ComplexArray(std::vector<Complex>(list)) {}
+
+// Split interleaved numbers into the two planes
+inline ComplexArray::ComplexArray(const std::vector<Complex> & numbers) : m_size(numbers.size()), m_re(complex_array_allocate(m_size)),
+                                                                         m_im(m_re + complex_array_stride(m_size)) {
+    for (size_t i = 0; i < m_size; i++) {
+        m_re[i] = numbers[i].real();
+        m_im[i] = numbers[i].imag();
+    }
+}
+
+// Copy constructor
+inline ComplexArray::ComplexArray(const ComplexArray & other) : m_size(other.m_size), m_re(complex_array_allocate(m_size)),
+                                                               m_im(m_re + complex_array_stride(m_size)) {
+    std::copy(other.m_re, other.m_re + m_size, m_re);
+    std::copy(other.m_im, other.m_im + m_size, m_im);
+}
+
+// Move constructor
+inline ComplexArray::ComplexArray(ComplexArray && other) noexcept : m_size(other.m_size), m_re(other.m_re), m_im(other.m_im) {
+    other.m_size = 0;
+    other.m_re = nullptr;
+    other.m_im = nullptr;
+}
+
+// Copy assignment operator
+inline ComplexArray & ComplexArray::operator=(const ComplexArray & other) {
+    if (this != &other) {
+        *this = ComplexArray(other);
+    }
+    return *this;
+}
+
+// Move assignment operator
+inline ComplexArray & ComplexArray::operator=(ComplexArray && other) noexcept {
+    if (this != &other) {
+        complex_array_free(m_re);
+        m_size = other.m_size;
+        m_re = other.m_re;
+        m_im = other.m_im;
+        other.m_size = 0;
+        other.m_re = nullptr;
+        other.m_im = nullptr;
+    }
+    return *this;
+}
+
+// Destructor
+inline ComplexArray::~ComplexArray() {
+    complex_array_free(m_re);
+}
+
+// ACCESSORS
+
+// Number of elements
+inline size_t ComplexArray::size() const {
+    return m_size;
+}
+
+// True if there are no elements
+inline bool ComplexArray::empty() const {
+    return m_size == 0;
+}
+
+// Element at index, assembled from both planes. There is no reference to return, so use set to change it.
+inline Complex ComplexArray::operator[](size_t index) const {
+    if (index >= m_size) {
+        throw std::out_of_range("Invalid arguments. Index out of range!");
+    }
+    return Complex(m_re[index], m_im[index]);
+}
+
+// Change the element at index
+inline void ComplexArray::set(size_t index, const Complex & value) {
+    if (index >= m_size) {
+        throw std::out_of_range("Invalid arguments. Index out of range!");
+    }
+    m_re[index] = value.real();
+    m_im[index] = value.imag();
+}
+
+// Plane of real parts, 64-byte aligned
+inline double * ComplexArray::real_data() {
+    return m_re;
+}
+
+// Plane of real parts - read only version
+inline const double * ComplexArray::real_data() const {
+    return m_re;
+}
+
+// Plane of imaginary parts, 64-byte aligned
+inline double * ComplexArray::imag_data() {
+    return m_im;
+}
+
+// Plane of imaginary parts - read only version
+inline const double * ComplexArray::imag_data() const {
+    return m_im;
+}
+
+// Interleave the planes back into Complex numbers
+inline std::vector<Complex> ComplexArray::to_vector() const {
+    std::vector<Complex> numbers(m_size);
+    for (size_t i = 0; i < m_size; i++) {
+        numbers[i] = Complex(m_re[i], m_im[i]);
+    }
+    return numbers;
+}
+
+// OPERATORS
+
+// Element-wise += operator
+inline ComplexArray & ComplexArray::operator+=(const ComplexArray & other) {
+    check_size(other);
+    const double * re = other.m_re;
+    const double * im = other.m_im;
+    for (size_t i = 0; i < m_size; i++) {
+        m_re[i] += re[i];
+        m_im[i] += im[i];
+    }
+    return *this;
+}
+
+// Element-wise -= operator
+inline ComplexArray & ComplexArray::operator-=(const ComplexArray & other) {
+    check_size(other);
+    const double * re = other.m_re;
+    const double * im = other.m_im;
+    for (size_t i = 0; i < m_size; i++) {
+        m_re[i] -= re[i];
+        m_im[i] -= im[i];
+    }
+    return *this;
+}
+
+// Element-wise *= operator, (a+bi)*(c+di) = (ac−bd)+(ad+bc)i
+inline ComplexArray & ComplexArray::operator*=(const ComplexArray & other) {
+    check_size(other);
+    const double * re = other.m_re;
+    const double * im = other.m_im;
+    for (size_t i = 0; i < m_size; i++) {
+        // Load both operands first, other may be *this
+        const double a = m_re[i];
+        const double b = m_im[i];
+        const double c = re[i];
+        const double d = im[i];
+        m_re[i] = a * c - b * d;
+        m_im[i] = a * d + b * c;
+    }
+    return *this;
+}
+
+// (re + im i) = (a + bi) / (c + di) element-wise, equal to divide_unchecked on each Complex. Blocks of elements
+// are divided with the plain formula in a vectorized loop that also counts where it over- or underflowed; only
+// such a block is redone with divide_unchecked. Results go through a block buffer, so re, im may be a, b.
+inline void complex_array_divide(const double * a, const double * b, const double * c, const double * d,
+                                 double * re, double * im, size_t n) {
+    constexpr size_t block = 256;
+    constexpr double smallest = std::numeric_limits<double>::min();
+    constexpr double largest = std::numeric_limits<double>::max();
+    double blockRe[block];
+    double blockIm[block];
+    for (size_t start = 0; start < n; start += block) {
+        const size_t count = std::min(block, n - start);
+        size_t unsafe = 0;
+        for (size_t i = 0; i < count; i++) {
+            const size_t j = start + i;
+            const double denominator = c[j] * c[j] + d[j] * d[j];
+            const double realPart = (a[j] * c[j] + b[j] * d[j]) / denominator;
+            const double imagPart = (b[j] * c[j] - a[j] * d[j]) / denominator;
+            unsafe += !((denominator >= smallest) & (denominator <= largest) & (std::fabs(realPart) <= largest) &
+                        (std::fabs(imagPart) <= largest));
+            blockRe[i] = realPart;
+            blockIm[i] = imagPart;
+        }
+        if (unsafe != 0) {
+            for (size_t i = 0; i < count; i++) {
+                const size_t j = start + i;
+                const Complex quotient = divide_unchecked(Complex(a[j], b[j]), Complex(c[j], d[j]));
+                blockRe[i] = quotient.real();
+                blockIm[i] = quotient.imag();
+            }
+        }
+        std::copy(blockRe, blockRe + count, re + start);
+        std::copy(blockIm, blockIm + count, im + start);
+    }
+}
+
+// Element-wise /= operator. Throws if any element of other is 0, in which case *this is left unchanged.
+// The zero check is a separate pass so the division loop itself has no branch.
+inline ComplexArray & ComplexArray::operator/=(const ComplexArray & other) {
+    check_size(other);
+    const double * re = other.m_re;
+    const double * im = other.m_im;
+    size_t zeros = 0;
+    for (size_t i = 0; i < m_size; i++) {
+        zeros += (re[i] == 0.0) & (im[i] == 0.0);
+    }
+    if (zeros != 0) {
+        throw std::out_of_range("Invalid arguments. Cannot divide with 0!");
+    }
+    complex_array_divide(m_re, m_im, re, im, m_re, m_im, m_size);
+    return *this;
+}
+
+// Multiply every element with a real factor
+inline ComplexArray & ComplexArray::operator*=(double factor) {
+    for (size_t i = 0; i < m_size; i++) {
+        m_re[i] *= factor;
+        m_im[i] *= factor;
+    }
+    return *this;
+}
+
+// Multiply every element with a complex factor
+inline ComplexArray & ComplexArray::operator*=(const Complex & factor) {
+    const double c = factor.real();
+    const double d = factor.imag();
+    for (size_t i = 0; i < m_size; i++) {
+        double a = m_re[i];
+        double b = m_im[i];
+        m_re[i] = a * c - b * d;
+        m_im[i] = a * d + b * c;
+    }
+    return *this;
+}
+
+// Element-wise sum
+inline ComplexArray operator+(const ComplexArray & lhs, const ComplexArray & rhs) {
+    ComplexArray result(lhs);
+    return result += rhs;
+}
+
+// Element-wise difference
+inline ComplexArray operator-(const ComplexArray & lhs, const ComplexArray & rhs) {
+    ComplexArray result(lhs);
+    return result -= rhs;
+}
+
+// Element-wise product
+inline ComplexArray operator*(const ComplexArray & lhs, const ComplexArray & rhs) {
+    ComplexArray result(lhs);
+    return result *= rhs;
+}
+
+// Element-wise quotient, throws if any element of rhs is 0
+inline ComplexArray operator/(const ComplexArray & lhs, const ComplexArray & rhs) {
+    ComplexArray result(lhs);
+    return result /= rhs;
+}
+
+// Element-wise quotient without the zero check, elements divided by 0 get inf/nan parts as with Complex
+inline ComplexArray divide_unchecked(const ComplexArray & lhs, const ComplexArray & rhs) {
+    if (lhs.size() != rhs.size()) {
+        throw std::out_of_range("Invalid arguments. Array sizes differ!");
+    }
+    ComplexArray result(lhs.size());
+    const double * a = lhs.real_data();
+    const double * b = lhs.imag_data();
+    const double * c = rhs.real_data();
+    const double * d = rhs.imag_data();
+    double * re = result.real_data();
+    double * im = result.imag_data();
+    complex_array_divide(a, b, c, d, re, im, lhs.size());
+    return result;
+}
+
+// Every element scaled with a real factor
+inline ComplexArray operator*(const ComplexArray & lhs, double factor) {
+    ComplexArray result(lhs);
+    return result *= factor;
+}
+
+// Every element scaled with a real factor
+inline ComplexArray operator*(double factor, const ComplexArray & rhs) {
+    return rhs * factor;
+}
+
+// Every element scaled with a complex factor
+inline ComplexArray operator*(const ComplexArray & lhs, const Complex & factor) {
+    ComplexArray result(lhs);
+    return result *= factor;
+}
+
+// Every element scaled with a complex factor
+inline ComplexArray operator*(const Complex & factor, const ComplexArray & rhs) {
+    return rhs * factor;
+}
+
+// Equal if the sizes and all elements are equal
+inline bool operator==(const ComplexArray & lhs, const ComplexArray & rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    return std::equal(lhs.real_data(), lhs.real_data() + lhs.size(), rhs.real_data()) &&
+           std::equal(lhs.imag_data(), lhs.imag_data() + lhs.size(), rhs.imag_data());
+}
+
+// Not equal operator
+inline bool operator!=(const ComplexArray & lhs, const ComplexArray & rhs) {
+    return !(lhs == rhs);
+}
+
+// FUNCTIONS
+
+// Negate every imaginary part
+inline void ComplexArray::conjugate() {
+    for (size_t i = 0; i < m_size; i++) {
+        m_im[i] = -m_im[i];
+    }
+}
+
+// Throw unless other has as many elements as this array
+inline void ComplexArray::check_size(const ComplexArray & other) const {
+    if (m_size != other.m_size) {
+        throw std::out_of_range("Invalid arguments. Array sizes differ!");
+    }
+}
+
+// Complex conjugate of every element
+inline ComplexArray conj(const ComplexArray & numbers) {
+    ComplexArray result(numbers);
+    result.conjugate();
+    return result;
+}
+
+// Absolute value of every element, equal to abs of each Complex. The vectorized pass takes sqrt(a^2+b^2) and
+// counts the elements where a^2+b^2 over- or underflowed; only if there are any, a second pass redoes those.
+inline std::vector<double> abs(const ComplexArray & numbers) {
+    const size_t n = numbers.size();
+    std::vector<double> result(n);
+    const double * re = numbers.real_data();
+    const double * im = numbers.imag_data();
+    double * out = result.data();
+    size_t unsafe = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double squared = re[i] * re[i] + im[i] * im[i];
+        unsafe += !((squared >= std::numeric_limits<double>::min()) & (squared <= std::numeric_limits<double>::max()));
+        out[i] = std::sqrt(squared);
+    }
+    if (unsafe != 0) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = abs(Complex(re[i], im[i]));
+        }
+    }
+    return result;
+}
+
+// Sum of all elements
+inline Complex sum(const ComplexArray & numbers) {
+    const double * re = numbers.real_data();
+    const double * im = numbers.imag_data();
+    const size_t n = numbers.size();
+    const size_t blocked = n / complex_array_partials * complex_array_partials;
+    double sumRe[complex_array_partials] = {};
+    double sumIm[complex_array_partials] = {};
+    for (size_t i = 0; i < blocked; i += complex_array_partials) {
+        for (size_t j = 0; j < complex_array_partials; j++) {
+            sumRe[j] += re[i + j];
+            sumIm[j] += im[i + j];
+        }
+    }
+    for (size_t i = blocked; i < n; i++) {
+        sumRe[0] += re[i];
+        sumIm[0] += im[i];
+    }
+    Complex total;
+    for (size_t j = 0; j < complex_array_partials; j++) {
+        total += Complex(sumRe[j], sumIm[j]);
+    }
+    return total;
+}
+
+// Sum of lhs[i] * rhs[i], or of conj(lhs[i]) * rhs[i] when conjugate is set
+inline Complex complex_array_dot(const ComplexArray & lhs, const ComplexArray & rhs, bool conjugate) {
+    if (lhs.size() != rhs.size()) {
+        throw std::out_of_range("Invalid arguments. Array sizes differ!");
+    }
+    const double * a = lhs.real_data();
+    const double * b = lhs.imag_data();
+    const double * c = rhs.real_data();
+    const double * d = rhs.imag_data();
+    const double sign = conjugate ? -1.0 : 1.0;
+    const size_t n = lhs.size();
+    const size_t blocked = n / complex_array_partials * complex_array_partials;
+    // Real and imaginary parts are accumulated as ac, bd, ad and bc so the sign is applied once at the end
+    double ac[complex_array_partials] = {};
+    double bd[complex_array_partials] = {};
+    double ad[complex_array_partials] = {};
+    double bc[complex_array_partials] = {};
+    for (size_t i = 0; i < blocked; i += complex_array_partials) {
+        for (size_t j = 0; j < complex_array_partials; j++) {
+            ac[j] += a[i + j] * c[i + j];
+            bd[j] += b[i + j] * d[i + j];
+            ad[j] += a[i + j] * d[i + j];
+            bc[j] += b[i + j] * c[i + j];
+        }
+    }
+    for (size_t i = blocked; i < n; i++) {
+        ac[0] += a[i] * c[i];
+        bd[0] += b[i] * d[i];
+        ad[0] += a[i] * d[i];
+        bc[0] += b[i] * c[i];
+    }
+    double sumAc = 0, sumBd = 0, sumAd = 0, sumBc = 0;
+    for (size_t j = 0; j < complex_array_partials; j++) {
+        sumAc += ac[j];
+        sumBd += bd[j];
+        sumAd += ad[j];
+        sumBc += bc[j];
+    }
+    return Complex(sumAc - sign * sumBd, sumAd + sign * sumBc);
+}
+
+// Sum of lhs[i] * rhs[i]
+inline Complex dot(const ComplexArray & lhs, const ComplexArray & rhs) {
+    return complex_array_dot(lhs, rhs, false);
+}
+
+// Sum of conj(lhs[i]) * rhs[i], the inner product
+inline Complex dotc(const ComplexArray & lhs, const ComplexArray & rhs) {
+    return complex_array_dot(lhs, rhs, true);
+}
+
+#endif //COMPLEXARRAY_H
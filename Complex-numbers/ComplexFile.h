@@ -0,0 +1,591 @@
+/*
+* Binary files of complex samples
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COMPLEXFILE_H
+#define COMPLEXFILE_H
+
+#include "Complex.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COMPLEX_FILE_MMAP
+#endif
+
+// File format: a 32-byte ComplexFileHeader followed by the samples, in the byte order of the machine that wrote
+// them (recorded in the header, reading a file of the other byte order throws).
+//   Interleaved: re0 im0 re1 im1 ...   Planar: re0 re1 ... re(n-1) im0 im1 ... im(n-1)
+// Parts are stored as float or double. An interleaved double file holds exactly the bytes of a Complex array,
+// so it is read and written without conversion and can be memory-mapped as Complex numbers.
+
+enum class ComplexLayout : uint8_t {
+    Interleaved = 0,
+    Planar = 1
+};
+
+enum class ComplexPrecision : uint8_t {
+    Float32 = 4,    // Value is the size of one part in bytes
+    Float64 = 8
+};
+
+struct ComplexFileHeader {
+    char magic[4] = {'C', 'P', 'L', 'X'};
+    uint16_t version = 1;
+    uint16_t byte_order = 0x0102;   // Reads as 0x0201 on a machine of the other byte order
+    ComplexLayout layout = ComplexLayout::Interleaved;
+    ComplexPrecision precision = ComplexPrecision::Float64;
+    uint8_t reserved[6] = {};
+    uint64_t count = 0;             // Number of complex samples
+    uint64_t reserved2 = 0;
+};
+
+// Writes samples in chunks. Interleaved files may be written without knowing the count, the header is completed
+// by close(). Planar files need the count up front, since the imaginary plane starts after the real one.
+class ComplexFileWriter {
+public:
+    explicit ComplexFileWriter(const std::string & path, ComplexLayout layout = ComplexLayout::Interleaved,
+                               ComplexPrecision precision = ComplexPrecision::Float64, uint64_t count = 0);
+    ~ComplexFileWriter();
+
+    ComplexFileWriter(const ComplexFileWriter &) = delete;
+    ComplexFileWriter & operator=(const ComplexFileWriter &) = delete;
+
+    void write(const Complex * samples, size_t count);
+    void write(const std::vector<Complex> & samples);
+    void close();
+
+    uint64_t written() const;
+
+private:
+    void put(const void * data, size_t bytes, uint64_t offset);
+
+    std::FILE * m_file;
+    uint64_t m_position;    // Tracked here, ftell may cost a system call
+    ComplexFileHeader m_header;
+    uint64_t m_written;
+};
+
+// Reads samples in chunks, converting float files to double
+class ComplexFileReader {
+public:
+    explicit ComplexFileReader(const std::string & path);
+    ~ComplexFileReader();
+
+    ComplexFileReader(const ComplexFileReader &) = delete;
+    ComplexFileReader & operator=(const ComplexFileReader &) = delete;
+
+    const ComplexFileHeader & header() const;
+    uint64_t size() const;
+    uint64_t remaining() const;
+
+    size_t read(Complex * samples, size_t count);
+    std::vector<Complex> read_all();
+
+private:
+    void get(void * data, size_t bytes, uint64_t offset);
+
+    std::FILE * m_file;
+    uint64_t m_position;    // Tracked here, ftell may cost a system call
+    ComplexFileHeader m_header;
+    uint64_t m_read;
+};
+
+// Read-only view of an interleaved double file as Complex numbers. Where mmap is available the samples are
+// mapped, not copied, and pages are read from disk on first access; elsewhere the file is read into memory.
+class ComplexFileView {
+public:
+    explicit ComplexFileView(const std::string & path);
+    ~ComplexFileView();
+
+    ComplexFileView(ComplexFileView && other) noexcept;
+    ComplexFileView & operator=(ComplexFileView && other) noexcept;
+    ComplexFileView(const ComplexFileView &) = delete;
+    ComplexFileView & operator=(const ComplexFileView &) = delete;
+
+    const ComplexFileHeader & header() const;
+    size_t size() const;
+    const Complex * data() const;
+    const Complex & operator[](size_t index) const;
+
+    const Complex * begin() const;
+    const Complex * end() const;
+
+private:
+    void release();
+
+    ComplexFileHeader m_header;
+    const Complex * m_data;
+    void * m_mapping;           // Start of the mapped file, nullptr if not mapped
+    size_t m_mappingSize;
+    std::vector<Complex> m_copy;  // Samples when not mapped
+};
+
+// Write a whole vector
+void write_complex_file(const std::string & path, const std::vector<Complex> & samples,
+                        ComplexLayout layout = ComplexLayout::Interleaved, ComplexPrecision precision = ComplexPrecision::Float64);
+
+// Read a whole file
+std::vector<Complex> read_complex_file(const std::string & path);
+
+//
+// Implementations
+//
+
+static_assert(sizeof(ComplexFileHeader) == 32, "ComplexFileHeader must stay 32 bytes");
+static_assert(sizeof(Complex) == 2 * sizeof(double) && std::is_trivially_copyable<Complex>::value,
+              "Interleaved double files are read and mapped as Complex arrays");
+
+// Samples converted per chunk, so conversion buffers stay in L2
+constexpr size_t complex_file_chunk = 4096;
+
+// Check a header read from a file
+inline void complex_file_check_header(const ComplexFileHeader & header) {
+    if (std::memcmp(header.magic, "CPLX", 4) != 0 || header.version != 1) {
+        throw std::runtime_error("Invalid complex file!");
+    }
+    if (header.byte_order != 0x0102) {
+        throw std::runtime_error("Complex file has the wrong byte order!");
+    }
+    if ((header.layout != ComplexLayout::Interleaved && header.layout != ComplexLayout::Planar) ||
+        (header.precision != ComplexPrecision::Float32 && header.precision != ComplexPrecision::Float64)) {
+        throw std::runtime_error("Invalid complex file!");
+    }
+}
+
+// Bytes of one part of one sample
+inline size_t complex_file_part_size(const ComplexFileHeader & header) {
+    return static_cast<size_t>(header.precision);
+}
+
+// Seek to an offset from origin. fseek takes a long, which is 32 bits on Windows and on 32-bit systems, so
+// the 64-bit variants are used where there are any.
+inline void complex_file_seek(std::FILE * file, uint64_t offset, int origin = SEEK_SET) {
+#if defined(_WIN32)
+    const bool fits = offset <= static_cast<uint64_t>(std::numeric_limits<__int64>::max());
+    const bool moved = fits && ::_fseeki64(file, static_cast<__int64>(offset), origin) == 0;
+#elif defined(COMPLEX_FILE_MMAP)
+    const bool fits = offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max());
+    const bool moved = fits && ::fseeko(file, static_cast<off_t>(offset), origin) == 0;
+#else
+    const bool fits = offset <= static_cast<uint64_t>(std::numeric_limits<long>::max());
+    const bool moved = fits && std::fseek(file, static_cast<long>(offset), origin) == 0;
+#endif
+    if (!moved) {
+        throw std::runtime_error("Cannot seek in complex file!");
+    }
+}
+
+// Length of the file in bytes. Leaves the file position at the end.
+inline uint64_t complex_file_length(std::FILE * file) {
+    complex_file_seek(file, 0, SEEK_END);
+#if defined(_WIN32)
+    const int64_t length = ::_ftelli64(file);
+#elif defined(COMPLEX_FILE_MMAP)
+    const int64_t length = ::ftello(file);
+#else
+    const int64_t length = std::ftell(file);
+#endif
+    if (length < 0) {
+        throw std::runtime_error("Cannot seek in complex file!");
+    }
+    return static_cast<uint64_t>(length);
+}
+
+// WRITER
+
+// Open the file and write a provisional header
+inline ComplexFileWriter::ComplexFileWriter(const std::string & path, ComplexLayout layout, ComplexPrecision precision, uint64_t count)
+    : m_file(nullptr), m_position(0), m_written(0) {
+    m_header.layout = layout;
+    m_header.precision = precision;
+    m_header.count = count;
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr) {
+        throw std::runtime_error("Cannot open file " + path + "!");
+    }
+    put(&m_header, sizeof(m_header), 0);
+}
+
+// Close the file if close() was not called. Errors are ignored here, call close() to see them.
+inline ComplexFileWriter::~ComplexFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+// Append samples. Interleaved doubles are written as they are, everything else through a conversion buffer.
+inline void ComplexFileWriter::write(const Complex * samples, size_t count) {
+    if (m_file == nullptr) {
+        throw std::runtime_error("Complex file is closed!");
+    }
+    const bool planar = m_header.layout == ComplexLayout::Planar;
+    if (planar && m_written + count > m_header.count) {
+        throw std::out_of_range("Invalid arguments. More samples than the planar file was created for!");
+    }
+    const size_t part = complex_file_part_size(m_header);
+    const uint64_t dataStart = sizeof(ComplexFileHeader);
+
+    if (!planar && m_header.precision == ComplexPrecision::Float64) {
+        put(samples, count * sizeof(Complex), dataStart + m_written * 2 * part);
+        m_written += count;
+        return;
+    }
+
+    double doubles[2 * complex_file_chunk];
+    float floats[2 * complex_file_chunk];
+    for (size_t first = 0; first < count; first += complex_file_chunk) {
+        const size_t n = std::min(complex_file_chunk, count - first);
+        const Complex * chunk = samples + first;
+        if (planar) {
+            // Real parts in the first half of the buffer, imaginary parts in the second
+            for (size_t i = 0; i < n; i++) {
+                doubles[i] = chunk[i].real();
+                doubles[complex_file_chunk + i] = chunk[i].imag();
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                doubles[2 * i] = chunk[i].real();
+                doubles[2 * i + 1] = chunk[i].imag();
+            }
+        }
+        const void * data = doubles;
+        if (m_header.precision == ComplexPrecision::Float32) {
+            // Only the slots filled above: [0, 2n) interleaved, [0, n) and [chunk, chunk + n) planar
+            if (planar) {
+                for (size_t i = 0; i < n; i++) {
+                    floats[i] = static_cast<float>(doubles[i]);
+                    floats[complex_file_chunk + i] = static_cast<float>(doubles[complex_file_chunk + i]);
+                }
+            } else {
+                for (size_t i = 0; i < 2 * n; i++) {
+                    floats[i] = static_cast<float>(doubles[i]);
+                }
+            }
+            data = floats;
+        }
+        const char * bytes = static_cast<const char *>(data);
+        if (planar) {
+            put(bytes, n * part, dataStart + m_written * part);
+            put(bytes + complex_file_chunk * part, n * part, dataStart + (m_header.count + m_written) * part);
+        } else {
+            put(bytes, 2 * n * part, dataStart + m_written * 2 * part);
+        }
+        m_written += n;
+    }
+}
+
+// Append all samples of a vector
+inline void ComplexFileWriter::write(const std::vector<Complex> & samples) {
+    write(samples.data(), samples.size());
+}
+
+// Complete the header and close the file. Throws if a planar file got fewer samples than announced.
+inline void ComplexFileWriter::close() {
+    if (m_file == nullptr) {
+        return;
+    }
+    std::FILE * file = m_file;
+    bool complete = true;
+    if (m_header.layout == ComplexLayout::Interleaved) {
+        m_header.count = m_written;
+        put(&m_header, sizeof(m_header), 0);
+    } else {
+        complete = m_written == m_header.count;
+    }
+    m_file = nullptr;
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("Cannot write complex file!");
+    }
+    if (!complete) {
+        throw std::out_of_range("Invalid arguments. Planar file got fewer samples than it was created for!");
+    }
+}
+
+// Number of samples written so far
+inline uint64_t ComplexFileWriter::written() const {
+    return m_written;
+}
+
+// Write bytes at an offset, seeking only if the file position is elsewhere
+inline void ComplexFileWriter::put(const void * data, size_t bytes, uint64_t offset) {
+    if (m_position != offset) {
+        complex_file_seek(m_file, offset);
+    }
+    m_position = offset + bytes;
+    if (std::fwrite(data, 1, bytes, m_file) != bytes) {
+        throw std::runtime_error("Cannot write complex file!");
+    }
+}
+
+// READER
+
+// Open the file and check its header, and that the file holds the samples it announces
+inline ComplexFileReader::ComplexFileReader(const std::string & path) : m_file(nullptr), m_position(0), m_read(0) {
+    m_file = std::fopen(path.c_str(), "rb");
+    if (m_file == nullptr) {
+        throw std::runtime_error("Cannot open file " + path + "!");
+    }
+    try {
+        get(&m_header, sizeof(m_header), 0);
+        complex_file_check_header(m_header);
+        // The count must fit in the file, so read_all never allocates for samples that are not there
+        const uint64_t length = complex_file_length(m_file);
+        m_position = length;
+        if (m_header.count > (length - sizeof(ComplexFileHeader)) / (2 * complex_file_part_size(m_header))) {
+            throw std::runtime_error("Complex file is truncated!");
+        }
+    } catch (...) {
+        std::fclose(m_file);
+        throw;
+    }
+}
+
+// Close the file
+inline ComplexFileReader::~ComplexFileReader() {
+    std::fclose(m_file);
+}
+
+// Header of the file
+inline const ComplexFileHeader & ComplexFileReader::header() const {
+    return m_header;
+}
+
+// Number of samples in the file
+inline uint64_t ComplexFileReader::size() const {
+    return m_header.count;
+}
+
+// Number of samples not read yet
+inline uint64_t ComplexFileReader::remaining() const {
+    return m_header.count - m_read;
+}
+
+// Read up to count samples, returns the number read (0 at the end of the file)
+inline size_t ComplexFileReader::read(Complex * samples, size_t count) {
+    count = static_cast<size_t>(std::min<uint64_t>(count, remaining()));
+    const bool planar = m_header.layout == ComplexLayout::Planar;
+    const size_t part = complex_file_part_size(m_header);
+    const uint64_t dataStart = sizeof(ComplexFileHeader);
+
+    if (!planar && m_header.precision == ComplexPrecision::Float64) {
+        get(samples, count * sizeof(Complex), dataStart + m_read * 2 * part);
+        m_read += count;
+        return count;
+    }
+
+    double doubles[2 * complex_file_chunk];
+    float floats[2 * complex_file_chunk];
+    for (size_t first = 0; first < count; first += complex_file_chunk) {
+        const size_t n = std::min(complex_file_chunk, count - first);
+        char * bytes = (m_header.precision == ComplexPrecision::Float32) ? reinterpret_cast<char *>(floats)
+                                                                         : reinterpret_cast<char *>(doubles);
+        if (planar) {
+            get(bytes, n * part, dataStart + m_read * part);
+            get(bytes + complex_file_chunk * part, n * part, dataStart + (m_header.count + m_read) * part);
+        } else {
+            get(bytes, 2 * n * part, dataStart + m_read * 2 * part);
+        }
+        if (m_header.precision == ComplexPrecision::Float32) {
+            // Only the slots read above
+            if (planar) {
+                for (size_t i = 0; i < n; i++) {
+                    doubles[i] = floats[i];
+                    doubles[complex_file_chunk + i] = floats[complex_file_chunk + i];
+                }
+            } else {
+                for (size_t i = 0; i < 2 * n; i++) {
+                    doubles[i] = floats[i];
+                }
+            }
+        }
+        Complex * chunk = samples + first;
+        if (planar) {
+            for (size_t i = 0; i < n; i++) {
+                chunk[i] = Complex(doubles[i], doubles[complex_file_chunk + i]);
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                chunk[i] = Complex(doubles[2 * i], doubles[2 * i + 1]);
+            }
+        }
+        m_read += n;
+    }
+    return count;
+}
+
+// Read every sample not read yet
+inline std::vector<Complex> ComplexFileReader::read_all() {
+    std::vector<Complex> samples(static_cast<size_t>(remaining()));
+    read(samples.data(), samples.size());
+    return samples;
+}
+
+// Read bytes at an offset, seeking only if the file position is elsewhere
+inline void ComplexFileReader::get(void * data, size_t bytes, uint64_t offset) {
+    if (m_position != offset) {
+        complex_file_seek(m_file, offset);
+    }
+    m_position = offset + bytes;
+    if (std::fread(data, 1, bytes, m_file) != bytes) {
+        throw std::runtime_error("Complex file is truncated!");
+    }
+}
+
+// VIEW
+
+// Map the file, or read it where mmap is not available. Only interleaved double files can be viewed as Complex.
+inline ComplexFileView::ComplexFileView(const std::string & path) : m_data(nullptr), m_mapping(nullptr), m_mappingSize(0) {
+#ifdef COMPLEX_FILE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file " + path + "!");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ComplexFileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Invalid complex file!");
+    }
+    m_mappingSize = static_cast<size_t>(info.st_size);
+    void * mapping = ::mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file " + path + "!");
+    }
+    m_mapping = mapping;
+    ::madvise(m_mapping, m_mappingSize, MADV_SEQUENTIAL);
+    std::memcpy(&m_header, m_mapping, sizeof(m_header));
+    try {
+        complex_file_check_header(m_header);
+        if (m_header.layout != ComplexLayout::Interleaved || m_header.precision != ComplexPrecision::Float64) {
+            throw std::runtime_error("Only interleaved double files can be viewed as Complex!");
+        }
+        if (m_header.count > (m_mappingSize - sizeof(ComplexFileHeader)) / sizeof(Complex)) {   // No overflow in count * size
+            throw std::runtime_error("Complex file is truncated!");
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+    // The mapping is page aligned and the header 32 bytes long, so the samples are aligned for Complex
+    m_data = reinterpret_cast<const Complex *>(static_cast<const char *>(m_mapping) + sizeof(ComplexFileHeader));
+#else
+    ComplexFileReader reader(path);
+    m_header = reader.header();
+    if (m_header.layout != ComplexLayout::Interleaved || m_header.precision != ComplexPrecision::Float64) {
+        throw std::runtime_error("Only interleaved double files can be viewed as Complex!");
+    }
+    m_copy = reader.read_all();
+    m_data = m_copy.data();
+#endif
+}
+
+// Unmap the file
+inline ComplexFileView::~ComplexFileView() {
+    release();
+}
+
+// Move constructor
+inline ComplexFileView::ComplexFileView(ComplexFileView && other) noexcept
+    : m_header(other.m_header), m_data(other.m_data), m_mapping(other.m_mapping), m_mappingSize(other.m_mappingSize),
+      m_copy(std::move(other.m_copy)) {
+    other.m_data = nullptr;
+    other.m_mapping = nullptr;
+    other.m_mappingSize = 0;
+    other.m_header.count = 0;
+}
+
+// Move assignment operator
+inline ComplexFileView & ComplexFileView::operator=(ComplexFileView && other) noexcept {
+    if (this != &other) {
+        release();
+        m_header = other.m_header;
+        m_data = other.m_data;
+        m_mapping = other.m_mapping;
+        m_mappingSize = other.m_mappingSize;
+        m_copy = std::move(other.m_copy);
+        other.m_data = nullptr;
+        other.m_mapping = nullptr;
+        other.m_mappingSize = 0;
+        other.m_header.count = 0;
+    }
+    return *this;
+}
+
+// Header of the file
+inline const ComplexFileHeader & ComplexFileView::header() const {
+    return m_header;
+}
+
+// Number of samples
+inline size_t ComplexFileView::size() const {
+    return static_cast<size_t>(m_header.count);
+}
+
+// First sample
+inline const Complex * ComplexFileView::data() const {
+    return m_data;
+}
+
+// Sample at index
+inline const Complex & ComplexFileView::operator[](size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("Invalid arguments. Index out of range!");
+    }
+    return m_data[index];
+}
+
+// begin()
+inline const Complex * ComplexFileView::begin() const {
+    return m_data;
+}
+
+// end()
+inline const Complex * ComplexFileView::end() const {
+    return m_data + size();
+}
+
+// Unmap the file, if mapped
+inline void ComplexFileView::release() {
+#ifdef COMPLEX_FILE_MMAP
+    if (m_mapping != nullptr) {
+        ::munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+}
+
+// FUNCTIONS
+
+// Write a whole vector
+inline void write_complex_file(const std::string & path, const std::vector<Complex> & samples, ComplexLayout layout, ComplexPrecision precision) {
+    ComplexFileWriter writer(path, layout, precision, samples.size());
+    writer.write(samples);
+    writer.close();
+}
+
+// Read a whole file
+inline std::vector<Complex> read_complex_file(const std::string & path) {
+    ComplexFileReader reader(path);
+    return reader.read_all();
+}
+
+#endif //COMPLEXFILE_H
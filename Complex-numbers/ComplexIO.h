@@ -0,0 +1,215 @@
+/*
+* Bulk text parsing and formatting of complex numbers
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COMPLEXIO_H
+#define COMPLEXIO_H
+
+#include "Complex.h"
+
+#include <charconv>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// The text format is the one of operator<< and operator>>: "(re,im)", "(re)" or a bare "re", with numbers in
+// the form accepted by std::from_chars (no leading '+', "inf" and "nan" allowed). Spaces and tabs may appear
+// inside the parentheses. Numbers in a buffer are separated by whitespace.
+//
+// Unlike operator>>, which reads one line through a std::istringstream and leaves 0 in any part it cannot read,
+// these functions work on a char buffer without allocating and report the offset of the first bad character.
+// Output uses the shortest text that reads back to the same double, so parse(format(x)) == x.
+
+// Outcome of a bulk parse
+struct ComplexParseResult {
+    size_t count = 0;               // Numbers stored
+    size_t offset = 0;              // Offset of the end of the input on success, else of the bad character
+                                    // (of the number that failed, for result_out_of_range and value_too_large)
+    std::errc error = std::errc();  // invalid_argument: malformed text, result_out_of_range: a part too large
+                                    // for a double, value_too_large: more numbers than fit in the output
+
+    bool ok() const;
+};
+
+// Parse one number starting exactly at first, like std::from_chars
+std::from_chars_result from_chars(const char * first, const char * last, Complex & value);
+
+// Write "(re,im)" like std::to_chars, errc::value_too_large if it does not fit
+std::to_chars_result to_chars(char * first, char * last, const Complex & value);
+
+// Parse whitespace-separated numbers into out, at most capacity of them
+ComplexParseResult parse_complex_array(const char * first, const char * last, Complex * out, size_t capacity);
+
+// Parse whitespace-separated numbers and append them to out
+ComplexParseResult parse_complex_array(const std::string & text, std::vector<Complex> & out);
+
+// Write count numbers, each followed by separator; errc::value_too_large if they do not fit
+std::to_chars_result format_complex_array(char * first, char * last, const Complex * in, size_t count, char separator = '\n');
+
+// Format count numbers into a new string
+std::string format_complex_array(const Complex * in, size_t count, char separator = '\n');
+
+//
+// Implementations
+//
+
+// Longest text to_chars writes for one number: "(" + two shortest doubles (at most 24 characters each) + "," + ")"
+constexpr size_t complex_chars_max = 2 * 24 + 3;
+
+// True if nothing went wrong
+inline bool ComplexParseResult::ok() const {
+    return error == std::errc();
+}
+
+// Skip spaces and tabs
+inline const char * complex_skip_blanks(const char * first, const char * last) {
+    while (first != last && (*first == ' ' || *first == '\t')) {
+        first++;
+    }
+    return first;
+}
+
+// True for the characters separating numbers in a buffer
+inline bool complex_is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// PARSING
+
+// One number in any of the three forms. On error, ptr points at the offending character (for a part too
+// large for a double, just past that part) and value is unchanged.
+inline std::from_chars_result from_chars(const char * first, const char * last, Complex & value) {
+    double re = 0.0;
+    double im = 0.0;
+    if (first == last || *first != '(') {
+        std::from_chars_result result = std::from_chars(first, last, re);
+        if (result.ec == std::errc()) {
+            value = Complex(re);
+        }
+        return result;
+    }
+
+    const char * p = complex_skip_blanks(first + 1, last);
+    std::from_chars_result result = std::from_chars(p, last, re);
+    if (result.ec != std::errc()) {
+        return result;
+    }
+    p = complex_skip_blanks(result.ptr, last);
+    if (p != last && *p == ',') {
+        p = complex_skip_blanks(p + 1, last);
+        result = std::from_chars(p, last, im);
+        if (result.ec != std::errc()) {
+            return result;
+        }
+        p = complex_skip_blanks(result.ptr, last);
+    }
+    if (p == last || *p != ')') {
+        return {p, std::errc::invalid_argument};
+    }
+    value = Complex(re, im);
+    return {p + 1, std::errc()};
+}
+
+// Numbers separated by whitespace. Parsing stops at the first error; the numbers before it are stored.
+inline ComplexParseResult parse_complex_array(const char * first, const char * last, Complex * out, size_t capacity) {
+    ComplexParseResult result;
+    const char * p = first;
+    while (true) {
+        while (p != last && complex_is_separator(*p)) {
+            p++;
+        }
+        if (p == last) {
+            break;
+        }
+        if (result.count == capacity) {
+            result.error = std::errc::value_too_large;
+            break;
+        }
+        std::from_chars_result parsed = from_chars(p, last, out[result.count]);
+        if (parsed.ec != std::errc()) {
+            result.error = parsed.ec;
+            p = (parsed.ec == std::errc::result_out_of_range) ? p : parsed.ptr;
+            break;
+        }
+        if (parsed.ptr != last && !complex_is_separator(*parsed.ptr)) {
+            result.error = std::errc::invalid_argument;   // e.g. "1.5x" or "(1,2)(3,4)"
+            p = parsed.ptr;
+            break;
+        }
+        p = parsed.ptr;
+        result.count++;
+    }
+    result.offset = p - first;
+    return result;
+}
+
+// Parse into a vector, growing it as needed. Numbers before an error are kept.
+inline ComplexParseResult parse_complex_array(const std::string & text, std::vector<Complex> & out) {
+    // One cheap pass counts the whitespace-separated tokens, so out is resized once
+    size_t tokens = 0;
+    bool inToken = false;
+    for (char c : text) {
+        const bool separator = complex_is_separator(c);
+        tokens += (!separator && !inToken);
+        inToken = !separator;
+    }
+    const size_t start = out.size();
+    out.resize(start + tokens);
+    ComplexParseResult result = parse_complex_array(text.data(), text.data() + text.size(), out.data() + start, out.size() - start);
+    out.resize(start + result.count);
+    return result;
+}
+
+// FORMATTING
+
+// "(re,im)" with the shortest round-trip text for each part
+inline std::to_chars_result to_chars(char * first, char * last, const Complex & value) {
+    if (first == last) {
+        return {last, std::errc::value_too_large};
+    }
+    *first = '(';
+    std::to_chars_result result = std::to_chars(first + 1, last, value.real());
+    if (result.ec != std::errc()) {
+        return result;
+    }
+    if (result.ptr == last) {
+        return {last, std::errc::value_too_large};
+    }
+    *result.ptr = ',';
+    result = std::to_chars(result.ptr + 1, last, value.imag());
+    if (result.ec != std::errc()) {
+        return result;
+    }
+    if (result.ptr == last) {
+        return {last, std::errc::value_too_large};
+    }
+    *result.ptr = ')';
+    return {result.ptr + 1, std::errc()};
+}
+
+// Numbers one after another, each followed by separator
+inline std::to_chars_result format_complex_array(char * first, char * last, const Complex * in, size_t count, char separator) {
+    char * p = first;
+    for (size_t i = 0; i < count; i++) {
+        std::to_chars_result result = to_chars(p, last, in[i]);
+        if (result.ec != std::errc() || result.ptr == last) {
+            return {last, std::errc::value_too_large};
+        }
+        *result.ptr = separator;
+        p = result.ptr + 1;
+    }
+    return {p, std::errc()};
+}
+
+// Format into a string sized for the longest possible text, then trimmed
+inline std::string format_complex_array(const Complex * in, size_t count, char separator) {
+    std::string text(count * (complex_chars_max + 1), '\0');
+    std::to_chars_result result = format_complex_array(&text[0], &text[0] + text.size(), in, count, separator);
+    text.resize(result.ptr - text.data());
+    return text;
+}
+
+#endif //COMPLEXIO_H
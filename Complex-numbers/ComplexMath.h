@@ -0,0 +1,438 @@
+/*
+* Element-wise transcendental functions on ComplexArray
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COMPLEXMATH_H
+#define COMPLEXMATH_H
+
+#include "Complex.h"
+#include "ComplexArray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// The scalar exp, log, sqrt, pow, arg and polar of Complex.h call std::exp, std::sin and so on, which compilers
+// only vectorize with -ffast-math. The batch versions below work on the planes of a ComplexArray with their
+// own branch-free polynomial kernels instead, so the loops vectorize at -O3 on any target. Each kernel covers
+// the usual range of its argument (exp: [-708, 709], sin/cos: |x| <= 1e5, log: positive normal numbers) and
+// counts the elements outside it; only if there are any, a second loop redoes those with the std functions.
+// Results differ from the scalar functions by a few units in the last place, relative to the magnitude of the
+// result. The sqrt calls in sqrt() vectorize only with -fno-math-errno, like abs(ComplexArray).
+
+// e^z of every element
+ComplexArray exp(const ComplexArray & numbers);
+
+// Principal logarithm of every element
+ComplexArray log(const ComplexArray & numbers);
+
+// Principal square root of every element
+ComplexArray sqrt(const ComplexArray & numbers);
+
+// Every element raised to a complex or real power, see pow in Complex.h
+ComplexArray pow(const ComplexArray & numbers, const Complex & exponent);
+ComplexArray pow(const ComplexArray & numbers, double exponent);
+
+// Angle of every element
+std::vector<double> arg(const ComplexArray & numbers);
+
+// Numbers from magnitudes and angles, the vectors must have the same size
+ComplexArray polar(const std::vector<double> & magnitude, const std::vector<double> & angle);
+
+//
+// Implementations
+//
+
+// Elements per block: the batch functions keep their intermediate planes on the stack, in L1
+constexpr size_t complex_math_block = 256;
+
+// Adding 1.5 * 2^52 to a double of magnitude below 2^51 rounds it to an integer, which is then held in the low
+// bits of the mantissa; subtracting it again gives the rounded value as a double
+constexpr double complex_math_shifter = 6755399441055744.0;
+
+// Reinterpret the bits of a double as an integer and back, vectorizable unlike a union
+inline uint64_t complex_math_bits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double complex_math_double(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// KERNELS
+// The output of a kernel must not overlap its input: the second loop reads the input again.
+
+// out[i] = e^x[i]. x = n ln2 + r with |r| <= ln2/2, e^r from its Taylor polynomial of degree 13 (error below
+// 1e-17) and 2^n built directly in the exponent bits.
+inline void complex_math_exp(const double * x, double * out, size_t n) {
+    constexpr double log2e = 1.44269504088896338700e+00;
+    constexpr double ln2Hi = 6.93147180369123816490e-01;   // ln2 in two parts, n * ln2Hi is exact
+    constexpr double ln2Lo = 1.90821492927058770002e-10;
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double v = x[i];
+        outside += !((v >= -708.0) & (v <= 709.0));
+        const double k = v * log2e + complex_math_shifter;
+        const double m = k - complex_math_shifter;
+        const double r = (v - m * ln2Hi) - m * ln2Lo;
+        // Taylor polynomial 1 + r + r^2/2! + ... + r^13/13! by Horner's rule
+        double p = 1.0 / 6227020800.0;
+        for (double factorial : {479001600.0, 39916800.0, 3628800.0, 362880.0, 40320.0, 5040.0, 720.0, 120.0, 24.0, 6.0, 2.0, 1.0, 1.0}) {
+            p = p * r + 1.0 / factorial;
+        }
+        const double scale = complex_math_double((complex_math_bits(k) + 1023) << 52);  // 2^m
+        out[i] = p * scale;
+    }
+    if (outside != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (!(x[i] >= -708.0 && x[i] <= 709.0)) {
+                out[i] = std::exp(x[i]);
+            }
+        }
+    }
+}
+
+// sine[i] = sin x[i], cosine[i] = cos x[i]. x = n pi/2 + r with |r| <= pi/4, using pi/2 in three parts of 33
+// bits so n * part is exact for |n| < 2^20, then the fdlibm polynomials for sin and cos on [-pi/4, pi/4];
+// n mod 4 picks which of them, and which sign, each result gets.
+inline void complex_math_sincos(const double * x, double * sine, double * cosine, size_t n) {
+    constexpr double twoOverPi = 6.36619772367581382433e-01;
+    constexpr double pio2_1 = 1.57079632673412561417e+00;
+    constexpr double pio2_2 = 6.07710050630396597660e-11;
+    constexpr double pio2_3 = 2.02226624871116645580e-21;
+    constexpr double S1 = -1.66666666666666324348e-01;
+    constexpr double S2 = 8.33333333332248946124e-03;
+    constexpr double S3 = -1.98412698298579493134e-04;
+    constexpr double S4 = 2.75573137070700676789e-06;
+    constexpr double S5 = -2.50507602534068634195e-08;
+    constexpr double S6 = 1.58969099521155010221e-10;
+    constexpr double C1 = 4.16666666666666019037e-02;
+    constexpr double C2 = -1.38888888888741095749e-03;
+    constexpr double C3 = 2.48015872894767294178e-05;
+    constexpr double C4 = -2.75573143513906633035e-07;
+    constexpr double C5 = 2.08757232129817482790e-09;
+    constexpr double C6 = -1.13596475577881948265e-11;
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double v = x[i];
+        outside += !(std::fabs(v) <= 1e5);
+        const double k = v * twoOverPi + complex_math_shifter;
+        const double m = k - complex_math_shifter;
+        const double r = ((v - m * pio2_1) - m * pio2_2) - m * pio2_3;
+        const double z = r * r;
+        const double s = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+        const double c = 1.0 - 0.5 * z + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+        const uint64_t quadrant = complex_math_bits(k);
+        const double sinValue = (quadrant & 1) ? c : s;
+        const double cosValue = (quadrant & 1) ? s : c;
+        sine[i] = (quadrant & 2) ? -sinValue : sinValue;
+        cosine[i] = ((quadrant + 1) & 2) ? -cosValue : cosValue;
+    }
+    if (outside != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (!(std::fabs(x[i]) <= 1e5)) {
+                sine[i] = std::sin(x[i]);
+                cosine[i] = std::cos(x[i]);
+            }
+        }
+    }
+}
+
+// out[i] = ln x[i]. x = 2^e m with m in [sqrt(2)/2, sqrt(2)), read from the exponent and mantissa bits, then
+// the fdlibm log polynomial for ln m = ln(1+f) in s = f/(2+f).
+inline void complex_math_log(const double * x, double * out, size_t n) {
+    constexpr double ln2Hi = 6.93147180369123816490e-01;
+    constexpr double ln2Lo = 1.90821492927058770002e-10;
+    constexpr double Lg1 = 6.666666666666735130e-01;
+    constexpr double Lg2 = 3.999999999940941908e-01;
+    constexpr double Lg3 = 2.857142874366239149e-01;
+    constexpr double Lg4 = 2.222219843214978396e-01;
+    constexpr double Lg5 = 1.818357216161805012e-01;
+    constexpr double Lg6 = 1.531383769920937332e-01;
+    constexpr double Lg7 = 1.479819860511658591e-01;
+    constexpr uint64_t mantissaMask = (uint64_t(1) << 52) - 1;
+    constexpr uint64_t one = 0x3FF0000000000000;
+    constexpr uint64_t twoTo52 = 0x4330000000000000;
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double v = x[i];
+        outside += !((v >= std::numeric_limits<double>::min()) & (v <= std::numeric_limits<double>::max()));
+        const uint64_t bits = complex_math_bits(v);
+        // Biased exponent as a double, through the bits of 2^52 + exponent
+        double e = complex_math_double((bits >> 52) | twoTo52) - (4503599627370496.0 + 1023.0);
+        double m = complex_math_double((bits & mantissaMask) | one);
+        const bool above = m > 1.41421356237309514547;
+        m = above ? 0.5 * m : m;
+        e = above ? e + 1.0 : e;
+        const double f = m - 1.0;
+        const double s = f / (2.0 + f);
+        const double z = s * s;
+        const double w = z * z;
+        const double R = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7))) + w * (Lg2 + w * (Lg4 + w * Lg6));
+        const double hfsq = 0.5 * f * f;
+        out[i] = e * ln2Hi - ((hfsq - (s * (hfsq + R) + e * ln2Lo)) - f);
+    }
+    if (outside != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (!(x[i] >= std::numeric_limits<double>::min() && x[i] <= std::numeric_limits<double>::max())) {
+                out[i] = std::log(x[i]);
+            }
+        }
+    }
+}
+
+// out[i] = atan2(y[i], x[i]). atan of t = min(|x|,|y|) / max(|x|,|y|) in [0, 1] with the fdlibm reduction and
+// polynomial, then mirrored into the right octant.
+inline void complex_math_atan2(const double * y, const double * x, double * out, size_t n) {
+    constexpr double atanHalfHi = 4.63647609000806093515e-01;  // atan(0.5) in two parts
+    constexpr double atanHalfLo = 2.26987774529616870924e-17;
+    constexpr double atanOneHi = 7.85398163397448278999e-01;   // atan(1)
+    constexpr double atanOneLo = 3.06161699786838301793e-17;
+    constexpr double halfPi = 1.57079632679489655800e+00;
+    constexpr double pi = 3.14159265358979311600e+00;
+    constexpr double aT0 = 3.33333333333329318027e-01;
+    constexpr double aT1 = -1.99999999998764832476e-01;
+    constexpr double aT2 = 1.42857142725034663711e-01;
+    constexpr double aT3 = -1.11111104054623557880e-01;
+    constexpr double aT4 = 9.09088713343650656196e-02;
+    constexpr double aT5 = -7.69187620504482999495e-02;
+    constexpr double aT6 = 6.66107313738753120669e-02;
+    constexpr double aT7 = -5.83357013379057348645e-02;
+    constexpr double aT8 = 4.97687799461593236017e-02;
+    constexpr double aT9 = -3.65315727442169155270e-02;
+    constexpr double aT10 = 1.62858201153657823623e-02;
+    size_t outside = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double ax = std::fabs(x[i]);
+        const double ay = std::fabs(y[i]);
+        const double big = std::max(ax, ay);
+        const double small = std::min(ax, ay);
+        outside += !((big >= std::numeric_limits<double>::min()) & (big <= std::numeric_limits<double>::max()));
+        const double t = small / big;
+        // atan(t) = atan(c) + atan((t-c)/(1+tc)) for c = 0, 0.5 or 1, whichever keeps the argument below 7/16
+        const bool low = t < 7.0 / 16;
+        const bool middle = t < 11.0 / 16;
+        const double u = low ? t : (middle ? (2.0 * t - 1.0) / (2.0 + t) : (t - 1.0) / (t + 1.0));
+        const double hi = low ? 0.0 : (middle ? atanHalfHi : atanOneHi);
+        const double lo = low ? 0.0 : (middle ? atanHalfLo : atanOneLo);
+        const double z = u * u;
+        const double w = z * z;
+        const double s1 = z * (aT0 + w * (aT2 + w * (aT4 + w * (aT6 + w * (aT8 + w * aT10)))));
+        const double s2 = w * (aT1 + w * (aT3 + w * (aT5 + w * (aT7 + w * aT9))));
+        double angle = hi - ((u * (s1 + s2) - lo) - u);
+        angle = (ay > ax) ? halfPi - angle : angle;
+        angle = (x[i] < 0) ? pi - angle : angle;
+        out[i] = std::copysign(angle, y[i]);
+    }
+    if (outside != 0) {
+        for (size_t i = 0; i < n; i++) {
+            const double big = std::max(std::fabs(x[i]), std::fabs(y[i]));
+            if (!(big >= std::numeric_limits<double>::min() && big <= std::numeric_limits<double>::max())) {
+                out[i] = std::atan2(y[i], x[i]);
+            }
+        }
+    }
+}
+
+// ln|a+bi| as ln(a^2+b^2) / 2, with abs for the elements where a^2+b^2 over- or underflows
+inline void complex_math_log_abs(const double * a, const double * b, double * out, size_t n) {
+    double squared[complex_math_block];
+    for (size_t start = 0; start < n; start += complex_math_block) {
+        const size_t count = std::min(complex_math_block, n - start);
+        size_t unsafe = 0;
+        for (size_t i = 0; i < count; i++) {
+            squared[i] = a[start + i] * a[start + i] + b[start + i] * b[start + i];
+            unsafe += !((squared[i] >= std::numeric_limits<double>::min()) & (squared[i] <= std::numeric_limits<double>::max()));
+        }
+        complex_math_log(squared, out + start, count);
+        for (size_t i = 0; i < count; i++) {
+            out[start + i] *= 0.5;
+        }
+        if (unsafe != 0) {
+            for (size_t i = 0; i < count; i++) {
+                if (!(squared[i] >= std::numeric_limits<double>::min() && squared[i] <= std::numeric_limits<double>::max())) {
+                    out[start + i] = std::log(abs(Complex(a[start + i], b[start + i])));
+                }
+            }
+        }
+    }
+}
+
+// re + im i = e^(a+bi) = e^a (cos b + i sin b), a real element stays real like the scalar exp
+inline void complex_math_exp(const double * a, const double * b, double * re, double * im, size_t n) {
+    double magnitude[complex_math_block];
+    double sine[complex_math_block];
+    double cosine[complex_math_block];
+    for (size_t start = 0; start < n; start += complex_math_block) {
+        const size_t count = std::min(complex_math_block, n - start);
+        complex_math_exp(a + start, magnitude, count);
+        complex_math_sincos(b + start, sine, cosine, count);
+        for (size_t i = 0; i < count; i++) {
+            const double angle = b[start + i];
+            re[start + i] = (angle == 0) ? magnitude[i] : magnitude[i] * cosine[i];
+            im[start + i] = (angle == 0) ? angle : magnitude[i] * sine[i];
+        }
+    }
+}
+
+// FUNCTIONS
+
+// e^z of every element
+inline ComplexArray exp(const ComplexArray & numbers) {
+    ComplexArray result(numbers.size());
+    complex_math_exp(numbers.real_data(), numbers.imag_data(), result.real_data(), result.imag_data(), numbers.size());
+    return result;
+}
+
+// ln|z| + i arg(z) of every element
+inline ComplexArray log(const ComplexArray & numbers) {
+    ComplexArray result(numbers.size());
+    complex_math_log_abs(numbers.real_data(), numbers.imag_data(), result.real_data(), numbers.size());
+    complex_math_atan2(numbers.imag_data(), numbers.real_data(), result.imag_data(), numbers.size());
+    return result;
+}
+
+// Principal square root of every element, with the formula of the scalar sqrt. |z| is taken like in
+// abs(ComplexArray), block by block.
+inline ComplexArray sqrt(const ComplexArray & numbers) {
+    const size_t n = numbers.size();
+    ComplexArray result(n);
+    const double * a = numbers.real_data();
+    const double * b = numbers.imag_data();
+    double * re = result.real_data();
+    double * im = result.imag_data();
+    double magnitude[complex_math_block];
+    for (size_t start = 0; start < n; start += complex_math_block) {
+        const size_t count = std::min(complex_math_block, n - start);
+        size_t unsafe = 0;
+        for (size_t i = 0; i < count; i++) {
+            const double squared = a[start + i] * a[start + i] + b[start + i] * b[start + i];
+            unsafe += !((squared >= std::numeric_limits<double>::min()) & (squared <= std::numeric_limits<double>::max()));
+            magnitude[i] = std::sqrt(squared);
+        }
+        if (unsafe != 0) {
+            for (size_t i = 0; i < count; i++) {
+                magnitude[i] = abs(Complex(a[start + i], b[start + i]));
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            const double x = a[start + i];
+            const double y = b[start + i];
+            const bool large = magnitude[i] >= std::numeric_limits<double>::max() / 4;
+            const double t = large ? std::sqrt(0.5 * std::fabs(x) + 0.5 * magnitude[i])
+                                   : 0.5 * std::sqrt(2.0 * (std::fabs(x) + magnitude[i]));
+            const bool zero = (x == 0) & (y == 0);
+            const bool positive = x >= 0;
+            re[start + i] = zero ? 0.0 : (positive ? t : std::fabs(y) / (2.0 * t));
+            im[start + i] = zero ? y : (positive ? y / (2.0 * t) : std::copysign(t, y));
+        }
+    }
+    return result;
+}
+
+// e^(w log z) of every element z, with the scalar pow for elements equal to 0
+inline ComplexArray pow(const ComplexArray & numbers, const Complex & exponent) {
+    const size_t n = numbers.size();
+    ComplexArray result = log(numbers);
+    double * re = result.real_data();
+    double * im = result.imag_data();
+    const double c = exponent.real();
+    const double d = exponent.imag();
+    for (size_t i = 0; i < n; i++) {
+        const double logRe = re[i];
+        re[i] = c * logRe - d * im[i];
+        im[i] = c * im[i] + d * logRe;
+    }
+    complex_math_exp(re, im, re, im, n);
+
+    const double * a = numbers.real_data();
+    const double * b = numbers.imag_data();
+    size_t zeros = 0;
+    for (size_t i = 0; i < n; i++) {
+        zeros += (a[i] == 0.0) & (b[i] == 0.0);
+    }
+    if (zeros != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (a[i] == 0.0 && b[i] == 0.0) {
+                result.set(i, pow(Complex(a[i], b[i]), exponent));
+            }
+        }
+    }
+    return result;
+}
+
+// |z|^x (cos(x arg z) + i sin(x arg z)) of every element z, with the scalar pow for elements equal to 0
+inline ComplexArray pow(const ComplexArray & numbers, double exponent) {
+    const size_t n = numbers.size();
+    ComplexArray result(n);
+    const double * a = numbers.real_data();
+    const double * b = numbers.imag_data();
+    double * re = result.real_data();
+    double * im = result.imag_data();
+    double logAbs[complex_math_block];
+    double angle[complex_math_block];
+    double magnitude[complex_math_block];
+    double sine[complex_math_block];
+    double cosine[complex_math_block];
+    size_t zeros = 0;
+    for (size_t start = 0; start < n; start += complex_math_block) {
+        const size_t count = std::min(complex_math_block, n - start);
+        complex_math_log_abs(a + start, b + start, logAbs, count);
+        complex_math_atan2(b + start, a + start, angle, count);
+        for (size_t i = 0; i < count; i++) {
+            logAbs[i] *= exponent;
+            angle[i] *= exponent;
+            zeros += (a[start + i] == 0.0) & (b[start + i] == 0.0);
+        }
+        complex_math_exp(logAbs, magnitude, count);
+        complex_math_sincos(angle, sine, cosine, count);
+        for (size_t i = 0; i < count; i++) {
+            re[start + i] = magnitude[i] * cosine[i];
+            im[start + i] = magnitude[i] * sine[i];
+        }
+    }
+    if (zeros != 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (a[i] == 0.0 && b[i] == 0.0) {
+                result.set(i, pow(Complex(a[i], b[i]), exponent));
+            }
+        }
+    }
+    return result;
+}
+
+// Angle of every element
+inline std::vector<double> arg(const ComplexArray & numbers) {
+    std::vector<double> result(numbers.size());
+    complex_math_atan2(numbers.imag_data(), numbers.real_data(), result.data(), numbers.size());
+    return result;
+}
+
+// magnitude[i] (cos angle[i] + i sin angle[i])
+inline ComplexArray polar(const std::vector<double> & magnitude, const std::vector<double> & angle) {
+    if (magnitude.size() != angle.size()) {
+        throw std::out_of_range("Invalid arguments. Array sizes differ!");
+    }
+    ComplexArray result(magnitude.size());
+    double * re = result.real_data();
+    double * im = result.imag_data();
+    complex_math_sincos(angle.data(), im, re, angle.size());
+    for (size_t i = 0; i < magnitude.size(); i++) {
+        re[i] *= magnitude[i];
+        im[i] *= magnitude[i];
+    }
+    return result;
+}
+
+#endif //COMPLEXMATH_H
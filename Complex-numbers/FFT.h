@@ -0,0 +1,518 @@
+/*
+* Fast Fourier transforms of Complex and real data
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef FFT_H
+#define FFT_H
+
+#include "Complex.h"
+
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Plan for transforms of one size. Building a plan factors the size and precomputes the twiddle factors,
+// so build it once and reuse it for every transform of that size. A plan is never changed by a transform,
+// so one plan may be used by several threads at once.
+//
+// Sizes are split into radix-4, radix-2 and other small prime factors (mixed-radix Cooley-Tukey). A size
+// with a prime factor above fft_bluestein_threshold is done with Bluestein's algorithm instead, which turns
+// it into a convolution computed with power-of-two transforms.
+//
+// Forward transforms are unnormalized, X[k] = sum of x[j] * exp(-2 pi i j k / n); inverse transforms
+// divide by n, so inverse(forward(x)) == x.
+class FFTPlan {
+public:
+    // constructor, threads = 0 uses every hardware thread for large transforms
+    explicit FFTPlan(size_t size, size_t threads = 0);
+
+    // accessors
+    size_t size() const;
+    size_t threads() const;
+    bool uses_bluestein() const;
+
+    // out-of-place transforms, in and out hold size() numbers and must not overlap
+    void forward(const Complex * in, Complex * out) const;
+    void inverse(const Complex * in, Complex * out) const;
+
+    std::vector<Complex> forward(const std::vector<Complex> & in) const;
+    std::vector<Complex> inverse(const std::vector<Complex> & in) const;
+
+    // in-place transforms
+    void forward_in_place(std::vector<Complex> & data) const;
+    void inverse_in_place(std::vector<Complex> & data) const;
+
+private:
+    void transform(const Complex * in, Complex * out) const;
+    void work(Complex * out, const Complex * in, size_t fstride, size_t stage, size_t threads) const;
+    void butterfly(Complex * out, size_t fstride, size_t radix, size_t m, size_t first, size_t last) const;
+    void bluestein(const Complex * in, Complex * out) const;
+    void check_size(size_t size) const;
+
+    size_t m_size;
+    size_t m_threads;
+    std::vector<size_t> m_factors;      // (radix, remaining size) for each stage
+    std::vector<Complex> m_twiddles;    // exp(-2 pi i k / size) for k < size
+
+    // Bluestein only
+    std::shared_ptr<const FFTPlan> m_inner;     // Power-of-two plan for the convolution
+    std::vector<Complex> m_chirp;               // exp(-pi i k^2 / size) for k < size
+    std::vector<Complex> m_chirpSpectrum;       // Forward transform of the conjugated, mirrored chirp
+};
+
+// Plan for transforms of real data. forward() returns the size / 2 + 1 non-negative frequencies, the rest
+// are their complex conjugates. Even sizes are done as a complex transform of half the size.
+class RealFFTPlan {
+public:
+    explicit RealFFTPlan(size_t size, size_t threads = 0);
+
+    size_t size() const;
+    size_t spectrum_size() const;
+
+    // in holds size() and out spectrum_size() numbers, or the other way around for inverse
+    void forward(const double * in, Complex * out) const;
+    void inverse(const Complex * in, double * out) const;
+
+    std::vector<Complex> forward(const std::vector<double> & in) const;
+    std::vector<double> inverse(const std::vector<Complex> & in) const;
+
+private:
+    size_t m_size;
+    FFTPlan m_plan;                     // Size / 2 for even sizes, size for odd sizes
+    std::vector<Complex> m_twiddles;    // exp(-2 pi i k / size) for k <= size / 2, even sizes only
+};
+
+// One-off transforms that build a plan on every call
+std::vector<Complex> fft(const std::vector<Complex> & in);
+std::vector<Complex> ifft(const std::vector<Complex> & in);
+std::vector<Complex> rfft(const std::vector<double> & in);
+std::vector<double> irfft(const std::vector<Complex> & in, size_t size);
+
+//
+// Implementations
+//
+
+constexpr double fft_pi = 3.14159265358979323846;
+
+// Largest prime factor done with a direct butterfly; sizes with a larger one use Bluestein
+constexpr size_t fft_bluestein_threshold = 64;
+
+// Transforms smaller than this run on the calling thread only
+constexpr size_t fft_parallel_threshold = size_t(1) << 15;
+
+// exp(-2 pi i k / n)
+inline Complex fft_twiddle(size_t k, size_t n) {
+    const double phase = -2.0 * fft_pi * static_cast<double>(k) / static_cast<double>(n);
+    return Complex(std::cos(phase), std::sin(phase));
+}
+
+// Complex conjugate
+constexpr Complex fft_conj(const Complex & c) noexcept {
+    return Complex(c.real(), -c.imag());
+}
+
+// Run f(first, last) over [0, count) split into at most threads contiguous ranges, the last one on the
+// calling thread. The first exception thrown by any range is rethrown after all threads are joined.
+template<typename F>
+void fft_parallel_for(size_t count, size_t threads, F f) {
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        f(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t t = 0; t + 1 < threads; t++) {
+        workers.emplace_back([&, t]() {
+            try {
+                f(t * chunk, std::min(count, (t + 1) * chunk));
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    try {
+        f((threads - 1) * chunk, count);
+    } catch (...) {
+        errors[threads - 1] = std::current_exception();
+    }
+    for (std::thread & worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr & error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// FFTPLAN
+
+// Factor the size, radix-4 first since its butterfly needs the fewest multiplications, and precompute twiddles
+inline FFTPlan::FFTPlan(size_t size, size_t threads) : m_size(size), m_threads(threads) {
+    if (size == 0) {
+        throw std::out_of_range("Invalid arguments. Transform size must be positive!");
+    }
+    if (m_threads == 0) {
+        m_threads = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+
+    size_t remaining = size;
+    size_t radix = 4;
+    while (remaining > 1) {
+        while (remaining % radix != 0) {
+            if (radix == 4) {
+                radix = 2;
+            } else if (radix == 2) {
+                radix = 3;
+            } else if (radix * radix > remaining) {
+                radix = remaining;  // What is left is prime
+            } else {
+                radix += 2;
+            }
+        }
+        if (radix > fft_bluestein_threshold) {
+            break;
+        }
+        remaining /= radix;
+        m_factors.push_back(radix);
+        m_factors.push_back(remaining);
+    }
+
+    if (remaining > 1) {
+        // Bluestein: with w[k] = exp(-pi i k^2 / n), X[k] = w[k] * sum of (x[j] * w[j]) * conj(w[k - j]),
+        // a linear convolution of length 2n - 1 done with a power-of-two transform
+        m_factors.clear();
+        size_t convolution = 1;
+        while (convolution < 2 * size - 1) {
+            convolution *= 2;
+        }
+        m_inner = std::make_shared<const FFTPlan>(convolution, m_threads);
+        m_chirp.resize(size);
+        for (size_t k = 0; k < size; k++) {
+            // k^2 mod 2n keeps the phase small, so it stays accurate for large k
+            const size_t square = static_cast<size_t>((static_cast<unsigned long long>(k) * k) % (2 * size));
+            const double phase = -fft_pi * static_cast<double>(square) / static_cast<double>(size);
+            m_chirp[k] = Complex(std::cos(phase), std::sin(phase));
+        }
+        std::vector<Complex> mirrored(convolution);
+        mirrored[0] = fft_conj(m_chirp[0]);
+        for (size_t k = 1; k < size; k++) {
+            mirrored[k] = fft_conj(m_chirp[k]);
+            mirrored[convolution - k] = fft_conj(m_chirp[k]);
+        }
+        m_chirpSpectrum = m_inner->forward(mirrored);
+        return;
+    }
+
+    m_twiddles.resize(size);
+    for (size_t k = 0; k < size; k++) {
+        m_twiddles[k] = fft_twiddle(k, size);
+    }
+}
+
+// Number of points
+inline size_t FFTPlan::size() const {
+    return m_size;
+}
+
+// Most threads a single transform uses
+inline size_t FFTPlan::threads() const {
+    return m_threads;
+}
+
+// True if the size has a prime factor above fft_bluestein_threshold
+inline bool FFTPlan::uses_bluestein() const {
+    return m_inner != nullptr;
+}
+
+// Forward transform
+inline void FFTPlan::forward(const Complex * in, Complex * out) const {
+    transform(in, out);
+}
+
+// Inverse transform, through conj(forward(conj(x))) / n
+inline void FFTPlan::inverse(const Complex * in, Complex * out) const {
+    std::vector<Complex> conjugated(in, in + m_size);
+    for (Complex & c : conjugated) {
+        c = fft_conj(c);
+    }
+    transform(conjugated.data(), out);
+    const double scale = 1.0 / static_cast<double>(m_size);
+    for (size_t k = 0; k < m_size; k++) {
+        out[k] = Complex(out[k].real() * scale, -out[k].imag() * scale);
+    }
+}
+
+// Forward transform into a new vector
+inline std::vector<Complex> FFTPlan::forward(const std::vector<Complex> & in) const {
+    check_size(in.size());
+    std::vector<Complex> out(m_size);
+    forward(in.data(), out.data());
+    return out;
+}
+
+// Inverse transform into a new vector
+inline std::vector<Complex> FFTPlan::inverse(const std::vector<Complex> & in) const {
+    check_size(in.size());
+    std::vector<Complex> out(m_size);
+    inverse(in.data(), out.data());
+    return out;
+}
+
+// Forward transform, replacing the input. Cooley-Tukey reorders its input, so this goes through a copy.
+inline void FFTPlan::forward_in_place(std::vector<Complex> & data) const {
+    check_size(data.size());
+    std::vector<Complex> in(data);
+    forward(in.data(), data.data());
+}
+
+// Inverse transform, replacing the input
+inline void FFTPlan::inverse_in_place(std::vector<Complex> & data) const {
+    check_size(data.size());
+    std::vector<Complex> in(data);
+    inverse(in.data(), data.data());
+}
+
+// Unnormalized forward transform
+inline void FFTPlan::transform(const Complex * in, Complex * out) const {
+    if (uses_bluestein()) {
+        bluestein(in, out);
+    } else if (m_size == 1) {
+        out[0] = in[0];
+    } else {
+        const size_t threads = (m_size >= fft_parallel_threshold) ? m_threads : 1;
+        work(out, in, 1, 0, threads);
+    }
+}
+
+// Decimation in time: transform the radix interleaved sub-sequences of in (every radix * fstride-th element)
+// into consecutive blocks of out, then combine the blocks with one butterfly pass. The sub-transforms and
+// the butterfly columns are independent, so both are split between threads.
+inline void FFTPlan::work(Complex * out, const Complex * in, size_t fstride, size_t stage, size_t threads) const {
+    const size_t radix = m_factors[2 * stage];
+    const size_t m = m_factors[2 * stage + 1];
+
+    if (m == 1) {
+        for (size_t j = 0; j < radix; j++) {
+            out[j] = in[j * fstride];
+        }
+    } else {
+        const size_t inner = std::max<size_t>(threads / radix, 1);
+        fft_parallel_for(radix, threads, [&](size_t first, size_t last) {
+            for (size_t j = first; j < last; j++) {
+                work(out + j * m, in + j * fstride, fstride * radix, stage + 1, inner);
+            }
+        });
+    }
+
+    fft_parallel_for(m, (m >= fft_parallel_threshold / radix) ? threads : 1, [&](size_t first, size_t last) {
+        butterfly(out, fstride, radix, m, first, last);
+    });
+}
+
+// Combine radix transforms of length m in out[q * m + k] for columns k in [first, last)
+inline void FFTPlan::butterfly(Complex * out, size_t fstride, size_t radix, size_t m, size_t first, size_t last) const {
+    const Complex * tw = m_twiddles.data();
+    if (radix == 2) {
+        for (size_t k = first; k < last; k++) {
+            const Complex t = out[k + m] * tw[k * fstride];
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+    } else if (radix == 4) {
+        for (size_t k = first; k < last; k++) {
+            const Complex s0 = out[k + m] * tw[k * fstride];
+            const Complex s1 = out[k + 2 * m] * tw[2 * k * fstride];
+            const Complex s2 = out[k + 3 * m] * tw[3 * k * fstride];
+            const Complex s5 = out[k] - s1;
+            const Complex s3 = s0 + s2;
+            const Complex s4 = s0 - s2;
+            const Complex s6 = out[k] + s1;
+            out[k] = s6 + s3;
+            out[k + 2 * m] = s6 - s3;
+            // s4 * -i and s4 * i
+            out[k + m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[k + 3 * m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+        }
+    } else {
+        // Direct DFT of length radix on every column, O(radix^2) per column
+        std::vector<Complex> scratch(radix);
+        for (size_t k = first; k < last; k++) {
+            for (size_t q = 0; q < radix; q++) {
+                scratch[q] = out[k + q * m];
+            }
+            for (size_t q1 = 0; q1 < radix; q1++) {
+                const size_t index = k + q1 * m;
+                const size_t step = fstride * index % m_size;
+                size_t twiddle = 0;
+                Complex sum = scratch[0];
+                for (size_t q = 1; q < radix; q++) {
+                    twiddle += step;
+                    if (twiddle >= m_size) {
+                        twiddle -= m_size;
+                    }
+                    sum += scratch[q] * tw[twiddle];
+                }
+                out[index] = sum;
+            }
+        }
+    }
+}
+
+// Bluestein's algorithm: chirp-multiply, convolve with the chirp through the inner plan, chirp-multiply again
+inline void FFTPlan::bluestein(const Complex * in, Complex * out) const {
+    const size_t convolution = m_inner->size();
+    std::vector<Complex> padded(convolution);
+    for (size_t k = 0; k < m_size; k++) {
+        padded[k] = in[k] * m_chirp[k];
+    }
+    std::vector<Complex> spectrum(convolution);
+    m_inner->forward(padded.data(), spectrum.data());
+    for (size_t k = 0; k < convolution; k++) {
+        spectrum[k] *= m_chirpSpectrum[k];
+    }
+    m_inner->inverse(spectrum.data(), padded.data());
+    for (size_t k = 0; k < m_size; k++) {
+        out[k] = padded[k] * m_chirp[k];
+    }
+}
+
+// Throw unless size matches the plan
+inline void FFTPlan::check_size(size_t size) const {
+    if (size != m_size) {
+        throw std::out_of_range("Invalid arguments. Wrong transform size!");
+    }
+}
+
+// REALFFTPLAN
+
+// Half-size complex plan for even sizes, full-size for odd sizes
+inline RealFFTPlan::RealFFTPlan(size_t size, size_t threads)
+    : m_size(size), m_plan((size % 2 == 0 && size > 0) ? size / 2 : size, threads) {
+    if (size % 2 == 0) {
+        m_twiddles.resize(size / 2 + 1);
+        for (size_t k = 0; k <= size / 2; k++) {
+            m_twiddles[k] = fft_twiddle(k, size);
+        }
+    }
+}
+
+// Number of real points
+inline size_t RealFFTPlan::size() const {
+    return m_size;
+}
+
+// Number of complex numbers in the spectrum
+inline size_t RealFFTPlan::spectrum_size() const {
+    return m_size / 2 + 1;
+}
+
+// Forward transform. For even sizes, z[j] = x[2j] + i x[2j+1] is transformed at half size and its spectrum Z
+// split into the transforms of the even (E) and odd (O) samples: X[k] = E[k] + exp(-2 pi i k / n) O[k].
+inline void RealFFTPlan::forward(const double * in, Complex * out) const {
+    if (m_size % 2 != 0) {
+        std::vector<Complex> full(in, in + m_size);
+        std::vector<Complex> spectrum(m_size);
+        m_plan.forward(full.data(), spectrum.data());
+        std::copy(spectrum.begin(), spectrum.begin() + spectrum_size(), out);
+        return;
+    }
+    const size_t half = m_size / 2;
+    std::vector<Complex> packed(half);
+    for (size_t j = 0; j < half; j++) {
+        packed[j] = Complex(in[2 * j], in[2 * j + 1]);
+    }
+    std::vector<Complex> z(half);
+    m_plan.forward(packed.data(), z.data());
+    for (size_t k = 0; k <= half; k++) {
+        const Complex zk = z[k % half];
+        const Complex zc = fft_conj(z[(half - k) % half]);
+        const Complex even = (zk + zc) * 0.5;
+        const Complex diff = zk - zc;
+        const Complex odd(diff.imag() * 0.5, -diff.real() * 0.5);     // (zk - zc) / 2i
+        out[k] = even + m_twiddles[k] * odd;
+    }
+}
+
+// Inverse transform, the spectrum of a real signal is Hermitian so only its first half is needed
+inline void RealFFTPlan::inverse(const Complex * in, double * out) const {
+    if (m_size % 2 != 0) {
+        std::vector<Complex> full(m_size);
+        for (size_t k = 0; k < m_size; k++) {
+            full[k] = (k < spectrum_size()) ? in[k] : fft_conj(in[m_size - k]);
+        }
+        std::vector<Complex> signal(m_size);
+        m_plan.inverse(full.data(), signal.data());
+        for (size_t j = 0; j < m_size; j++) {
+            out[j] = signal[j].real();
+        }
+        return;
+    }
+    const size_t half = m_size / 2;
+    std::vector<Complex> z(half);
+    for (size_t k = 0; k < half; k++) {
+        const Complex xk = in[k];
+        const Complex xc = fft_conj(in[half - k]);
+        const Complex even = (xk + xc) * 0.5;
+        const Complex odd = (xk - xc) * 0.5 * fft_conj(m_twiddles[k]);
+        z[k] = even + Complex(-odd.imag(), odd.real());                 // E + i O
+    }
+    std::vector<Complex> packed(half);
+    m_plan.inverse(z.data(), packed.data());
+    for (size_t j = 0; j < half; j++) {
+        out[2 * j] = packed[j].real();
+        out[2 * j + 1] = packed[j].imag();
+    }
+}
+
+// Forward transform into a new vector
+inline std::vector<Complex> RealFFTPlan::forward(const std::vector<double> & in) const {
+    if (in.size() != m_size) {
+        throw std::out_of_range("Invalid arguments. Wrong transform size!");
+    }
+    std::vector<Complex> out(spectrum_size());
+    forward(in.data(), out.data());
+    return out;
+}
+
+// Inverse transform into a new vector
+inline std::vector<double> RealFFTPlan::inverse(const std::vector<Complex> & in) const {
+    if (in.size() != spectrum_size()) {
+        throw std::out_of_range("Invalid arguments. Wrong transform size!");
+    }
+    std::vector<double> out(m_size);
+    inverse(in.data(), out.data());
+    return out;
+}
+
+// FUNCTIONS
+
+// Forward transform of any size
+inline std::vector<Complex> fft(const std::vector<Complex> & in) {
+    return FFTPlan(in.size()).forward(in);
+}
+
+// Inverse transform of any size
+inline std::vector<Complex> ifft(const std::vector<Complex> & in) {
+    return FFTPlan(in.size()).inverse(in);
+}
+
+// Non-negative frequencies of a real signal
+inline std::vector<Complex> rfft(const std::vector<double> & in) {
+    return RealFFTPlan(in.size()).forward(in);
+}
+
+// Real signal of the given size from its non-negative frequencies
+inline std::vector<double> irfft(const std::vector<Complex> & in, size_t size) {
+    return RealFFTPlan(size).inverse(in);
+}
+
+#endif //FFT_H
@@ -0,0 +1,252 @@
+/*
+* Fixed-point numbers for BasicComplex
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include "Complex.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+// Signed fixed-point number stored in 32 bits, FractionBits of them after the binary point: the value is
+// raw / 2^FractionBits. Products and quotients are computed in 64 bits and rounded to nearest. Results outside
+// the range saturate at the largest or smallest value instead of wrapping, as DSP fixed-point arithmetic does,
+// and division by zero saturates too, so arithmetic never throws.
+template<int FractionBits>
+class FixedPoint {
+    static_assert(FractionBits > 0 && FractionBits < 31, "FixedPoint needs 1 to 30 fraction bits");
+
+public:
+    // Constructors
+    constexpr FixedPoint() noexcept;
+    constexpr FixedPoint(int value) noexcept;
+    explicit constexpr FixedPoint(double value) noexcept;
+
+    static constexpr FixedPoint from_raw(int32_t raw) noexcept;
+
+    // Accessors
+    constexpr int32_t raw() const noexcept;
+    explicit constexpr operator double() const noexcept;
+
+    // Operators
+    constexpr FixedPoint & operator+=(FixedPoint other) noexcept;
+    constexpr FixedPoint & operator-=(FixedPoint other) noexcept;
+    constexpr FixedPoint & operator*=(FixedPoint other) noexcept;
+    constexpr FixedPoint & operator/=(FixedPoint other) noexcept;
+
+private:
+    static constexpr int32_t saturate(int64_t value) noexcept;
+
+    int32_t m_raw;
+};
+
+typedef FixedPoint<16> Fixed16;
+typedef BasicComplex<Fixed16> ComplexFixed16;
+
+template<int F> constexpr FixedPoint<F> operator-(FixedPoint<F> number) noexcept;
+template<int F> constexpr FixedPoint<F> operator+(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr FixedPoint<F> operator-(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr FixedPoint<F> operator*(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr FixedPoint<F> operator/(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+
+template<int F> constexpr bool operator==(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr bool operator!=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr bool operator<(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr bool operator>(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr bool operator<=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+template<int F> constexpr bool operator>=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept;
+
+template<int F> std::ostream & operator<<(std::ostream & os, FixedPoint<F> number);
+
+// Complex numbers with fixed-point parts. norm saturates once |z| passes about sqrt(32767) = 181 for Fixed16,
+// so ordering uses the exact square of the stored integers, which always fits in 64 bits.
+template<int F> constexpr uint64_t raw_norm(const BasicComplex<FixedPoint<F>> &number) noexcept;
+template<int F> constexpr bool operator<(const BasicComplex<FixedPoint<F>> &lhs, const BasicComplex<FixedPoint<F>> &rhs) noexcept;
+
+//
+// Implementations
+//
+
+// Clamp a 64-bit intermediate to the 32-bit range
+template<int F>
+constexpr int32_t FixedPoint<F>::saturate(int64_t value) noexcept {
+    if (value > std::numeric_limits<int32_t>::max()) {
+        return std::numeric_limits<int32_t>::max();
+    }
+    if (value < std::numeric_limits<int32_t>::min()) {
+        return std::numeric_limits<int32_t>::min();
+    }
+    return static_cast<int32_t>(value);
+}
+
+// CONSTRUCTORS
+
+// Zero
+template<int F>
+constexpr FixedPoint<F>::FixedPoint() noexcept : m_raw(0) {}
+
+// Whole number, implicit since it is exact within the range
+template<int F>
+constexpr FixedPoint<F>::FixedPoint(int value) noexcept : m_raw(saturate(static_cast<int64_t>(value) * (int64_t(1) << F))) {}
+
+// Nearest fixed-point value, nan becomes 0
+template<int F>
+constexpr FixedPoint<F>::FixedPoint(double value) noexcept : m_raw(0) {
+    const double scaled = value * static_cast<double>(int64_t(1) << F);
+    if (scaled >= static_cast<double>(std::numeric_limits<int32_t>::max())) {
+        m_raw = std::numeric_limits<int32_t>::max();
+    } else if (scaled <= static_cast<double>(std::numeric_limits<int32_t>::min())) {
+        m_raw = std::numeric_limits<int32_t>::min();
+    } else if (scaled == scaled) {
+        m_raw = static_cast<int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+}
+
+// From the stored integer
+template<int F>
+constexpr FixedPoint<F> FixedPoint<F>::from_raw(int32_t raw) noexcept {
+    FixedPoint number;
+    number.m_raw = raw;
+    return number;
+}
+
+// ACCESSORS
+
+// Stored integer, value * 2^FractionBits
+template<int F>
+constexpr int32_t FixedPoint<F>::raw() const noexcept {
+    return m_raw;
+}
+
+// Exact value as double
+template<int F>
+constexpr FixedPoint<F>::operator double() const noexcept {
+    return static_cast<double>(m_raw) / static_cast<double>(int64_t(1) << F);
+}
+
+// OPERATORS
+
+// += operator
+template<int F>
+constexpr FixedPoint<F> & FixedPoint<F>::operator+=(FixedPoint other) noexcept {
+    m_raw = saturate(static_cast<int64_t>(m_raw) + other.m_raw);
+    return *this;
+}
+
+// -= operator
+template<int F>
+constexpr FixedPoint<F> & FixedPoint<F>::operator-=(FixedPoint other) noexcept {
+    m_raw = saturate(static_cast<int64_t>(m_raw) - other.m_raw);
+    return *this;
+}
+
+// *= operator, the 64-bit product has 2 * FractionBits fraction bits and is rounded back to FractionBits
+template<int F>
+constexpr FixedPoint<F> & FixedPoint<F>::operator*=(FixedPoint other) noexcept {
+    const int64_t product = static_cast<int64_t>(m_raw) * other.m_raw;
+    m_raw = saturate((product + (int64_t(1) << (F - 1))) >> F);
+    return *this;
+}
+
+// /= operator, rounds to nearest; division by zero saturates towards the sign of the dividend
+template<int F>
+constexpr FixedPoint<F> & FixedPoint<F>::operator/=(FixedPoint other) noexcept {
+    if (other.m_raw == 0) {
+        m_raw = (m_raw < 0) ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int32_t>::max();
+        return *this;
+    }
+    const int64_t dividend = static_cast<int64_t>(m_raw) * (int64_t(1) << F);
+    const int64_t divisor = other.m_raw;
+    const int64_t half = ((dividend < 0) == (divisor < 0) ? divisor : -divisor) / 2;
+    m_raw = saturate((dividend + half) / divisor);
+    return *this;
+}
+
+// Unary -
+template<int F>
+constexpr FixedPoint<F> operator-(FixedPoint<F> number) noexcept {
+    return FixedPoint<F>() - number;
+}
+
+// Addition
+template<int F>
+constexpr FixedPoint<F> operator+(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs += rhs;
+}
+
+// Subtraction
+template<int F>
+constexpr FixedPoint<F> operator-(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs -= rhs;
+}
+
+// Multiplication
+template<int F>
+constexpr FixedPoint<F> operator*(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs *= rhs;
+}
+
+// Division
+template<int F>
+constexpr FixedPoint<F> operator/(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs /= rhs;
+}
+
+// Comparisons, on the stored integers
+template<int F>
+constexpr bool operator==(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() == rhs.raw();
+}
+
+template<int F>
+constexpr bool operator!=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() != rhs.raw();
+}
+
+template<int F>
+constexpr bool operator<(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() < rhs.raw();
+}
+
+template<int F>
+constexpr bool operator>(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() > rhs.raw();
+}
+
+template<int F>
+constexpr bool operator<=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() <= rhs.raw();
+}
+
+template<int F>
+constexpr bool operator>=(FixedPoint<F> lhs, FixedPoint<F> rhs) noexcept {
+    return lhs.raw() >= rhs.raw();
+}
+
+// re^2 + im^2 of the stored integers, i.e. norm scaled by 2^(2F). Each square is at most 2^62, so the sum fits.
+template<int F>
+constexpr uint64_t raw_norm(const BasicComplex<FixedPoint<F>> &number) noexcept {
+    const int64_t re = number.real().raw();
+    const int64_t im = number.imag().raw();
+    return static_cast<uint64_t>(re * re) + static_cast<uint64_t>(im * im);
+}
+
+// Less than operator on magnitudes, exact over the whole range
+template<int F>
+constexpr bool operator<(const BasicComplex<FixedPoint<F>> &lhs, const BasicComplex<FixedPoint<F>> &rhs) noexcept {
+    return raw_norm(lhs) < raw_norm(rhs);
+}
+
+// Output operator, prints the value as double
+template<int F>
+std::ostream & operator<<(std::ostream & os, FixedPoint<F> number) {
+    return os << static_cast<double>(number);
+}
+
+#endif //FIXEDPOINT_H
@@ -0,0 +1,313 @@
+/*
+* Polynomials with complex coefficients: evaluation and roots
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include "Complex.h"
+#include "ComplexArray.h"
+#include "FFT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// p(z) = c0 + c1 z + ... + cn z^n, stored lowest degree first. Zero leading coefficients are dropped, so
+// degree() is the true degree; the zero polynomial has degree 0 and the single coefficient 0.
+class Polynomial {
+public:
+    // constructors
+    Polynomial();
+    explicit Polynomial(const std::vector<Complex> & coefficients);
+    Polynomial(const std::initializer_list<Complex> & coefficients);
+
+    // leading * (z - roots[0]) * (z - roots[1]) * ...
+    static Polynomial from_roots(const std::vector<Complex> & roots, const Complex & leading = Complex(1));
+
+    // accessors
+    size_t degree() const;
+    const std::vector<Complex> & coefficients() const;
+    const Complex & operator[](size_t power) const;
+
+    // evaluation with Horner's rule, at one point or element-wise at every point of an array
+    Complex operator()(const Complex & z) const;
+    ComplexArray operator()(const ComplexArray & points) const;
+
+    Polynomial derivative() const;
+
+private:
+    std::vector<Complex> m_coefficients;
+};
+
+// Outcome of polynomial_roots
+struct PolynomialRoots {
+    std::vector<Complex> roots;     // degree() roots, repeated by multiplicity
+    size_t iterations = 0;
+    bool converged = false;         // False if some root was still moving after maxIterations
+};
+
+// All roots with the Ehrlich-Aberth iteration, which refines every root at once. An iteration takes O(n^2)
+// operations, split over threads for degrees from polynomial_parallel_threshold (threads = 0 uses every
+// hardware thread). A root stops moving when its correction is below tolerance relative to its size, or when
+// p is zero there to within the rounding error of evaluating it. Throws for polynomials of degree 0.
+PolynomialRoots polynomial_roots(const Polynomial & p, size_t threads = 0, double tolerance = 1e-14, size_t maxIterations = 500);
+
+//
+// Implementations
+//
+
+// Lower degrees find their roots on the calling thread only
+constexpr size_t polynomial_parallel_threshold = 256;
+
+// Points evaluated together by the array version of operator(), kept in L1 while every coefficient is applied
+constexpr size_t polynomial_block = 256;
+
+// CONSTRUCTORS
+
+// Zero polynomial
+inline Polynomial::Polynomial() : m_coefficients(1) {}
+
+// Coefficients lowest degree first, zero leading coefficients are dropped
+inline Polynomial::Polynomial(const std::vector<Complex> & coefficients) : m_coefficients(coefficients) {
+    while (m_coefficients.size() > 1 && m_coefficients.back() == Complex()) {
+        m_coefficients.pop_back();
+    }
+    if (m_coefficients.empty()) {
+        m_coefficients.push_back(Complex());
+    }
+}
+
+// Coefficients lowest degree first
+inline Polynomial::Polynomial(const std::initializer_list<Complex> & coefficients) : Polynomial(std::vector<Complex>(coefficients)) {}
+
+// Multiply out (z - r) for every root
+inline Polynomial Polynomial::from_roots(const std::vector<Complex> & roots, const Complex & leading) {
+    std::vector<Complex> coefficients(roots.size() + 1);
+    coefficients[0] = leading;
+    for (size_t k = 0; k < roots.size(); k++) {
+        // Multiply the degree-k polynomial in coefficients[0..k] by (z - roots[k])
+        for (size_t power = k + 1; power > 0; power--) {
+            coefficients[power] = coefficients[power - 1] - roots[k] * coefficients[power];
+        }
+        coefficients[0] = -roots[k] * coefficients[0];
+    }
+    return Polynomial(coefficients);
+}
+
+// ACCESSORS
+
+// Highest power with a non-zero coefficient
+inline size_t Polynomial::degree() const {
+    return m_coefficients.size() - 1;
+}
+
+// All coefficients, lowest degree first
+inline const std::vector<Complex> & Polynomial::coefficients() const {
+    return m_coefficients;
+}
+
+// Coefficient of z^power
+inline const Complex & Polynomial::operator[](size_t power) const {
+    if (power >= m_coefficients.size()) {
+        throw std::out_of_range("Invalid arguments. Power above the degree!");
+    }
+    return m_coefficients[power];
+}
+
+// EVALUATION
+
+// p(z) = (...(cn z + cn-1) z + ...) z + c0
+inline Complex Polynomial::operator()(const Complex & z) const {
+    Complex value = m_coefficients.back();
+    for (size_t k = m_coefficients.size() - 1; k > 0; k--) {
+        value *= z;
+        value += m_coefficients[k - 1];
+    }
+    return value;
+}
+
+// Horner's rule for a block of points at a time: the loop over the points of the block is the inner one, so
+// it works on whole vector registers of real and imaginary parts
+inline ComplexArray Polynomial::operator()(const ComplexArray & points) const {
+    const size_t n = points.size();
+    ComplexArray values(n);
+    const double * zr = points.real_data();
+    const double * zi = points.imag_data();
+    double * vr = values.real_data();
+    double * vi = values.imag_data();
+    const size_t top = m_coefficients.size() - 1;
+    for (size_t start = 0; start < n; start += polynomial_block) {
+        const size_t count = std::min(polynomial_block, n - start);
+        double re[polynomial_block];
+        double im[polynomial_block];
+        std::fill(re, re + count, m_coefficients[top].real());
+        std::fill(im, im + count, m_coefficients[top].imag());
+        for (size_t k = top; k > 0; k--) {
+            const double cr = m_coefficients[k - 1].real();
+            const double ci = m_coefficients[k - 1].imag();
+            for (size_t i = 0; i < count; i++) {
+                const double a = re[i];
+                re[i] = a * zr[start + i] - im[i] * zi[start + i] + cr;
+                im[i] = a * zi[start + i] + im[i] * zr[start + i] + ci;
+            }
+        }
+        std::copy(re, re + count, vr + start);
+        std::copy(im, im + count, vi + start);
+    }
+    return values;
+}
+
+// c1 + 2 c2 z + ... + n cn z^(n-1)
+inline Polynomial Polynomial::derivative() const {
+    if (degree() == 0) {
+        return Polynomial();
+    }
+    std::vector<Complex> coefficients(degree());
+    for (size_t k = 1; k < m_coefficients.size(); k++) {
+        coefficients[k - 1] = m_coefficients[k] * static_cast<double>(k);
+    }
+    return Polynomial(coefficients);
+}
+
+// ROOTS
+
+// Newton correction p(z)/p'(z), and whether p(z) is zero to within the rounding error of Horner's rule
+// (|p| <= 4 eps sum |ck| |z|^k). For |z| > 1 the reversed polynomial q(w) = z^-n p(z) in w = 1/z is
+// evaluated instead, so high degrees do not overflow: p/p' = z / (n - w q'(w)/q(w)).
+inline Complex polynomial_newton_correction(const std::vector<Complex> & c, const Complex & z, bool & atNoise) {
+    const size_t n = c.size() - 1;
+    const bool outside = norm(z) > 1.0;
+    const Complex x = outside ? divide_unchecked(Complex(1), z) : z;
+    const double absX = abs(x);
+    Complex value;
+    Complex slope;
+    double bound = 0;
+    for (size_t k = 0; k <= n; k++) {
+        const Complex & coefficient = outside ? c[k] : c[n - k];
+        slope = slope * x + value;
+        value = value * x + coefficient;
+        bound = bound * absX + abs(coefficient);
+    }
+    atNoise = abs(value) <= 4 * std::numeric_limits<double>::epsilon() * bound;
+    if (value == Complex()) {
+        return Complex();   // An exact root, where q'/q would be inf
+    }
+    if (!outside) {
+        return divide_unchecked(value, slope);
+    }
+    return divide_unchecked(z, static_cast<double>(n) - x * divide_unchecked(slope, value));
+}
+
+// Sum of 1 / (z - roots[j]) for j in [first, last), with partial sums so the loop vectorizes
+inline Complex polynomial_aberth_sum(const double * re, const double * im, size_t first, size_t last, const Complex & z) {
+    double sumRe[complex_array_partials] = {};
+    double sumIm[complex_array_partials] = {};
+    const double zr = z.real();
+    const double zi = z.imag();
+    size_t j = first;
+    for (; j + complex_array_partials <= last; j += complex_array_partials) {
+        for (size_t p = 0; p < complex_array_partials; p++) {
+            const double dr = zr - re[j + p];
+            const double di = zi - im[j + p];
+            const double scale = 1.0 / (dr * dr + di * di);
+            sumRe[p] += dr * scale;
+            sumIm[p] -= di * scale;
+        }
+    }
+    for (; j < last; j++) {
+        const double dr = zr - re[j];
+        const double di = zi - im[j];
+        const double scale = 1.0 / (dr * dr + di * di);
+        sumRe[0] += dr * scale;
+        sumIm[0] -= di * scale;
+    }
+    Complex total;
+    for (size_t p = 0; p < complex_array_partials; p++) {
+        total += Complex(sumRe[p], sumIm[p]);
+    }
+    return total;
+}
+
+// Ehrlich-Aberth: with N = p(zk)/p'(zk) and S = sum over j != k of 1/(zk - zj), every root moves by
+// N / (1 - N S) at once, using the previous positions of the others. Convergence is cubic for simple roots.
+// Roots equal to 0 are split off first; the others start on a circle whose radius is the geometric mean of
+// the root magnitudes, |c0/cn|^(1/n), at angles offset so no start is symmetric to another.
+inline PolynomialRoots polynomial_roots(const Polynomial & p, size_t threads, double tolerance, size_t maxIterations) {
+    if (p.degree() == 0) {
+        throw std::out_of_range("Invalid arguments. A constant has no roots!");
+    }
+    PolynomialRoots result;
+    const std::vector<Complex> & all = p.coefficients();
+    size_t zeros = 0;
+    while (all[zeros] == Complex()) {
+        zeros++;
+    }
+    result.roots.assign(zeros, Complex());
+    const std::vector<Complex> c(all.begin() + zeros, all.end());
+    const size_t n = c.size() - 1;
+    if (n == 0) {
+        result.converged = true;
+        return result;
+    }
+
+    if (threads == 0) {
+        threads = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+    if (n < polynomial_parallel_threshold) {
+        threads = 1;
+    }
+
+    // Current positions as two planes, for the vectorized sums
+    std::vector<double> re(n);
+    std::vector<double> im(n);
+    std::vector<double> nextRe(n);
+    std::vector<double> nextIm(n);
+    std::vector<char> done(n, 0);
+    const double radius = std::exp((std::log(abs(c[0])) - std::log(abs(c[n]))) / static_cast<double>(n));
+    for (size_t k = 0; k < n; k++) {
+        const double angle = 2 * fft_pi * static_cast<double>(k) / static_cast<double>(n) + 0.4;
+        re[k] = radius * std::cos(angle);
+        im[k] = radius * std::sin(angle);
+    }
+
+    for (result.iterations = 0; result.iterations < maxIterations && !result.converged; result.iterations++) {
+        fft_parallel_for(n, threads, [&](size_t first, size_t last) {
+            for (size_t k = first; k < last; k++) {
+                nextRe[k] = re[k];
+                nextIm[k] = im[k];
+                if (done[k]) {
+                    continue;
+                }
+                const Complex z(re[k], im[k]);
+                bool atNoise = false;
+                const Complex newton = polynomial_newton_correction(c, z, atNoise);
+                const Complex sum = polynomial_aberth_sum(re.data(), im.data(), 0, k, z) +
+                                    polynomial_aberth_sum(re.data(), im.data(), k + 1, n, z);
+                const Complex step = divide_unchecked(newton, 1.0 - newton * sum);
+                if (!std::isfinite(step.real()) || !std::isfinite(step.imag())) {
+                    continue;   // p'(z) = 0 or z met another root; the others moving changes S next time
+                }
+                nextRe[k] = re[k] - step.real();
+                nextIm[k] = im[k] - step.imag();
+                done[k] = atNoise || abs(step) <= tolerance * abs(z);
+            }
+        });
+        re.swap(nextRe);
+        im.swap(nextIm);
+        result.converged = std::all_of(done.begin(), done.end(), [](char d) { return d != 0; });
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        result.roots.push_back(Complex(re[k], im[k]));
+    }
+    return result;
+}
+
+#endif //POLYNOMIAL_H
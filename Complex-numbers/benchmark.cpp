@@ -0,0 +1,555 @@
+// To compile: g++ -O3 -march=native -o benchmark benchmark.cpp -pthread
+// Usage: ./benchmark [elements, default 10000000]
+// Vectorization: add -fopt-info-vec-optimized to the compile line. GCC then reports "loop vectorized" for the
+//       Complex multiply-add and divide_unchecked loops below, the same as for the loop over plain doubles.
+//       Loops calling sqrt (abs) only vectorize with -fno-math-errno, since sqrt may otherwise have to set errno.
+
+#include "Complex.h"
+#include "ComplexArray.h"
+#include "FFT.h"
+#include "ComplexIO.h"
+#include "ComplexFile.h"
+#include "ComplexMath.h"
+#include "Polynomial.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <complex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Run f once and return the elapsed time in milliseconds
+template<typename F>
+double time_ms(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(stop - start).count();
+}
+
+// y = a * x + y with Complex, ComplexF or ComplexLD
+template<typename T>
+void complexAxpy(BasicComplex<T> a, const BasicComplex<T> * x, BasicComplex<T> * y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] += a * x[i];
+    }
+}
+
+// The same loop written out on interleaved (real, imaginary) doubles
+void doubleAxpy(double ar, double ai, const double * x, double * y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double xr = x[2 * i];
+        double xi = x[2 * i + 1];
+        y[2 * i] += ar * xr - ai * xi;
+        y[2 * i + 1] += ar * xi + ai * xr;
+    }
+}
+
+// Element-wise quotients with the checked operator/
+void checkedDivide(const Complex * x, const Complex * y, Complex * out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = x[i] / y[i];
+    }
+}
+
+// Element-wise quotients without the zero check
+void uncheckedDivide(const Complex * x, const Complex * y, Complex * out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = divide_unchecked(x[i], y[i]);
+    }
+}
+
+// Complex multiply-add and division vs hand-written double loops
+void arithmeticTest(size_t n) {
+    cout << "Complex arithmetic on " << n << " elements, 10 passes" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(0.5, 1.5);
+    vector<Complex> x(n);
+    vector<Complex> y(n);
+    vector<Complex> out(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = Complex(dist(rng), dist(rng));
+        y[i] = Complex(dist(rng), dist(rng));
+    }
+    vector<double> xd(2 * n);
+    vector<double> yd(2 * n);
+    for (size_t i = 0; i < n; i++) {
+        xd[2 * i] = x[i].real();
+        xd[2 * i + 1] = x[i].imag();
+        yd[2 * i] = y[i].real();
+        yd[2 * i + 1] = y[i].imag();
+    }
+
+    Complex a(0.999, 0.001);
+    double complexMs = time_ms([&] {
+        for (int pass = 0; pass < 10; pass++) {
+            complexAxpy(a, x.data(), y.data(), n);
+        }
+    });
+    double doubleMs = time_ms([&] {
+        for (int pass = 0; pass < 10; pass++) {
+            doubleAxpy(a.real(), a.imag(), xd.data(), yd.data(), n);
+        }
+    });
+    double checkedMs = time_ms([&] {
+        for (int pass = 0; pass < 10; pass++) {
+            x[pass] += 1.0; // Changes the inputs, so the compiler cannot drop repeated passes
+            checkedDivide(x.data(), y.data(), out.data(), n);
+        }
+    });
+    double uncheckedMs = time_ms([&] {
+        for (int pass = 0; pass < 10; pass++) {
+            x[pass] += 1.0; // Changes the inputs, so the compiler cannot drop repeated passes
+            uncheckedDivide(x.data(), y.data(), out.data(), n);
+        }
+    });
+
+    // Both multiply-add loops must agree, otherwise the comparison is meaningless
+    double maxDiff = 0;
+    for (size_t i = 0; i < n; i++) {
+        maxDiff = max(maxDiff, abs(y[i] - Complex(yd[2 * i], yd[2 * i + 1])));
+    }
+
+    cout << fixed << setprecision(1);
+    cout << "multiply-add: Complex " << complexMs << " ms, doubles " << doubleMs << " ms (max difference "
+         << scientific << setprecision(1) << maxDiff << ")" << endl;
+    cout << fixed << setprecision(1);
+    cout << "division: operator/ " << checkedMs << " ms, divide_unchecked " << uncheckedMs << " ms" << endl;
+}
+
+// The same multiply-add in float, double and long double. Float moves half the bytes of double per element and
+// fits twice as many numbers in a vector register.
+template<typename T>
+double precisionAxpyMs(size_t n) {
+    vector<BasicComplex<T>> x(n);
+    vector<BasicComplex<T>> y(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = BasicComplex<T>(T(i % 7) / 8, T(i % 5) / 8);
+        y[i] = BasicComplex<T>(T(i % 3) / 8, 1);
+    }
+    BasicComplex<T> a(T(0.999), T(0.001));
+    return time_ms([&] {
+        for (int pass = 0; pass < 10; pass++) {
+            complexAxpy(a, x.data(), y.data(), n);
+        }
+    });
+}
+
+void precisionTest(size_t n) {
+    cout << "Multiply-add on " << n << " elements per precision, 10 passes" << endl;
+    double floatMs = precisionAxpyMs<float>(n);
+    double doubleMs = precisionAxpyMs<double>(n);
+    double longDoubleMs = precisionAxpyMs<long double>(n);
+    cout << fixed << setprecision(1);
+    cout << "ComplexF " << floatMs << " ms, Complex " << doubleMs << " ms, ComplexLD " << longDoubleMs << " ms" << endl;
+}
+
+// Interleaved std::vector<Complex> loops vs the split planes of ComplexArray, in place where the API allows it.
+// The arrays fit in L2 and are processed repeatedly, so the loops are limited by arithmetic, not memory bandwidth.
+void arrayTest(size_t elements) {
+    const size_t n = 4096;
+    const size_t passes = max<size_t>(elements / n, 1);
+    cout << "vector<Complex> vs ComplexArray, " << passes << " passes over " << n << " elements" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(0.5, 1.5);
+    vector<Complex> x(n);
+    vector<Complex> y(n);
+    for (size_t i = 0; i < n; i++) {
+        double angle = dist(rng);
+        x[i] = Complex(dist(rng), dist(rng));
+        y[i] = Complex(cos(angle), sin(angle)); // |y| = 1, so repeated products stay in range
+    }
+    ComplexArray xa(x);
+    ComplexArray ya(y);
+    Complex vectorDot;
+    Complex arrayDot;
+
+    double vectorMulMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (size_t i = 0; i < n; i++) {
+                x[i] *= y[i];
+            }
+        }
+    });
+    double arrayMulMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            xa *= ya;
+        }
+    });
+    double vectorDivMs = time_ms([&] { // Undoes the products, so x stays in range
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (size_t i = 0; i < n; i++) {
+                x[i] /= y[i];
+            }
+        }
+    });
+    double arrayDivMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            xa /= ya;
+        }
+    });
+    double vectorAbsMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            x[pass % n] += 1.0;
+            vector<double> magnitudes(n);
+            for (size_t i = 0; i < n; i++) {
+                magnitudes[i] = abs(x[i]);
+            }
+            vectorDot += magnitudes[pass % n];
+        }
+    });
+    double arrayAbsMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            xa.real_data()[pass % n] += 1.0;
+            arrayDot += abs(xa)[pass % n];
+        }
+    });
+    double vectorDotMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            x[pass % n] += 1.0; // Changes the inputs, so the compiler cannot hoist the loop out of the passes
+            Complex total;
+            for (size_t i = 0; i < n; i++) {
+                total += x[i] * y[i];
+            }
+            vectorDot += total;
+        }
+    });
+    double arrayDotMs = time_ms([&] {
+        for (size_t pass = 0; pass < passes; pass++) {
+            xa.real_data()[pass % n] += 1.0;
+            arrayDot += dot(xa, ya);
+        }
+    });
+
+    cout << fixed << setprecision(1);
+    cout << "multiply: vector " << vectorMulMs << " ms, array " << arrayMulMs << " ms | divide: vector " << vectorDivMs
+         << " ms, array " << arrayDivMs << " ms" << endl;
+    cout << "abs: vector " << vectorAbsMs << " ms, array " << arrayAbsMs << " ms | dot: vector " << vectorDotMs
+         << " ms, array " << arrayDotMs << " ms (relative difference " << scientific << setprecision(1)
+         << abs(vectorDot - arrayDot) / abs(vectorDot) << ")" << endl;
+}
+
+// Microseconds per transform for power-of-two, mixed-radix and prime (Bluestein) sizes, with a reused plan,
+// a plan built for every call and a reused single-threaded plan
+void fftTest() {
+    cout << "FFT, microseconds per transform (" << thread::hardware_concurrency() << " hardware threads)" << endl;
+    for (size_t n : {1024, 1000, 1009, 65536, 65537, 1 << 20}) {
+        vector<Complex> x(n);
+        for (size_t j = 0; j < n; j++) {
+            x[j] = Complex(sin(0.37 * j), cos(1.3 * j));
+        }
+        vector<Complex> out(n);
+        const size_t repeats = max<size_t>((size_t(1) << 22) / n, 1);
+
+        FFTPlan plan(n);
+        FFTPlan serial(n, 1);
+        double planMs = time_ms([&] {
+            for (size_t r = 0; r < repeats; r++) {
+                plan.forward(x.data(), out.data());
+            }
+        });
+        double oneOffMs = time_ms([&] {
+            for (size_t r = 0; r < repeats; r++) {
+                out = fft(x);
+            }
+        });
+        double serialMs = time_ms([&] {
+            for (size_t r = 0; r < repeats; r++) {
+                serial.forward(x.data(), out.data());
+            }
+        });
+
+        vector<double> real(n);
+        for (size_t j = 0; j < n; j++) {
+            real[j] = x[j].real();
+        }
+        RealFFTPlan realPlan(n);
+        vector<Complex> spectrum(realPlan.spectrum_size());
+        double realMs = time_ms([&] {
+            for (size_t r = 0; r < repeats; r++) {
+                realPlan.forward(real.data(), spectrum.data());
+            }
+        });
+
+        cout << fixed << setprecision(1);
+        cout << "n = " << n << (plan.uses_bluestein() ? " (Bluestein)" : "") << ": plan " << 1000 * planMs / repeats
+             << " us, one-off " << 1000 * oneOffMs / repeats << " us, 1 thread " << 1000 * serialMs / repeats
+             << " us, real input " << 1000 * realMs / repeats << " us" << endl;
+    }
+
+    // The direct transform the FFT replaces
+    const size_t n = 1024;
+    vector<Complex> x(n, Complex(1, 1));
+    vector<Complex> out(n);
+    double naiveMs = time_ms([&] {
+        for (size_t k = 0; k < n; k++) {
+            Complex sum;
+            for (size_t j = 0; j < n; j++) {
+                sum += x[j] * fft_twiddle(j * k % n, n);
+            }
+            out[k] = sum;
+        }
+    });
+    cout << "n = 1024 direct DFT: " << 1000 * naiveMs << " us" << endl;
+}
+
+// Sorting by magnitude with the old comparison (two abs calls, each with two pow calls) vs operator<, which
+// compares norm; then old abs vs the overflow-safe abs
+void sortTest(size_t n) {
+    cout << "Sorting " << n << " Complex numbers by magnitude" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    vector<Complex> numbers(n);
+    for (Complex & c : numbers) {
+        c = Complex(dist(rng), dist(rng));
+    }
+    auto powAbs = [](const Complex & c) { return sqrt(pow(c.real(), 2) + pow(c.imag(), 2)); };
+
+    vector<Complex> before(numbers);
+    vector<Complex> after(numbers);
+    double beforeMs = time_ms([&] {
+        sort(before.begin(), before.end(), [&](const Complex & lhs, const Complex & rhs) { return powAbs(lhs) < powAbs(rhs); });
+    });
+    double afterMs = time_ms([&] { sort(after.begin(), after.end()); });
+
+    vector<double> magnitudes(n);
+    double powAbsMs = time_ms([&] {
+        for (size_t i = 0; i < n; i++) {
+            magnitudes[i] = powAbs(numbers[i]);
+        }
+    });
+    double maxDiff = 0;
+    double absMs = time_ms([&] {
+        for (size_t i = 0; i < n; i++) {
+            maxDiff = max(maxDiff, fabs(magnitudes[i] - abs(numbers[i])));
+        }
+    });
+
+    cout << fixed << setprecision(1);
+    cout << "sort: before " << beforeMs << " ms, after " << afterMs << " ms (same order: "
+         << (before == after ? "yes" : "no") << ")" << endl;
+    cout << "abs: sqrt(pow + pow) " << powAbsMs << " ms, abs " << absMs << " ms (max difference " << scientific
+         << setprecision(1) << maxDiff << ")" << endl;
+}
+
+// Text input and output of n numbers, one per line: iostream operators vs the bulk from_chars/to_chars functions
+void ioTest(size_t n) {
+    cout << "Text I/O of " << n << " Complex numbers" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    vector<Complex> numbers(n);
+    for (Complex & c : numbers) {
+        c = Complex(dist(rng), dist(rng));
+    }
+
+    string streamText;
+    double streamOutMs = time_ms([&] {
+        ostringstream os;
+        for (const Complex & c : numbers) {
+            os << c << '\n';
+        }
+        streamText = os.str();
+    });
+    string bulkText;
+    double bulkOutMs = time_ms([&] { bulkText = format_complex_array(numbers.data(), numbers.size()); });
+
+    vector<Complex> streamParsed(n);
+    double streamInMs = time_ms([&] {
+        istringstream is(bulkText);
+        for (Complex & c : streamParsed) {
+            is >> c;
+        }
+    });
+    vector<Complex> bulkParsed(n);
+    ComplexParseResult result;
+    double bulkInMs = time_ms([&] { result = parse_complex_array(bulkText.data(), bulkText.data() + bulkText.size(), bulkParsed.data(), n); });
+
+    cout << fixed << setprecision(1);
+    cout << "output: operator<< " << streamOutMs << " ms (" << streamText.size() / 1e6 << " MB, 6 digits), format_complex_array "
+         << bulkOutMs << " ms (" << bulkText.size() / 1e6 << " MB, exact)" << endl;
+    cout << "input: operator>> " << streamInMs << " ms, parse_complex_array " << bulkInMs << " ms ("
+         << result.count << " parsed, round trip " << (bulkParsed == numbers ? "exact" : "inexact") << ")" << endl;
+}
+
+// Binary sample files of n numbers: chunked writes and reads in each format, and summing through a mapped view
+void fileTest(size_t n) {
+    cout << "Sample files of " << n << " Complex numbers" << endl;
+    const string path = "complex_benchmark.cplx";
+    const size_t chunk = 1 << 16;
+    vector<Complex> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = Complex(i * 0.5, -(i * 0.25));
+    }
+    vector<Complex> buffer(chunk);
+
+    cout << fixed << setprecision(1);
+    for (ComplexLayout layout : {ComplexLayout::Interleaved, ComplexLayout::Planar}) {
+        for (ComplexPrecision precision : {ComplexPrecision::Float64, ComplexPrecision::Float32}) {
+            const double megabytes = n * 2.0 * static_cast<size_t>(precision) / 1e6;
+            double writeMs = time_ms([&] {
+                ComplexFileWriter writer(path, layout, precision, n);
+                for (size_t first = 0; first < n; first += chunk) {
+                    writer.write(samples.data() + first, min(chunk, n - first));
+                }
+                writer.close();
+            });
+            Complex total;
+            double readMs = time_ms([&] {
+                ComplexFileReader reader(path);
+                while (size_t count = reader.read(buffer.data(), buffer.size())) {
+                    for (size_t i = 0; i < count; i++) {
+                        total += buffer[i];
+                    }
+                }
+            });
+            cout << (layout == ComplexLayout::Planar ? "planar " : "interleaved ")
+                 << (precision == ComplexPrecision::Float32 ? "float: " : "double: ") << "write "
+                 << megabytes / writeMs * 1e3 << " MB/s, chunked read and sum " << megabytes / readMs * 1e3
+                 << " MB/s (sum " << total << ")" << endl;
+        }
+    }
+
+    write_complex_file(path, samples);
+    Complex total;
+    double viewMs = time_ms([&] {
+        ComplexFileView view(path);
+        for (const Complex & c : view) {
+            total += c;
+        }
+    });
+    cout << "interleaved double: mapped view sum " << n * 16.0 / viewMs / 1e3 << " MB/s (sum " << total << ")" << endl;
+    remove(path.c_str());
+}
+
+// exp, log, sqrt and pow over n numbers: std::complex, the scalar Complex functions and the ComplexArray kernels
+void transcendentalTest(size_t n) {
+    cout << "Transcendental functions on " << n << " elements" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(-10.0, 10.0);
+    vector<Complex> numbers(n);
+    vector<complex<double>> stdNumbers(n);
+    for (size_t i = 0; i < n; i++) {
+        numbers[i] = Complex(dist(rng), dist(rng));
+        stdNumbers[i] = complex<double>(numbers[i].real(), numbers[i].imag());
+    }
+    const ComplexArray array(numbers);
+    vector<Complex> out(n);
+    vector<complex<double>> stdOut(n);
+    ComplexArray arrayOut;
+
+    const Complex w(0.5, -1.5);
+    const complex<double> stdW(0.5, -1.5);
+    cout << fixed << setprecision(1);
+    auto report = [&](const char * name, double stdMs, double scalarMs, double arrayMs) {
+        double maxDiff = 0;
+        for (size_t i = 0; i < n; i++) {
+            maxDiff = max(maxDiff, abs(out[i] - arrayOut[i]) / max(abs(out[i]), 1e-300));
+        }
+        cout << name << ": std::complex " << stdMs << " ms, Complex " << scalarMs << " ms, ComplexArray " << arrayMs
+             << " ms (max relative difference " << scientific << setprecision(1) << maxDiff << fixed << ")" << endl;
+    };
+
+    double stdMs = time_ms([&] { for (size_t i = 0; i < n; i++) stdOut[i] = std::exp(stdNumbers[i]); });
+    double scalarMs = time_ms([&] { for (size_t i = 0; i < n; i++) out[i] = exp(numbers[i]); });
+    double arrayMs = time_ms([&] { arrayOut = exp(array); });
+    report("exp", stdMs, scalarMs, arrayMs);
+
+    stdMs = time_ms([&] { for (size_t i = 0; i < n; i++) stdOut[i] = std::log(stdNumbers[i]); });
+    scalarMs = time_ms([&] { for (size_t i = 0; i < n; i++) out[i] = log(numbers[i]); });
+    arrayMs = time_ms([&] { arrayOut = log(array); });
+    report("log", stdMs, scalarMs, arrayMs);
+
+    stdMs = time_ms([&] { for (size_t i = 0; i < n; i++) stdOut[i] = std::sqrt(stdNumbers[i]); });
+    scalarMs = time_ms([&] { for (size_t i = 0; i < n; i++) out[i] = sqrt(numbers[i]); });
+    arrayMs = time_ms([&] { arrayOut = sqrt(array); });
+    report("sqrt", stdMs, scalarMs, arrayMs);
+
+    stdMs = time_ms([&] { for (size_t i = 0; i < n; i++) stdOut[i] = std::pow(stdNumbers[i], stdW); });
+    scalarMs = time_ms([&] { for (size_t i = 0; i < n; i++) out[i] = pow(numbers[i], w); });
+    arrayMs = time_ms([&] { arrayOut = pow(array, w); });
+    report("pow", stdMs, scalarMs, arrayMs);
+}
+
+// Degree-1000 polynomial with random coefficients: Horner at one point at a time vs over an array of points,
+// and all roots with one thread vs every hardware thread
+void polynomialTest() {
+    const size_t degree = 1000;
+    const size_t points = 100000;
+    cout << "Polynomial of degree " << degree << ", " << points << " evaluation points" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    vector<Complex> coefficients(degree + 1);
+    for (Complex & c : coefficients) {
+        c = Complex(dist(rng), dist(rng));
+    }
+    const Polynomial p(coefficients);
+    vector<Complex> z(points);
+    for (Complex & x : z) {
+        x = Complex(dist(rng), dist(rng));
+    }
+    const ComplexArray zArray(z);
+
+    vector<Complex> scalarValues(points);
+    double scalarMs = time_ms([&] {
+        for (size_t i = 0; i < points; i++) {
+            scalarValues[i] = p(z[i]);
+        }
+    });
+    ComplexArray arrayValues;
+    double arrayMs = time_ms([&] { arrayValues = p(zArray); });
+    double maxDiff = 0;
+    for (size_t i = 0; i < points; i++) {
+        maxDiff = max(maxDiff, abs(scalarValues[i] - arrayValues[i]) / max(abs(scalarValues[i]), 1e-300));
+    }
+
+    cout << fixed << setprecision(1);
+    cout << "evaluation: Complex " << scalarMs << " ms, ComplexArray " << arrayMs << " ms (max relative difference "
+         << scientific << setprecision(1) << maxDiff << fixed << ")" << endl;
+
+    vector<size_t> threadCounts{1};
+    if (thread::hardware_concurrency() > 1) {
+        threadCounts.push_back(thread::hardware_concurrency());
+    }
+    for (size_t threads : threadCounts) {
+        PolynomialRoots roots;
+        double rootsMs = time_ms([&] { roots = polynomial_roots(p, threads); });
+        double worst = 0;   // Largest |p(r)| relative to the rounding error bound sum |ck| |r|^k
+        for (const Complex & r : roots.roots) {
+            double bound = 0;
+            for (size_t k = degree + 1; k > 0; k--) {
+                bound = bound * abs(r) + abs(coefficients[k - 1]);
+            }
+            worst = max(worst, abs(p(r)) / (bound * numeric_limits<double>::epsilon()));
+        }
+        cout << "roots, " << threads << " thread(s): " << rootsMs << " ms, " << roots.iterations << " iterations, "
+             << (roots.converged ? "converged" : "not converged") << ", max |p(r)| " << worst << " eps sum |ck||r|^k" << endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t elements = (argc > 1) ? stoull(argv[1]) : 10000000;
+
+    arithmeticTest(elements);
+    cout << "\n";
+    precisionTest(elements);
+    cout << "\n";
+    arrayTest(elements);
+    cout << "\n";
+    fftTest();
+    cout << "\n";
+    sortTest(elements);
+    cout << "\n";
+    ioTest(elements / 10);
+    cout << "\n";
+    fileTest(elements);
+    cout << "\n";
+    transcendentalTest(elements / 10);
+    cout << "\n";
+    polynomialTest();
+}
@@ -0,0 +1,221 @@
+// Complex against std::complex<double>, operation by operation
+//
+// To compile: g++ -O3 -march=native -o compare compare.cpp
+// Usage: ./compare [label, printed with the results] [elements, default 100000]
+// "make compare" builds and runs it with -O2 and -O3 -march=native, each with and without -ffast-math.
+// Every line gives nanoseconds per element for both types and their ratio; "slower" marks operations where
+// Complex takes more than 10% longer than std::complex. The default size keeps the arrays in L2, so the
+// arithmetic is compared rather than memory bandwidth. Both types are measured in turn several times and the
+// fastest run of each operation counts, which filters out most of the noise of a shared machine.
+
+#include "Complex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Run f once and return the elapsed time in milliseconds
+template<typename F>
+double time_ms(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(stop - start).count();
+}
+
+// Passes over the data per measurement. Each pass changes one input first, so the compiler cannot drop
+// repeated passes over the same data.
+const int passes = 20;
+
+// Smallest element count: every pass changes its own element, and the text lines use a tenth of the elements
+const size_t min_elements = 10 * passes;
+
+// Measurements of each type, alternating between the types
+const int repeats = 5;
+
+// Ordering by magnitude: operator< for Complex, which std::complex does not have
+bool lessByNorm(const Complex & lhs, const Complex & rhs) {
+    return lhs < rhs;
+}
+
+bool lessByNorm(const complex<double> & lhs, const complex<double> & rhs) {
+    return norm(lhs) < norm(rhs);
+}
+
+// Milliseconds of every measured operation for one number type
+struct Timings {
+    vector<string> names;
+    vector<double> ms;
+    double checksum = 0;    // Printed, so no result can be optimized away
+
+    void add(const string & name, double time) {
+        names.push_back(name);
+        ms.push_back(time);
+    }
+
+    // Keep the faster time of each operation
+    void keep_fastest(const Timings & other) {
+        for (size_t k = 0; k < ms.size(); k++) {
+            ms[k] = min(ms[k], other.ms[k]);
+        }
+    }
+};
+
+// All measurements for the number type C on the same inputs
+template<typename C>
+Timings measure(const vector<double> & parts, size_t n) {
+    Timings timings;
+    vector<C> x(n);
+    vector<C> y(n);
+    vector<C> out(n);
+    vector<double> magnitudes(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = C(parts[4 * i], parts[4 * i + 1]);
+        y[i] = C(parts[4 * i + 2], parts[4 * i + 3]);
+    }
+
+    timings.add("add", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = x[i] + y[i];
+            }
+        }
+    }));
+    timings.checksum += out[n / 2].real();
+
+    timings.add("multiply", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = x[i] * y[i];
+            }
+        }
+    }));
+    timings.checksum += out[n / 2].real();
+
+    timings.add("divide", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = x[i] / y[i];
+            }
+        }
+    }));
+    timings.checksum += out[n / 2].real();
+
+    timings.add("abs", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                magnitudes[i] = abs(x[i]);
+            }
+        }
+    }));
+    timings.checksum += magnitudes[n / 2];
+
+    size_t count = 0;
+    timings.add("compare (==, <)", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                count += (x[i] == y[i]) + lessByNorm(x[i], y[i]);
+            }
+        }
+    }));
+    timings.checksum += count;
+
+    // Array loops: y = a x + y, then the reductions sum(x) and sum(x * y)
+    const C a(0.999, 0.001);
+    timings.add("multiply-add loop", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            for (size_t i = 0; i < n; i++) {
+                y[i] += a * x[i];
+            }
+        }
+    }));
+    timings.checksum += y[n / 2].real();
+
+    C total;
+    timings.add("sum", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                total += x[i];
+            }
+        }
+    }));
+    timings.add("dot product", time_ms([&] {
+        for (int pass = 0; pass < passes; pass++) {
+            x[pass] += C(1.0);
+            for (size_t i = 0; i < n; i++) {
+                total += x[i] * y[i];
+            }
+        }
+    }));
+    timings.checksum += total.real();
+
+    // Text: one pass each, iostream operators for both types
+    const size_t textCount = n / 10;
+    string text;
+    timings.add("print", time_ms([&] {
+        ostringstream os;
+        for (size_t i = 0; i < textCount; i++) {
+            os << x[i] << '\n';
+        }
+        text = os.str();
+    }) * passes * n / textCount);  // Scaled as if all passes had covered n elements, like the other lines
+    timings.add("parse", time_ms([&] {
+        istringstream is(text);
+        for (size_t i = 0; i < textCount; i++) {
+            is >> out[i];
+        }
+    }) * passes * n / textCount);
+    timings.checksum += out[0].real();
+    return timings;
+}
+
+int main(int argc, char **argv) {
+    const string label = (argc > 1) ? argv[1] : "";
+    const size_t n = (argc > 2) ? stoull(argv[2]) : 100000;
+    if (n < min_elements) {
+        cerr << "Usage: compare [label] [elements], with at least " << min_elements << " elements" << endl;
+        return 1;
+    }
+
+    default_random_engine rng(020416);
+    uniform_real_distribution<double> dist(0.5, 1.5);
+    vector<double> parts(4 * n);
+    for (double & part : parts) {
+        part = dist(rng);
+    }
+
+    Timings mine = measure<Complex>(parts, n);
+    Timings standard = measure<complex<double>>(parts, n);
+    for (int repeat = 1; repeat < repeats; repeat++) {
+        mine.keep_fastest(measure<Complex>(parts, n));
+        standard.keep_fastest(measure<complex<double>>(parts, n));
+    }
+
+    cout << "Complex vs std::complex<double> on " << n << " elements" << (label.empty() ? "" : ", " + label) << endl;
+    cout << left << setw(20) << "operation" << right << setw(12) << "Complex" << setw(16) << "std::complex" << setw(9) << "ratio" << endl;
+    size_t slower = 0;
+    const double toNsPerElement = 1e6 / (static_cast<double>(passes) * static_cast<double>(n));
+    for (size_t k = 0; k < mine.names.size(); k++) {
+        const double ratio = mine.ms[k] / standard.ms[k];
+        slower += ratio > 1.1;
+        cout << left << setw(20) << mine.names[k] << right << fixed << setprecision(2)
+             << setw(9) << mine.ms[k] * toNsPerElement << " ns" << setw(13) << standard.ms[k] * toNsPerElement << " ns"
+             << setw(9) << ratio << (ratio > 1.1 ? "  slower" : "") << endl;
+    }
+    cout << slower << " of " << mine.names.size() << " operations more than 10% slower than std::complex"
+         << " (checksums " << setprecision(6) << mine.checksum << ", " << standard.checksum << ")" << endl;
+}
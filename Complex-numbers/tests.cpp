@@ -1,4 +1,12 @@
 #include "Complex.h"
+#include "ComplexArray.h"
+#include "FFT.h"
+#include "ComplexIO.h"
+#include "ComplexFile.h"
+#include "FixedPoint.h"
+#include "ComplexMath.h"
+#include "Polynomial.h"
+#include <complex>
 #include <gtest/gtest.h>
 
 // To compile: g++ -o tests tests.cpp Complex.h -lgtest -lgtest_main -pthread
@@ -246,6 +254,16 @@ TEST(NonMemberOperators, LessThanIsCorrect) {
 
     Complex c4(0, 0);
     EXPECT_EQ(false, c<c4);
+    EXPECT_EQ(true, c4<c);
+
+    // Squared magnitudes overflow or underflow here, the order must still hold
+    EXPECT_EQ(true, Complex(1e200, 0) < Complex(2e200, 0));
+    EXPECT_EQ(false, Complex(2e200, 0) < Complex(1e200, 1e200));
+    EXPECT_EQ(true, Complex(1e300, 1e300) < Complex(0, 1.5e300));
+    EXPECT_EQ(true, Complex(1e-200, 0) < Complex(0, 2e-200));
+    EXPECT_EQ(false, Complex(3e-200, 0) < Complex(2e-200, 2e-200));
+    EXPECT_EQ(true, Complex(1, 1) < Complex(1e200, 0));
+    static_assert(Complex(1, 2) < Complex(3, 0), "operator< is constexpr");
 }
 
 // Output operator << 
@@ -338,6 +356,660 @@ TEST(LiteralForm, WholeNumberLiteralFormIsCorrect) {
 }
 
 
+// Compile time evaluation - Arithmetic works in constant expressions
+TEST(Constexpr, ArithmeticIsConstexpr) {
+    constexpr Complex c = Complex(1, 2) * Complex(3, 4) + 2.0_i - Complex(1, 0);
+    static_assert(c.real() == -6 && c.imag() == 12, "constexpr multiply-add");
+    constexpr Complex q = Complex(6, 8) / Complex(2, 2);
+    static_assert(q == Complex(3.5, 0.5), "constexpr division");
+    static_assert(std::is_trivially_copyable<Complex>::value, "Complex must stay trivially copyable");
+    EXPECT_EQ(-6, real(c));
+}
+
+// Compound operators with the same number on both sides
+TEST(MemberOperators, SelfAssignmentOperatorsAreCorrect) {
+    Complex c(3, 4);
+    c *= c;
+    EXPECT_EQ(-7, c.real());
+    EXPECT_EQ(24, c.imag());
+
+    Complex c2(3, 4);
+    c2 /= c2;
+    EXPECT_EQ(1, c2.real());
+    EXPECT_EQ(0, c2.imag());
+}
+
+// Division with 0 - operator/ and /= throw, divide_unchecked follows IEEE 754
+TEST(NonMemberOperators, DivisionByZero) {
+    Complex c(1, 1);
+    EXPECT_THROW(c / Complex(0, 0), std::out_of_range);
+    EXPECT_THROW(c /= Complex(), std::out_of_range);
+    EXPECT_EQ(Complex(1, 1), c);
+
+    Complex q = divide_unchecked(Complex(6, 8), Complex(2, 2));
+    EXPECT_EQ(Complex(3.5, 0.5), q);
+    Complex inf = divide_unchecked(c, Complex(0, 0));
+    EXPECT_TRUE(std::isinf(real(inf)) || std::isnan(real(inf)));
+}
+
+
+// ComplexArray - Conversion to and from std::vector<Complex> keeps every element
+TEST(ComplexArray, ConversionRoundTrip) {
+    std::vector<Complex> numbers;
+    for (int i = 0; i < 37; i++) {
+        numbers.push_back(Complex(i, -2 * i));
+    }
+    ComplexArray array(numbers);
+    EXPECT_EQ(37u, array.size());
+    EXPECT_EQ(Complex(5, -10), array[5]);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(array.real_data()) % 64);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(array.imag_data()) % 64);
+    EXPECT_EQ(numbers, array.to_vector());
+
+    array.set(36, Complex(1, 1));
+    EXPECT_EQ(Complex(1, 1), array[36]);
+    EXPECT_THROW(array[37], std::out_of_range);
+}
+
+// ComplexArray - Element-wise operators match Complex arithmetic
+TEST(ComplexArray, ElementwiseMatchesComplex) {
+    ComplexArray a{Complex(1, 2), Complex(-3, 4), Complex(6, 8), Complex(0, 1), Complex(2.5, -1)};
+    ComplexArray b{Complex(2, 2), Complex(1, 0), Complex(2, 2), Complex(-1, 3), Complex(0.5, 0.5)};
+    ComplexArray sum = a + b;
+    ComplexArray difference = a - b;
+    ComplexArray product = a * b;
+    ComplexArray quotient = a / b;
+    ComplexArray scaled = a * Complex(0, 2);
+    ComplexArray conjugated = conj(a);
+    std::vector<double> magnitudes = abs(a);
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_EQ(a[i] + b[i], sum[i]);
+        EXPECT_EQ(a[i] - b[i], difference[i]);
+        EXPECT_EQ(a[i] * b[i], product[i]);
+        EXPECT_EQ(a[i] / b[i], quotient[i]);
+        EXPECT_EQ(a[i] * Complex(0, 2), scaled[i]);
+        EXPECT_EQ(Complex(real(a[i]), -imag(a[i])), conjugated[i]);
+        EXPECT_EQ(abs(a[i]), magnitudes[i]);
+    }
+    EXPECT_EQ(a * 2.0, 2.0 * a);
+    EXPECT_EQ(a + a, a * 2.0);
+}
+
+// ComplexArray - Compound operators with the same array on both sides
+TEST(ComplexArray, SelfAssignmentOperatorsAreCorrect) {
+    ComplexArray x{Complex(1, 2), Complex(3, 4)};
+    x *= x;
+    EXPECT_EQ(Complex(-3, 4), x[0]);
+    EXPECT_EQ(Complex(-7, 24), x[1]);
+    x += x;
+    EXPECT_EQ(Complex(-6, 8), x[0]);
+    EXPECT_EQ(Complex(-14, 48), x[1]);
+    x /= x;
+    EXPECT_EQ(Complex(1, 0), x[0]);
+    EXPECT_EQ(Complex(1, 0), x[1]);
+    x -= x;
+    EXPECT_EQ(Complex(0, 0), x[0]);
+    EXPECT_EQ(Complex(0, 0), x[1]);
+}
+
+// ComplexArray - Division with 0 throws and leaves the array unchanged, wrong sizes throw
+TEST(ComplexArray, DivisionByZeroAndSizes) {
+    ComplexArray a{Complex(1, 2), Complex(3, 4)};
+    ComplexArray b{Complex(1, 0), Complex(0, 0)};
+    EXPECT_THROW(a /= b, std::out_of_range);
+    EXPECT_EQ(Complex(1, 2), a[0]);
+    ComplexArray unchecked = divide_unchecked(a, b);
+    EXPECT_EQ(Complex(1, 2), unchecked[0]);
+    EXPECT_THROW(a + ComplexArray(3), std::out_of_range);
+}
+
+// ComplexArray - Reductions
+TEST(ComplexArray, SumAndDotProducts) {
+    std::vector<Complex> x;
+    std::vector<Complex> y;
+    for (int i = 0; i < 21; i++) {
+        x.push_back(Complex(i, 1));
+        y.push_back(Complex(1, -i));
+    }
+    Complex expectedSum, expectedDot, expectedDotc;
+    for (int i = 0; i < 21; i++) {
+        expectedSum += x[i];
+        expectedDot += x[i] * y[i];
+        expectedDotc += Complex(real(x[i]), -imag(x[i])) * y[i];
+    }
+    ComplexArray a(x);
+    ComplexArray b(y);
+    EXPECT_EQ(expectedSum, sum(a));
+    EXPECT_EQ(expectedDot, dot(a, b));
+    EXPECT_EQ(expectedDotc, dotc(a, b));
+    EXPECT_EQ(Complex(), sum(ComplexArray()));
+}
+
+
+// Direct O(n^2) transform used as the reference for the FFT tests
+std::vector<Complex> naiveDft(const std::vector<Complex> & x) {
+    const size_t n = x.size();
+    std::vector<Complex> result(n);
+    for (size_t k = 0; k < n; k++) {
+        for (size_t j = 0; j < n; j++) {
+            const double phase = -2.0 * fft_pi * static_cast<double>(j * k % n) / n;
+            result[k] += x[j] * Complex(std::cos(phase), std::sin(phase));
+        }
+    }
+    return result;
+}
+
+std::vector<Complex> testSignal(size_t n) {
+    std::vector<Complex> x(n);
+    for (size_t j = 0; j < n; j++) {
+        x[j] = Complex(std::sin(0.37 * j) + 0.1 * j, std::cos(1.3 * j) - 0.5);
+    }
+    return x;
+}
+
+void expectClose(const std::vector<Complex> & expected, const std::vector<Complex> & actual, double tolerance) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t k = 0; k < expected.size(); k++) {
+        EXPECT_NEAR(real(expected[k]), real(actual[k]), tolerance) << "k = " << k;
+        EXPECT_NEAR(imag(expected[k]), imag(actual[k]), tolerance) << "k = " << k;
+    }
+}
+
+// FFT - Radix-2/4, mixed radix and Bluestein sizes match the direct transform
+TEST(FFT, MatchesNaiveDft) {
+    for (size_t n : {1, 2, 3, 4, 5, 8, 12, 15, 16, 49, 60, 64, 67, 97, 100, 128, 210, 256, 360, 509, 1000, 1024}) {
+        std::vector<Complex> x = testSignal(n);
+        FFTPlan plan(n);
+        EXPECT_EQ(n == 67 || n == 97 || n == 509, plan.uses_bluestein()) << "n = " << n;
+        expectClose(naiveDft(x), plan.forward(x), 1e-9 * n);
+        expectClose(x, plan.inverse(plan.forward(x)), 1e-12 * n);
+    }
+}
+
+// FFT - In-place transforms, one-off functions and size checks
+TEST(FFT, InPlaceAndErrors) {
+    std::vector<Complex> x = testSignal(48);
+    std::vector<Complex> data(x);
+    FFTPlan plan(48);
+    plan.forward_in_place(data);
+    expectClose(fft(x), data, 1e-12);
+    plan.inverse_in_place(data);
+    expectClose(x, data, 1e-12);
+    expectClose(x, ifft(fft(x)), 1e-12);
+
+    EXPECT_THROW(plan.forward(testSignal(47)), std::out_of_range);
+    EXPECT_THROW(FFTPlan(0), std::out_of_range);
+}
+
+// FFT - Threads split the work but do not change the result
+TEST(FFT, ThreadedMatchesSerial) {
+    for (size_t n : {size_t(1) << 16, size_t(3) * 5 * 7 * 9 * 11 * 4}) {
+        std::vector<Complex> x = testSignal(n);
+        std::vector<Complex> serial = FFTPlan(n, 1).forward(x);
+        std::vector<Complex> threaded = FFTPlan(n, 4).forward(x);
+        EXPECT_EQ(serial, threaded);
+    }
+}
+
+// Real FFT - Even and odd sizes match the complex transform, inverse restores the signal
+TEST(FFT, RealInput) {
+    for (size_t n : {1, 2, 7, 16, 30, 97, 194, 1024}) {
+        std::vector<double> x(n);
+        std::vector<Complex> complexX(n);
+        for (size_t j = 0; j < n; j++) {
+            x[j] = std::sin(0.37 * j) + 0.1 * j;
+            complexX[j] = x[j];
+        }
+        RealFFTPlan plan(n);
+        std::vector<Complex> spectrum = plan.forward(x);
+        std::vector<Complex> full = fft(complexX);
+        full.resize(n / 2 + 1);
+        expectClose(full, spectrum, 1e-9 * n);
+
+        std::vector<double> restored = irfft(spectrum, n);
+        for (size_t j = 0; j < n; j++) {
+            EXPECT_NEAR(x[j], restored[j], 1e-12 * n);
+        }
+    }
+}
+
+
+// Squared magnitude
+TEST(AbsCalculation, NormIsCorrect) {
+    static_assert(norm(Complex(3, 4)) == 25, "norm is constexpr");
+    EXPECT_EQ(25, norm(Complex(-3, -4)));
+    EXPECT_EQ(0, norm(Complex()));
+}
+
+// Absolute value of very large and very small numbers - no overflow or underflow in a^2+b^2
+TEST(AbsCalculation, AbsAvoidsOverflow) {
+    EXPECT_DOUBLE_EQ(5e200, abs(Complex(3e200, -4e200)));
+    EXPECT_DOUBLE_EQ(5e-200, abs(Complex(-3e-200, 4e-200)));
+    EXPECT_DOUBLE_EQ(1e308, abs(Complex(1e308, 0)));
+    EXPECT_DOUBLE_EQ(std::sqrt(2.0) * 1e308, abs(Complex(1e308, 1e308)));
+    EXPECT_TRUE(std::isinf(abs(Complex(1.5e308, 1.5e308))));
+    EXPECT_TRUE(std::isinf(abs(Complex(-INFINITY, NAN))));
+    EXPECT_TRUE(std::isnan(abs(Complex(NAN, 1))));
+}
+
+// Division of very large and very small numbers with Smith's algorithm
+TEST(NonMemberOperators, DivisionAvoidsOverflow) {
+    Complex q = Complex(3e300, 4e300) / Complex(3e300, 4e300);
+    EXPECT_DOUBLE_EQ(1, real(q));
+    EXPECT_DOUBLE_EQ(0, imag(q));
+
+    Complex q2 = Complex(1, 1) / Complex(1e-300, 1e-300);
+    EXPECT_DOUBLE_EQ(1e300, real(q2));
+    EXPECT_DOUBLE_EQ(0, imag(q2));
+
+    Complex q3 = Complex(6e300, 8e300) / Complex(2e10, 2e10);   // a*c overflows, the quotient does not
+    EXPECT_DOUBLE_EQ(3.5e290, real(q3));
+    EXPECT_DOUBLE_EQ(0.5e290, imag(q3));
+
+    ComplexArray a{Complex(6, 8), Complex(3e300, 4e300), Complex(1, 1), Complex(6e300, 8e300)};
+    ComplexArray b{Complex(2, 2), Complex(3e300, 4e300), Complex(1e-300, 1e-300), Complex(2e10, 2e10)};
+    ComplexArray quotient = a / b;
+    std::vector<double> magnitudes = abs(a);
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_EQ(a[i] / b[i], quotient[i]);
+        EXPECT_EQ(abs(a[i]), magnitudes[i]);
+    }
+}
+
+
+// Bulk parsing - All three forms, any whitespace between numbers
+TEST(BulkIO, ParseArrayIsCorrect) {
+    std::string text = "(5.2,10.1) (-1e3, 2.5)\n( 7 )\t-0.25\r\n(nan,inf)\n";
+    Complex numbers[5];
+    ComplexParseResult result = parse_complex_array(text.data(), text.data() + text.size(), numbers, 5);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(5u, result.count);
+    EXPECT_EQ(text.size(), result.offset);
+    EXPECT_EQ(Complex(5.2, 10.1), numbers[0]);
+    EXPECT_EQ(Complex(-1000, 2.5), numbers[1]);
+    EXPECT_EQ(Complex(7, 0), numbers[2]);
+    EXPECT_EQ(Complex(-0.25, 0), numbers[3]);
+    EXPECT_TRUE(std::isnan(real(numbers[4])));
+    EXPECT_TRUE(std::isinf(imag(numbers[4])));
+
+    std::vector<Complex> appended{Complex(1, 1)};
+    EXPECT_TRUE(parse_complex_array(text, appended).ok());
+    EXPECT_EQ(6u, appended.size());
+    EXPECT_EQ(Complex(7, 0), appended[3]);
+}
+
+// Bulk parsing - Errors report their offset and keep the numbers before them
+TEST(BulkIO, ParseErrorsHaveOffsets) {
+    std::vector<Complex> numbers;
+    ComplexParseResult missing = parse_complex_array("(1,2) (3,x) (5,6)", numbers);
+    EXPECT_EQ(std::errc::invalid_argument, missing.error);
+    EXPECT_EQ(9u, missing.offset);
+    ASSERT_EQ(1u, numbers.size());
+    EXPECT_EQ(Complex(1, 2), numbers[0]);
+
+    numbers.clear();
+    ComplexParseResult unclosed = parse_complex_array("(1,2 3", numbers);
+    EXPECT_EQ(std::errc::invalid_argument, unclosed.error);
+    EXPECT_EQ(5u, unclosed.offset);
+
+    ComplexParseResult trailing = parse_complex_array("1.5 2.5x", numbers);
+    EXPECT_EQ(std::errc::invalid_argument, trailing.error);
+    EXPECT_EQ(7u, trailing.offset);
+
+    ComplexParseResult huge = parse_complex_array("1 (1e999,0)", numbers);
+    EXPECT_EQ(std::errc::result_out_of_range, huge.error);
+    EXPECT_EQ(2u, huge.offset);
+
+    std::string text = "1 2 3";
+    Complex two[2];
+    ComplexParseResult full = parse_complex_array(text.data(), text.data() + text.size(), two, 2);
+    EXPECT_EQ(std::errc::value_too_large, full.error);
+    EXPECT_EQ(2u, full.count);
+    EXPECT_EQ(4u, full.offset);
+}
+
+// Bulk formatting - Shortest round-trip text, reads back to the same numbers
+TEST(BulkIO, FormatRoundTrip) {
+    std::vector<Complex> numbers{Complex(5.2, 10.1), Complex(0.1, -1e-300), Complex(1.0 / 3, 2e300), Complex()};
+    std::string text = format_complex_array(numbers.data(), numbers.size(), ' ');
+    EXPECT_EQ("(5.2,10.1) (0.1,-1e-300) (0.3333333333333333,2e+300) (0,0) ", text);
+
+    std::vector<Complex> parsed;
+    EXPECT_TRUE(parse_complex_array(text, parsed).ok());
+    EXPECT_EQ(numbers, parsed);
+
+    char small[8];
+    EXPECT_EQ(std::errc::value_too_large, to_chars(small, small + sizeof(small), Complex(5.2, 10.1)).ec);
+    std::to_chars_result fits = to_chars(small, small + sizeof(small), Complex(1, 2));
+    EXPECT_EQ("(1,2)", std::string(small, fits.ptr));
+}
+
+
+// Sample files - Every layout and precision reads back, written and read in uneven chunks
+TEST(SampleFile, RoundTripAllFormats) {
+    std::vector<Complex> samples(10000);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = Complex(i * 0.1, -1.0 / (i + 1));
+    }
+    std::string path = ::testing::TempDir() + "complex_round_trip.cplx";
+    for (ComplexLayout layout : {ComplexLayout::Interleaved, ComplexLayout::Planar}) {
+        for (ComplexPrecision precision : {ComplexPrecision::Float64, ComplexPrecision::Float32}) {
+            {
+                ComplexFileWriter writer(path, layout, precision, samples.size());
+                writer.write(samples.data(), 3);
+                writer.write(samples.data() + 3, 6000);
+                writer.write(samples.data() + 6003, samples.size() - 6003);
+                EXPECT_EQ(samples.size(), writer.written());
+                writer.close();
+            }
+            ComplexFileReader reader(path);
+            EXPECT_EQ(layout, reader.header().layout);
+            EXPECT_EQ(precision, reader.header().precision);
+            ASSERT_EQ(samples.size(), reader.size());
+
+            std::vector<Complex> read(samples.size());
+            EXPECT_EQ(5000u, reader.read(read.data(), 5000));
+            EXPECT_EQ(5000u, reader.remaining());
+            EXPECT_EQ(5000u, reader.read(read.data() + 5000, 6000));
+            EXPECT_EQ(0u, reader.read(read.data(), 1));
+            for (size_t i = 0; i < samples.size(); i++) {
+                if (precision == ComplexPrecision::Float64) {
+                    ASSERT_EQ(samples[i], read[i]);
+                } else {
+                    ASSERT_EQ(static_cast<float>(samples[i].real()), read[i].real());
+                    ASSERT_EQ(static_cast<float>(samples[i].imag()), read[i].imag());
+                }
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+// Sample files - Interleaved double files map as Complex, other files and bad headers are rejected
+TEST(SampleFile, MappedView) {
+    std::vector<Complex> samples{Complex(1, 2), Complex(-3, 4.5), Complex(0, -1e300)};
+    std::string path = ::testing::TempDir() + "complex_view.cplx";
+    {
+        ComplexFileWriter writer(path);   // Interleaved: the count is filled in by close()
+        writer.write(samples);
+    }
+    ComplexFileView view(path);
+    ASSERT_EQ(3u, view.size());
+    EXPECT_EQ(samples, std::vector<Complex>(view.begin(), view.end()));
+    EXPECT_EQ(Complex(-3, 4.5), view[1]);
+    EXPECT_THROW(view[3], std::out_of_range);
+
+    ComplexFileView moved(std::move(view));
+    EXPECT_EQ(0u, view.size());
+    EXPECT_EQ(Complex(0, -1e300), moved.data()[2]);
+    EXPECT_EQ(samples, read_complex_file(path));
+
+    write_complex_file(path, samples, ComplexLayout::Planar);
+    EXPECT_THROW(ComplexFileView planar(path), std::runtime_error);
+    EXPECT_EQ(samples, read_complex_file(path));
+
+    ComplexFileWriter tooFew(path, ComplexLayout::Planar, ComplexPrecision::Float64, 4);
+    EXPECT_THROW(tooFew.write(std::vector<Complex>(5)), std::out_of_range);
+    tooFew.write(samples);
+    EXPECT_THROW(tooFew.close(), std::out_of_range);
+    EXPECT_THROW(ComplexFileReader incomplete(path), std::runtime_error);
+
+    // A count the file cannot hold, large enough for count * sizeof(Complex) to wrap
+    ComplexFileHeader huge;
+    huge.count = (uint64_t(1) << 60) + 1;
+    std::FILE * file = std::fopen(path.c_str(), "wb");
+    std::fwrite(&huge, sizeof(huge), 1, file);
+    std::fwrite(samples.data(), sizeof(Complex), samples.size(), file);
+    std::fclose(file);
+    EXPECT_THROW(ComplexFileReader reader(path), std::runtime_error);
+    EXPECT_THROW(ComplexFileView wrapped(path), std::runtime_error);
+
+    std::FILE * text = std::fopen(path.c_str(), "wb");
+    std::fputs("(1,2) (3,4) this is not a sample file", text);
+    std::fclose(text);
+    EXPECT_THROW(ComplexFileReader reader(path), std::runtime_error);
+    EXPECT_THROW(ComplexFileView bad(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(ComplexFileReader missing(path), std::runtime_error);
+}
+
+
+// Precisions - Float and long double parts behave like double, conversions between them are explicit
+TEST(Precisions, FloatAndLongDouble) {
+    static_assert(sizeof(ComplexF) == 2 * sizeof(float), "ComplexF holds two floats");
+    static_assert(std::is_trivially_copyable<ComplexF>::value, "ComplexF is trivially copyable");
+    static_assert(!std::is_convertible<Complex, ComplexF>::value, "Narrowing must be explicit");
+
+    ComplexF f(5.0f, 10.0f);
+    f *= ComplexF(2.0f, 2.0f);
+    EXPECT_EQ(ComplexF(-10.0f, 30.0f), f);
+    EXPECT_EQ(ComplexF(0.5f, 0.5f), ComplexF(1.0f, 0.0f) / ComplexF(1.0f, -1.0f));
+    EXPECT_EQ(ComplexF(1.0f, 2.5f), 1.0f + 2.5_if);
+    EXPECT_FLOAT_EQ(5.0f, abs(ComplexF(3.0f, -4.0f)));
+    EXPECT_FLOAT_EQ(std::sqrt(2.0f) * 1e38f, abs(ComplexF(1e38f, 1e38f)));    // a^2+b^2 overflows float
+    EXPECT_THROW(ComplexF(1.0f) / ComplexF(), std::out_of_range);
+
+    Complex widened(ComplexF(0.1f, -0.25f));
+    EXPECT_EQ(static_cast<double>(0.1f), widened.real());
+    EXPECT_EQ(-0.25, widened.imag());
+
+    ComplexLD big(1e3000L, 1e3000L);     // Beyond the range of double
+    EXPECT_EQ(ComplexLD(1, 0), big / big);
+    std::istringstream is("(1.5,-2)");
+    ComplexLD parsed;
+    is >> parsed;
+    EXPECT_EQ(ComplexLD(1.5L, -2.0L), parsed);
+}
+
+// Precisions - Real operands mix with any precision and skip the zero imaginary part
+TEST(Precisions, RealOperands) {
+    Complex c(1, 2);
+    EXPECT_EQ(Complex(2, 4), c * 2);
+    EXPECT_EQ(Complex(2, 4), 2 * c);
+    EXPECT_EQ(Complex(4, 2), c + 3);
+    EXPECT_EQ(Complex(2, -2), 3 - c);
+    EXPECT_EQ(Complex(0.5, 1), c / 2);
+    EXPECT_EQ(Complex(0.2, -0.4), 1 / c);
+    EXPECT_THROW(c / 0.0, std::out_of_range);
+    EXPECT_TRUE(Complex(5) == 5);
+    EXPECT_TRUE(c != 1);
+
+    // (inf+0i) * (2+0i) would give a nan imaginary part through inf * 0, the real operand does not
+    Complex scaled = Complex(std::numeric_limits<double>::infinity(), 0) * 2;
+    EXPECT_EQ(0, scaled.imag());
+    EXPECT_EQ(ComplexF(2.0f, 4.0f), ComplexF(1.0f, 2.0f) * 2);
+}
+
+// Precisions - Fixed-point parts round to nearest and saturate instead of wrapping
+TEST(Precisions, FixedPoint) {
+    EXPECT_EQ(65536, Fixed16(1).raw());
+    EXPECT_EQ(Fixed16(0.75), Fixed16(1.5) * Fixed16(0.5));
+    EXPECT_EQ(Fixed16(-3), Fixed16(1.5) / Fixed16(-0.5));
+    EXPECT_EQ(std::numeric_limits<int32_t>::max(), (Fixed16(30000) * Fixed16(3)).raw());
+    EXPECT_EQ(std::numeric_limits<int32_t>::min(), (Fixed16(-1) / Fixed16()).raw());
+
+    ComplexFixed16 a(Fixed16(1.5), Fixed16(-2));
+    ComplexFixed16 b(Fixed16(0.5), Fixed16(0.25));
+    ComplexFixed16 product = a * b;
+    EXPECT_EQ(Fixed16(1.25), product.real());
+    EXPECT_EQ(Fixed16(-0.625), product.imag());
+    EXPECT_EQ(a, product / b);
+    EXPECT_THROW(a / ComplexFixed16(), std::out_of_range);
+    EXPECT_EQ(Fixed16(5), abs(ComplexFixed16(Fixed16(3), Fixed16(4))));
+
+    // Ordering past the point where norm saturates (|z| of about 181)
+    EXPECT_EQ(std::numeric_limits<int32_t>::max(), norm(ComplexFixed16(Fixed16(200), Fixed16(0))).raw());
+    EXPECT_TRUE(ComplexFixed16(Fixed16(200), Fixed16(0)) < ComplexFixed16(Fixed16(0), Fixed16(300)));
+    EXPECT_FALSE(ComplexFixed16(Fixed16(0), Fixed16(300)) < ComplexFixed16(Fixed16(200), Fixed16(0)));
+    EXPECT_TRUE(ComplexFixed16(Fixed16(30000), Fixed16(30000)) < ComplexFixed16(Fixed16::from_raw(std::numeric_limits<int32_t>::min()), Fixed16::from_raw(std::numeric_limits<int32_t>::min())));
+    EXPECT_TRUE(ComplexFixed16(Fixed16(0.5), Fixed16(0)) < ComplexFixed16(Fixed16(0), Fixed16(-0.75)));
+    static_assert(ComplexFixed16(Fixed16(1), Fixed16(0)) < ComplexFixed16(Fixed16(2), Fixed16(0)), "operator< is constexpr");
+
+    Complex converted(ComplexFixed16(Fixed16(0.125), Fixed16(-7)));
+    EXPECT_EQ(Complex(0.125, -7), converted);
+    std::ostringstream os;
+    os << product;
+    EXPECT_EQ("(1.25,-0.625)", os.str());
+}
+
+
+// Relative closeness of each part, measured against the magnitude of the expected number. Infinite parts must
+// match exactly; results with a nan part are not compared, std::complex is not consistent about which parts get it.
+::testing::AssertionResult relativelyClose(const std::complex<double> & expected, const Complex & actual, double tolerance) {
+    if (std::isnan(expected.real()) || std::isnan(expected.imag())) {
+        return ::testing::AssertionSuccess();
+    }
+    const double scale = std::max(std::abs(expected), std::numeric_limits<double>::min());
+    const bool close = std::isinf(scale)
+        ? (!std::isinf(expected.real()) || expected.real() == actual.real()) && (!std::isinf(expected.imag()) || expected.imag() == actual.imag())
+        : std::abs(expected.real() - actual.real()) <= tolerance * scale && std::abs(expected.imag() - actual.imag()) <= tolerance * scale;
+    if (close) {
+        return ::testing::AssertionSuccess();
+    }
+    return ::testing::AssertionFailure() << "expected (" << expected.real() << "," << expected.imag() << "), got " << actual;
+}
+
+std::vector<Complex> transcendentalInputs() {
+    std::vector<Complex> inputs{Complex(1, 0), Complex(-1, 0), Complex(0, 1), Complex(0, -1), Complex(-2, 0.0),
+                                Complex(-2, -0.0), Complex(3, -4), Complex(-0.5, 1e-12), Complex(1e-300, 1e-300),
+                                Complex(1e200, -1e200), Complex(700, 3), Complex(-720, 1), Complex(2, 1e6)};
+    for (int i = 0; i < 200; i++) {
+        inputs.push_back(Complex(std::sin(1.7 * i) * (i % 20), std::cos(0.3 * i) * (i % 13) - 3));
+    }
+    inputs.push_back(Complex(-1e-310, 5e-320));
+    return inputs;
+}
+
+// Transcendental functions - exp, log, sqrt, pow, arg and polar agree with std::complex
+TEST(Transcendental, ScalarMatchesStd) {
+    for (const Complex & z : transcendentalInputs()) {
+        const std::complex<double> s(z.real(), z.imag());
+        EXPECT_TRUE(relativelyClose(std::exp(s), exp(z), 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::log(s), log(z), 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::sqrt(s), sqrt(z), 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::pow(s, std::complex<double>(0.5, -1.5)), pow(z, Complex(0.5, -1.5)), 1e-12)) << z;
+        EXPECT_TRUE(relativelyClose(std::pow(s, 2.5), pow(z, 2.5), 1e-13)) << z;
+        EXPECT_EQ(std::arg(s), arg(z)) << z;
+    }
+    EXPECT_EQ(Complex(0, 2), sqrt(Complex(-4, 0.0)));
+    EXPECT_EQ(Complex(0, -2), sqrt(Complex(-4, -0.0)));
+    EXPECT_EQ(Complex(std::numeric_limits<double>::infinity(), 0), exp(Complex(1000)));
+    EXPECT_EQ(Complex(-46, -9), pow(Complex(2, -3), 3));
+    EXPECT_EQ(Complex(1), pow(Complex(2, -3), 0));
+    EXPECT_EQ(Complex(0.25), pow(Complex(2), -2));
+    EXPECT_EQ(Complex(), pow(Complex(), Complex(2, 1)));
+    EXPECT_EQ(Complex(1), pow(Complex(), Complex()));
+    EXPECT_TRUE(relativelyClose(std::polar(2.0, 0.75), polar(2.0, 0.75), 1e-16));
+    EXPECT_TRUE(relativelyClose(std::complex<double>(-1, 0), Complex(exp(ComplexF(0, 3.14159265f))), 1e-6));
+}
+
+// Transcendental functions - The vectorized array versions match the scalar ones, also outside the kernel ranges
+TEST(Transcendental, ArrayMatchesScalar) {
+    std::vector<Complex> inputs = transcendentalInputs();
+    inputs.push_back(Complex());
+    inputs.push_back(Complex(std::numeric_limits<double>::infinity(), 1));
+    for (int i = 0; i < 300; i++) {     // More than one block
+        inputs.push_back(Complex(i * 0.01 - 1.5, 400.0 - i * 2.7));
+    }
+    const ComplexArray numbers(inputs);
+    const std::vector<Complex> exps = exp(numbers).to_vector();
+    const std::vector<Complex> logs = log(numbers).to_vector();
+    const std::vector<Complex> roots = sqrt(numbers).to_vector();
+    const std::vector<Complex> powers = pow(numbers, Complex(0.5, -1.5)).to_vector();
+    const std::vector<Complex> realPowers = pow(numbers, 2.5).to_vector();
+    const std::vector<double> angles = arg(numbers);
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const Complex & z = inputs[i];
+        const std::complex<double> s(z.real(), z.imag());
+        EXPECT_TRUE(relativelyClose(std::exp(s), exps[i], 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::log(s), logs[i], 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::sqrt(s), roots[i], 1e-15)) << z;
+        EXPECT_TRUE(relativelyClose(std::pow(s, std::complex<double>(0.5, -1.5)), powers[i], 1e-12)) << z;
+        EXPECT_TRUE(relativelyClose(std::pow(s, 2.5), realPowers[i], 1e-13)) << z;
+        EXPECT_NEAR(arg(z), angles[i], 1e-15 * std::abs(arg(z))) << z;
+    }
+    EXPECT_EQ(Complex(), powers[inputs.size() - 302]);
+    EXPECT_EQ(Complex(std::numeric_limits<double>::infinity(), 0), exp(ComplexArray{Complex(1000)})[0]);
+
+    const std::vector<double> magnitude{1, 2, 0.5};
+    const std::vector<double> angle{0, 2.5, -1e7};
+    const ComplexArray fromPolar = polar(magnitude, angle);
+    for (size_t i = 0; i < magnitude.size(); i++) {
+        EXPECT_TRUE(relativelyClose(std::polar(magnitude[i], angle[i]), fromPolar[i], 1e-15));
+    }
+    EXPECT_THROW(polar(magnitude, std::vector<double>(2)), std::out_of_range);
+}
+
+
+// Polynomials - Horner evaluation at one point and over an array, derivative and construction from roots
+TEST(Polynomial, Evaluation) {
+    Polynomial p{Complex(1, 1), Complex(0, -2), Complex(3), Complex(), Complex()};
+    EXPECT_EQ(2u, p.degree());
+    EXPECT_EQ(Complex(3), p[2]);
+    EXPECT_THROW(p[3], std::out_of_range);
+    EXPECT_EQ(Complex(4, -1), p(Complex(1)));
+    EXPECT_EQ(Complex(0, 1), p(1_i));      // 1+i + (-2i)(i) + 3(i^2) = 1+i + 2 - 3
+    EXPECT_EQ(Polynomial({Complex(0, -2), Complex(6)}).coefficients(), p.derivative().coefficients());
+    EXPECT_EQ(0u, Polynomial().degree());
+    EXPECT_EQ(Complex(), Polynomial()(Complex(5, 5)));
+
+    Polynomial fromRoots = Polynomial::from_roots({Complex(1), Complex(0, 1), Complex(-2, 0.5)}, Complex(2));
+    EXPECT_EQ(3u, fromRoots.degree());
+    EXPECT_EQ(Complex(2), fromRoots[3]);
+    EXPECT_EQ(Complex(), fromRoots(Complex(0, 1)));
+    EXPECT_EQ(Complex(), fromRoots(Complex(-2, 0.5)));
+
+    std::vector<Complex> coefficients(300);
+    std::vector<Complex> points(1000);
+    for (size_t k = 0; k < coefficients.size(); k++) {
+        coefficients[k] = Complex(std::sin(0.1 * k), std::cos(0.7 * k));
+    }
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i] = Complex(std::cos(0.01 * i), std::sin(0.013 * i)) * 0.99;
+    }
+    Polynomial big(coefficients);
+    ComplexArray values = big(ComplexArray(points));
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_LE(abs(values[i] - big(points[i])), 1e-12 * abs(big(points[i])) + 1e-12) << "i = " << i;
+    }
+}
+
+// Polynomials - Aberth finds every root, including zero and high-degree roots, serial and threaded
+TEST(Polynomial, Roots) {
+    std::vector<Complex> expected{Complex(1), Complex(-2), Complex(0, 3), Complex(0.5, -0.5), Complex(), Complex(-1e-3, 7)};
+    PolynomialRoots found = polynomial_roots(Polynomial::from_roots(expected, Complex(0.5, 2)));
+    EXPECT_TRUE(found.converged);
+    ASSERT_EQ(expected.size(), found.roots.size());
+    for (const Complex & root : expected) {
+        double nearest = std::numeric_limits<double>::infinity();
+        for (const Complex & candidate : found.roots) {
+            nearest = std::min(nearest, abs(candidate - root));
+        }
+        EXPECT_LT(nearest, 1e-12) << root;
+    }
+
+    // z^1000 - 1: the roots of unity, spread over threads
+    std::vector<Complex> unity(1001);
+    unity[0] = Complex(-1);
+    unity[1000] = Complex(1);
+    for (size_t threads : {1, 4}) {
+        PolynomialRoots roots = polynomial_roots(Polynomial(unity), threads);
+        EXPECT_TRUE(roots.converged);
+        ASSERT_EQ(1000u, roots.roots.size());
+        std::vector<double> angles;
+        for (const Complex & root : roots.roots) {
+            EXPECT_NEAR(1.0, abs(root), 1e-13);
+            angles.push_back(arg(root));
+        }
+        std::sort(angles.begin(), angles.end());
+        for (size_t k = 1; k < angles.size(); k++) {
+            EXPECT_NEAR(2 * fft_pi / 1000, angles[k] - angles[k - 1], 1e-12);
+        }
+    }
+    EXPECT_THROW(polynomial_roots(Polynomial{Complex(5)}), std::out_of_range);
+}
+
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
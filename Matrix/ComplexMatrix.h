@@ -0,0 +1,173 @@
+/*
+* Complex matrix with split real/imaginary storage
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COMPLEXMATRIX_H
+#define COMPLEXMATRIX_H
+
+#include "Matrix.h"
+#include "../Complex-numbers/Complex.h"
+
+// Stores the real and imaginary parts in two separate Matrix<double> planes (structure of arrays),
+// so products can be computed with real matrix products instead of element-wise Complex calls.
+class ComplexMatrix {
+public:
+    enum class Algorithm {
+        FourM,  // One fused pass over both planes doing the 4 real multiply-adds. Same rounding as the textbook formula.
+        ThreeM  // 3 separate real matrix products (Gauss' trick). 25% fewer flops, slightly larger rounding error.
+    };
+
+    // constructors
+    ComplexMatrix();
+    ComplexMatrix(size_t rows, size_t cols);
+    ComplexMatrix(const Matrix<double> & real, const Matrix<double> & imag);
+    explicit ComplexMatrix(const Matrix<Complex> & m);
+
+    // accessors
+    size_t rows() const;
+    size_t cols() const;
+
+    Complex operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, const Complex & value);
+
+    Matrix<double> & real();
+    const Matrix<double> & real() const;
+    Matrix<double> & imag();
+    const Matrix<double> & imag() const;
+
+    Matrix<Complex> to_matrix() const;
+
+    // operators
+    ComplexMatrix multiply(const ComplexMatrix & other, Algorithm algorithm = Algorithm::FourM) const;
+    ComplexMatrix operator*(const ComplexMatrix & other) const;
+    ComplexMatrix operator+(const ComplexMatrix & other) const;
+    ComplexMatrix operator-(const ComplexMatrix & other) const;
+
+private:
+    Matrix<double> m_re;
+    Matrix<double> m_im;
+};
+
+//
+// Implementations
+//
+
+// CONSTRUCTORS
+
+// Empty matrix
+inline ComplexMatrix::ComplexMatrix() {}
+
+// Defined row and column size, all elements are 0
+inline ComplexMatrix::ComplexMatrix(size_t rows, size_t cols) : m_re(rows, cols), m_im(rows, cols) {}
+
+// Build from a real and an imaginary plane of the same size
+inline ComplexMatrix::ComplexMatrix(const Matrix<double> & real, const Matrix<double> & imag) : m_re(real), m_im(imag) {
+    if (real.rows() != imag.rows() || real.cols() != imag.cols()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+}
+
+// Split an interleaved Matrix<Complex> into planes
+inline ComplexMatrix::ComplexMatrix(const Matrix<Complex> & m) : m_re(m.rows(), m.cols()), m_im(m.rows(), m.cols()) {
+    const Complex * src = m.data();
+    double * re = m_re.data();
+    double * im = m_im.data();
+    for (size_t i = 0; i < m.rows() * m.cols(); i++) {
+        re[i] = src[i].real();
+        im[i] = src[i].imag();
+    }
+}
+
+// ACCESSORS
+
+inline size_t ComplexMatrix::rows() const {
+    return m_re.rows();
+}
+
+inline size_t ComplexMatrix::cols() const {
+    return m_re.cols();
+}
+
+// Read an element. Elements are not stored as Complex, so they are returned by value.
+inline Complex ComplexMatrix::operator()(size_t row, size_t col) const {
+    return Complex(m_re(row, col), m_im(row, col));
+}
+
+// Write an element
+inline void ComplexMatrix::set(size_t row, size_t col, const Complex & value) {
+    m_re(row, col) = value.real();
+    m_im(row, col) = value.imag();
+}
+
+inline Matrix<double> & ComplexMatrix::real() {
+    return m_re;
+}
+
+inline const Matrix<double> & ComplexMatrix::real() const {
+    return m_re;
+}
+
+inline Matrix<double> & ComplexMatrix::imag() {
+    return m_im;
+}
+
+inline const Matrix<double> & ComplexMatrix::imag() const {
+    return m_im;
+}
+
+// Merge the planes back into an interleaved Matrix<Complex>
+inline Matrix<Complex> ComplexMatrix::to_matrix() const {
+    Matrix<Complex> result(rows(), cols());
+    Complex * dst = result.data();
+    const double * re = m_re.data();
+    const double * im = m_im.data();
+    for (size_t i = 0; i < rows() * cols(); i++) {
+        dst[i] = Complex(re[i], im[i]);
+    }
+    return result;
+}
+
+// OPERATORS
+
+// Product (A + Bi)(C + Di) computed on the real planes.
+// 4M: real = AC - BD, imag = AD + BC
+// 3M: T1 = AC, T2 = BD, T3 = (A + B)(C + D), real = T1 - T2, imag = T3 - T1 - T2
+inline ComplexMatrix ComplexMatrix::multiply(const ComplexMatrix & other, Algorithm algorithm) const {
+    if (cols() != other.rows()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    ComplexMatrix result(rows(), other.cols());
+    if (algorithm == Algorithm::FourM) {
+        complex_gemm_kernel(m_re.data(), m_im.data(), other.m_re.data(), other.m_im.data(),
+                            result.m_re.data(), result.m_im.data(), rows(), cols(), other.cols());
+    } else {
+        Matrix<double> t1 = m_re * other.m_re;
+        Matrix<double> t2 = m_im * other.m_im;
+        Matrix<double> t3 = (m_re + m_im) * (other.m_re + other.m_im);
+        result.m_re = t1 - t2;
+        t3 -= t1;
+        t3 -= t2;
+        result.m_im = std::move(t3);
+    }
+    return result;
+}
+
+// Multiplication of matrices with the default (4M) algorithm
+inline ComplexMatrix ComplexMatrix::operator*(const ComplexMatrix & other) const {
+    return multiply(other);
+}
+
+// Addition of matrices
+inline ComplexMatrix ComplexMatrix::operator+(const ComplexMatrix & other) const {
+    return ComplexMatrix(m_re + other.m_re, m_im + other.m_im);
+}
+
+// Subtraction of matrices
+inline ComplexMatrix ComplexMatrix::operator-(const ComplexMatrix & other) const {
+    return ComplexMatrix(m_re - other.m_re, m_im - other.m_im);
+}
+
+#endif //COMPLEXMATRIX_H
@@ -0,0 +1,297 @@
+/*
+* 2D convolution and correlation on matrices
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "Matrix.h"
+
+#include <vector>
+
+// Zero padding added around the input
+enum class Padding {
+    Valid,  // No padding, the kernel stays inside the input
+    Same,   // Output has the input size (with stride 1)
+    Full    // Every overlap of kernel and input, output grows by kernel size - 1
+};
+
+enum class ConvolutionMethod {
+    Auto,   // Im2col for banks of at least im2col_min_filters kernels, otherwise Direct
+    Direct, // Accumulate kernel-weighted input rows straight into the output
+    Im2col  // Copy input patches into columns once and multiply them with all flattened kernels
+};
+
+// Kernels in a bank from which Auto picks im2col. Below it the kernel matrix has too few rows for the
+// product to pay back the patch copies (see convolutionTest in benchmark.cpp).
+const size_t im2col_min_filters = 4;
+
+struct ConvolutionOptions {
+    Padding padding = Padding::Valid;
+    size_t stride_rows = 1;
+    size_t stride_cols = 1;
+    ConvolutionMethod method = ConvolutionMethod::Auto;
+};
+
+template<typename T>
+Matrix<T> correlate2d(const Matrix<T> & input, const Matrix<T> & kernel, const ConvolutionOptions & options = ConvolutionOptions());
+
+template<typename T>
+Matrix<T> convolve2d(const Matrix<T> & input, const Matrix<T> & kernel, const ConvolutionOptions & options = ConvolutionOptions());
+
+// Filter banks: one output per kernel, all kernels of the same size
+template<typename T>
+std::vector<Matrix<T>> correlate2d(const Matrix<T> & input, const std::vector<Matrix<T>> & kernels, const ConvolutionOptions & options = ConvolutionOptions());
+
+template<typename T>
+std::vector<Matrix<T>> convolve2d(const Matrix<T> & input, const std::vector<Matrix<T>> & kernels, const ConvolutionOptions & options = ConvolutionOptions());
+
+//
+// Implementations
+//
+
+// Geometry shared by both methods. Positions are signed since padding puts the kernel before the input.
+struct ConvolutionShape {
+    std::ptrdiff_t inRows, inCols;
+    std::ptrdiff_t kRows, kCols;
+    std::ptrdiff_t padTop, padLeft;
+    std::ptrdiff_t strideRows, strideCols;
+    size_t outRows, outCols;
+};
+
+// Work out padding and output size, throws if the kernel does not fit
+inline ConvolutionShape convolution_shape(size_t inRows, size_t inCols, size_t kRows, size_t kCols, const ConvolutionOptions & options) {
+    if (kRows == 0 || kCols == 0 || options.stride_rows == 0 || options.stride_cols == 0) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    size_t padRows = 0;     // Total padding over both sides
+    size_t padCols = 0;
+    if (options.padding == Padding::Same) {
+        padRows = kRows - 1;
+        padCols = kCols - 1;
+    } else if (options.padding == Padding::Full) {
+        padRows = 2 * (kRows - 1);
+        padCols = 2 * (kCols - 1);
+    }
+    if (inRows + padRows < kRows || inCols + padCols < kCols) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+
+    ConvolutionShape shape;
+    shape.inRows = inRows;
+    shape.inCols = inCols;
+    shape.kRows = kRows;
+    shape.kCols = kCols;
+    shape.padTop = padRows / 2;
+    shape.padLeft = padCols / 2;
+    shape.strideRows = options.stride_rows;
+    shape.strideCols = options.stride_cols;
+    shape.outRows = (inRows + padRows - kRows) / options.stride_rows + 1;
+    shape.outCols = (inCols + padCols - kCols) / options.stride_cols + 1;
+    return shape;
+}
+
+// Output columns [first, last) for which input column c * stride + offset lies inside the input
+inline void valid_output_cols(const ConvolutionShape & s, std::ptrdiff_t offset, std::ptrdiff_t & first, std::ptrdiff_t & last) {
+    first = (offset < 0) ? (-offset + s.strideCols - 1) / s.strideCols : 0;
+    last = (s.inCols - offset + s.strideCols - 1) / s.strideCols;
+    last = std::min<std::ptrdiff_t>(std::max<std::ptrdiff_t>(last, 0), s.outCols);
+}
+
+// Direct method for output rows [firstRow, lastRow). For every kernel element, a whole output row gets
+// weight * (shifted input row) added, which is a contiguous multiply-add loop when the stride is 1.
+template<typename T>
+void correlate2d_direct(const T * in, const T * k, T * out, const ConvolutionShape & s, size_t firstRow, size_t lastRow) {
+    for (size_t r = firstRow; r < lastRow; r++) {
+        T * outRow = out + r * s.outCols;
+        for (std::ptrdiff_t u = 0; u < s.kRows; u++) {
+            std::ptrdiff_t inRow = static_cast<std::ptrdiff_t>(r) * s.strideRows + u - s.padTop;
+            if (inRow < 0 || inRow >= s.inRows) {
+                continue; // Kernel row is over the zero padding
+            }
+            const T * inRowPtr = in + inRow * s.inCols;
+            for (std::ptrdiff_t v = 0; v < s.kCols; v++) {
+                const T weight = k[u * s.kCols + v];
+                std::ptrdiff_t offset = v - s.padLeft;
+                std::ptrdiff_t first, last;
+                valid_output_cols(s, offset, first, last);
+                if (s.strideCols == 1) {
+                    const T * src = inRowPtr + offset;
+                    for (std::ptrdiff_t c = first; c < last; c++) {
+                        outRow[c] += weight * src[c];
+                    }
+                } else {
+                    for (std::ptrdiff_t c = first; c < last; c++) {
+                        outRow[c] += weight * inRowPtr[c * s.strideCols + offset];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// c = k * p for the filters x taps kernel matrix k and the taps x pixels patch buffer p. Blocks of 4 filters
+// by 16 pixels are summed over all taps in local accumulators, so every loaded patch element feeds 4
+// multiply-adds and the output is written once, where gemm_kernel reloads and stores c for every tap.
+template<typename T>
+void im2col_product(const T * k, const T * p, T * c, size_t filters, size_t taps, size_t pixels) {
+    const size_t fBlock = 4;
+    const size_t jBlock = 16;
+    size_t j0 = 0;
+    for (; j0 + jBlock <= pixels; j0 += jBlock) {
+        size_t f0 = 0;
+        for (; f0 + fBlock <= filters; f0 += fBlock) {
+            T acc[fBlock][jBlock] = {};
+            for (size_t t = 0; t < taps; t++) {
+                const T * patchRow = p + t * pixels + j0;
+                for (size_t f = 0; f < fBlock; f++) {
+                    const T weight = k[(f0 + f) * taps + t];
+                    for (size_t j = 0; j < jBlock; j++) {
+                        acc[f][j] += weight * patchRow[j];
+                    }
+                }
+            }
+            for (size_t f = 0; f < fBlock; f++) {
+                std::copy(acc[f], acc[f] + jBlock, c + (f0 + f) * pixels + j0);
+            }
+        }
+        for (; f0 < filters; f0++) {  // Filters left over from the blocks of 4
+            T acc[jBlock] = {};
+            for (size_t t = 0; t < taps; t++) {
+                const T weight = k[f0 * taps + t];
+                const T * patchRow = p + t * pixels + j0;
+                for (size_t j = 0; j < jBlock; j++) {
+                    acc[j] += weight * patchRow[j];
+                }
+            }
+            std::copy(acc, acc + jBlock, c + f0 * pixels + j0);
+        }
+    }
+    for (size_t f = 0; f < filters; f++) {  // Pixels left over from the blocks of 16
+        for (size_t j = j0; j < pixels; j++) {
+            T sum = T();
+            for (size_t t = 0; t < taps; t++) {
+                sum += k[f * taps + t] * p[t * pixels + j];
+            }
+            c[f * pixels + j] = sum;
+        }
+    }
+}
+
+// im2col method for output rows [firstRow, lastRow). Row (u, v) of the patch buffer holds, for every output
+// pixel, the input element under kernel element (u, v) (0 over padding). The output block of all filters is
+// then the filters x (kRows * kCols) matrix of flattened kernels times the patch buffer, done by
+// im2col_product, and row f of the block is copied to outs[f].
+template<typename T>
+void correlate2d_im2col(const T * in, const T * kernels, size_t filters, T * const * outs, const ConvolutionShape & s,
+                        size_t firstRow, size_t lastRow, std::vector<T> & patches, std::vector<T> & block) {
+    const size_t pixels = (lastRow - firstRow) * s.outCols;
+    const size_t taps = s.kRows * s.kCols;
+    patches.assign(taps * pixels, T());
+    for (std::ptrdiff_t u = 0; u < s.kRows; u++) {
+        for (std::ptrdiff_t v = 0; v < s.kCols; v++) {
+            T * patchRow = patches.data() + (u * s.kCols + v) * pixels;
+            std::ptrdiff_t offset = v - s.padLeft;
+            std::ptrdiff_t first, last;
+            valid_output_cols(s, offset, first, last);
+            for (size_t r = firstRow; r < lastRow; r++) {
+                std::ptrdiff_t inRow = static_cast<std::ptrdiff_t>(r) * s.strideRows + u - s.padTop;
+                if (inRow < 0 || inRow >= s.inRows) {
+                    continue;
+                }
+                const T * inRowPtr = in + inRow * s.inCols;
+                T * dst = patchRow + (r - firstRow) * s.outCols;
+                for (std::ptrdiff_t c = first; c < last; c++) {
+                    dst[c] = inRowPtr[c * s.strideCols + offset];
+                }
+            }
+        }
+    }
+    block.resize(filters * pixels);
+    im2col_product(kernels, patches.data(), block.data(), filters, taps, pixels);
+    for (size_t f = 0; f < filters; f++) {
+        std::copy(block.begin() + f * pixels, block.begin() + (f + 1) * pixels, outs[f] + firstRow * s.outCols);
+    }
+}
+
+// Cross-correlation: output(r, c) = sum over (u, v) of kernel(u, v) * input(r * stride + u, c * stride + v),
+// with input positions shifted by the padding. Output tiles are shared between threads.
+template<typename T>
+Matrix<T> correlate2d(const Matrix<T> & input, const Matrix<T> & kernel, const ConvolutionOptions & options) {
+    return std::move(correlate2d(input, std::vector<Matrix<T>>{kernel}, options).front());
+}
+
+// Convolution: correlation with the kernel rotated 180 degrees
+template<typename T>
+Matrix<T> convolve2d(const Matrix<T> & input, const Matrix<T> & kernel, const ConvolutionOptions & options) {
+    Matrix<T> flipped(kernel.rows(), kernel.cols());
+    std::reverse_copy(kernel.begin(), kernel.end(), flipped.begin());
+    return correlate2d(input, flipped, options);
+}
+
+// Cross-correlation with every kernel of a bank. Direct makes one pass over the input per kernel; im2col
+// builds each tile's patches once and multiplies them with all kernels in one product, so it wins once the
+// bank is large enough to make that product a real matrix product.
+template<typename T>
+std::vector<Matrix<T>> correlate2d(const Matrix<T> & input, const std::vector<Matrix<T>> & kernels, const ConvolutionOptions & options) {
+    if (kernels.empty()) {
+        return {};
+    }
+    const size_t kRows = kernels.front().rows();
+    const size_t kCols = kernels.front().cols();
+    for (const Matrix<T> & kernel : kernels) {
+        if (kernel.rows() != kRows || kernel.cols() != kCols) {
+            throw std::out_of_range("Wrong dimensions!");
+        }
+    }
+    ConvolutionShape shape = convolution_shape(input.rows(), input.cols(), kRows, kCols, options);
+    std::vector<Matrix<T>> results;
+    std::vector<T *> outs;
+    for (size_t f = 0; f < kernels.size(); f++) {
+        results.emplace_back(shape.outRows, shape.outCols);
+        outs.push_back(results.back().data());
+    }
+    const T * in = input.data();
+
+    ConvolutionMethod method = options.method;
+    if (method == ConvolutionMethod::Auto) {
+        method = (kernels.size() >= im2col_min_filters) ? ConvolutionMethod::Im2col : ConvolutionMethod::Direct;
+    }
+    if (method == ConvolutionMethod::Im2col) {
+        const size_t taps = kRows * kCols;
+        std::vector<T> stacked(kernels.size() * taps);  // Row f is kernel f, flattened
+        for (size_t f = 0; f < kernels.size(); f++) {
+            std::copy(kernels[f].begin(), kernels[f].end(), stacked.begin() + f * taps);
+        }
+        // Keep each tile's patch buffer small enough to stay in L2 (at least one output row)
+        size_t tileRows = std::max<size_t>(1, (size_t(1) << 14) / (taps * shape.outCols));
+        parallel_for_each_tile(results.front().tiles(tileRows), [&](const MatrixTile<T> & tile) {
+            std::vector<T> patches;
+            std::vector<T> block;
+            correlate2d_im2col(in, stacked.data(), kernels.size(), outs.data(), shape, tile.first_row, tile.last_row, patches, block);
+        });
+    } else {
+        parallel_for_each_tile(results.front().tiles(), [&](const MatrixTile<T> & tile) {
+            for (size_t f = 0; f < kernels.size(); f++) {
+                correlate2d_direct(in, kernels[f].data(), outs[f], shape, tile.first_row, tile.last_row);
+            }
+        });
+    }
+    return results;
+}
+
+// Convolution with every kernel of a bank
+template<typename T>
+std::vector<Matrix<T>> convolve2d(const Matrix<T> & input, const std::vector<Matrix<T>> & kernels, const ConvolutionOptions & options) {
+    std::vector<Matrix<T>> flipped;
+    for (const Matrix<T> & kernel : kernels) {
+        flipped.emplace_back(kernel.rows(), kernel.cols());
+        std::reverse_copy(kernel.begin(), kernel.end(), flipped.back().begin());
+    }
+    return correlate2d(input, flipped, options);
+}
+
+#endif //CONVOLUTION_H
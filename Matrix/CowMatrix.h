@@ -0,0 +1,430 @@
+/*
+* Copy-on-write matrix
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef COWMATRIX_H
+#define COWMATRIX_H
+
+#include "Matrix.h"
+
+#include <memory>
+#include <atomic>
+
+// Matrix with shared storage. Copies only bump an atomic reference count; the elements are cloned the first
+// time a copy is changed through a non-const accessor, iterator or row/column edit while other copies still
+// share them. Use it where most copies are read-only snapshots.
+//
+// A CowMatrix object may be copied from several threads at once, and each copy may then be used by its own
+// thread. References and iterators obtained from a non-const accessor stay valid only until the next copy
+// of the matrix is made; writing through them afterwards would change the snapshot as well.
+template <typename T>
+class CowMatrix {
+public:
+    // constructors and assignment operators
+    CowMatrix();
+    explicit CowMatrix(size_t dim);
+    CowMatrix(size_t rows, size_t cols);
+    CowMatrix(const std::initializer_list<T> & list);
+    explicit CowMatrix(Matrix<T> && matrix);
+    explicit CowMatrix(const Matrix<T> & matrix);
+
+    CowMatrix(const CowMatrix<T> & other) = default;
+    CowMatrix(CowMatrix<T> && other) noexcept;
+    CowMatrix<T> & operator=(const CowMatrix<T> & other) = default;
+    CowMatrix<T> & operator=(CowMatrix<T> && other) noexcept;
+
+    // accessors
+    size_t rows() const;
+    size_t cols() const;
+
+    T & operator()(size_t row, size_t col);
+    const T & operator()(size_t row, size_t col) const;
+
+    const Matrix<T> & matrix() const;
+    Matrix<T> & mutable_matrix();
+    bool is_shared() const;
+
+    // operators
+    CowMatrix<T> operator*(const CowMatrix<T> & other) const;
+    CowMatrix<T> operator+(const CowMatrix<T> & other) const;
+    CowMatrix<T> operator-(const CowMatrix<T> & other) const;
+
+    void operator*=(const CowMatrix<T> & other);
+    void operator+=(const CowMatrix<T> & other);
+    void operator-=(const CowMatrix<T> & other);
+
+    // methods
+    void reset();
+
+    void insert_row(size_t row);
+    void append_row(size_t row);
+    void remove_row(size_t row);
+    void insert_column(size_t col);
+    void append_column(size_t col);
+    void remove_column(size_t col);
+
+    void insert_rows(size_t pos, size_t count);
+    void insert_columns(size_t pos, size_t count);
+    void remove_rows(const std::vector<size_t> & sorted_rows);
+    void remove_columns(const std::vector<size_t> & sorted_cols);
+    CowMatrix<T> gather_rows(const std::vector<size_t> & rows) const;
+    void scatter_rows(const std::vector<size_t> & rows, const CowMatrix<T> & source);
+
+    // iterators
+    typedef typename Matrix<T>::iterator iterator;
+    typedef typename Matrix<T>::const_iterator const_iterator;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    MatrixRange<typename Matrix<T>::iterator> row(size_t row);
+    MatrixRange<typename Matrix<T>::const_iterator> row(size_t row) const;
+    MatrixRange<typename Matrix<T>::column_iterator> column(size_t col);
+    MatrixRange<typename Matrix<T>::const_column_iterator> column(size_t col) const;
+
+private:
+    void detach();
+    static const std::shared_ptr<Matrix<T>> & empty_storage();
+
+    std::shared_ptr<Matrix<T>> m_data;
+};
+
+// input/output operators
+template<typename T>
+std::istream & operator>>(std::istream & is, CowMatrix<T> & m);
+
+template<typename T>
+std::ostream & operator<<(std::ostream & os, const CowMatrix<T> & m);
+
+//
+// Implementations
+//
+
+// CONSTRUCTORS
+
+// Default constructor
+template<typename T>
+CowMatrix<T>::CowMatrix() : m_data(std::make_shared<Matrix<T>>()) {}
+
+// Square matrix with default elements constructor
+template<typename T>
+CowMatrix<T>::CowMatrix(size_t dim) : m_data(std::make_shared<Matrix<T>>(dim)) {}
+
+// Defined row and column size with default elements constructor
+template<typename T>
+CowMatrix<T>::CowMatrix(size_t rows, size_t cols) : m_data(std::make_shared<Matrix<T>>(rows, cols)) {}
+
+// Square matrix from a list, see Matrix
+template<typename T>
+CowMatrix<T>::CowMatrix(const std::initializer_list<T> & list) : m_data(std::make_shared<Matrix<T>>(list)) {}
+
+// Take over the elements of a matrix
+template<typename T>
+CowMatrix<T>::CowMatrix(Matrix<T> && matrix) : m_data(std::make_shared<Matrix<T>>(std::move(matrix))) {}
+
+// Copy the elements of a matrix
+template<typename T>
+CowMatrix<T>::CowMatrix(const Matrix<T> & matrix) : m_data(std::make_shared<Matrix<T>>(matrix)) {}
+
+// Move constructor - other is left as an empty matrix, like a moved-from Matrix
+template<typename T>
+CowMatrix<T>::CowMatrix(CowMatrix<T> && other) noexcept : m_data(std::move(other.m_data)) {
+    other.m_data = empty_storage();
+}
+
+// Move assignment operator - other is left as an empty matrix
+template<typename T>
+CowMatrix<T> & CowMatrix<T>::operator=(CowMatrix<T> && other) noexcept {
+    if (this != &other) {
+        m_data = std::move(other.m_data);
+        other.m_data = empty_storage();
+    }
+    return *this;
+}
+
+// ACCESSORS
+
+// Get number of rows
+template<typename T>
+size_t CowMatrix<T>::rows() const {
+    return m_data->rows();
+}
+
+// Get number of columns
+template<typename T>
+size_t CowMatrix<T>::cols() const {
+    return m_data->cols();
+}
+
+// Access/modify an element - clones shared storage first
+template<typename T>
+T & CowMatrix<T>::operator()(size_t row, size_t col) {
+    detach();
+    return (*m_data)(row, col);
+}
+
+// Access an element - read only version, never clones
+template<typename T>
+const T & CowMatrix<T>::operator()(size_t row, size_t col) const {
+    return (*m_data)(row, col);
+}
+
+// The underlying matrix - read only
+template<typename T>
+const Matrix<T> & CowMatrix<T>::matrix() const {
+    return *m_data;
+}
+
+// The underlying matrix - clones shared storage first
+template<typename T>
+Matrix<T> & CowMatrix<T>::mutable_matrix() {
+    detach();
+    return *m_data;
+}
+
+// True if other copies currently share the elements
+template<typename T>
+bool CowMatrix<T>::is_shared() const {
+    return m_data.use_count() > 1;
+}
+
+// OPERATORS
+
+// Multiplication of matrices
+template<typename T>
+CowMatrix<T> CowMatrix<T>::operator*(const CowMatrix<T> & other) const {
+    return CowMatrix<T>(*m_data * *other.m_data);
+}
+
+// Addition of matrices
+template<typename T>
+CowMatrix<T> CowMatrix<T>::operator+(const CowMatrix<T> & other) const {
+    return CowMatrix<T>(*m_data + *other.m_data);
+}
+
+// Subtraction of matrices
+template<typename T>
+CowMatrix<T> CowMatrix<T>::operator-(const CowMatrix<T> & other) const {
+    return CowMatrix<T>(*m_data - *other.m_data);
+}
+
+// *= Operator - the product is a new matrix, so the old storage is simply released
+template<typename T>
+void CowMatrix<T>::operator*=(const CowMatrix<T> & other) {
+    *this = *this * other;
+}
+
+// += Operator
+template<typename T>
+void CowMatrix<T>::operator+=(const CowMatrix<T> & other) {
+    *this = *this + other;
+}
+
+// -= Operator
+template<typename T>
+void CowMatrix<T>::operator-=(const CowMatrix<T> & other) {
+    *this = *this - other;
+}
+
+// FUNCTIONS
+
+// Reset a matrix with default value
+template<typename T>
+void CowMatrix<T>::reset() {
+    detach();
+    m_data->reset();
+}
+
+// Insert row of zeroes before selected row
+template<typename T>
+void CowMatrix<T>::insert_row(size_t row) {
+    detach();
+    m_data->insert_row(row);
+}
+
+// Append row of zeroes after selected row
+template<typename T>
+void CowMatrix<T>::append_row(size_t row) {
+    detach();
+    m_data->append_row(row);
+}
+
+// Remove selected row
+template<typename T>
+void CowMatrix<T>::remove_row(size_t row) {
+    detach();
+    m_data->remove_row(row);
+}
+
+// Insert column of zeroes to the left of a selected column
+template<typename T>
+void CowMatrix<T>::insert_column(size_t col) {
+    detach();
+    m_data->insert_column(col);
+}
+
+// Append column of zeroes to the right of a selected column
+template<typename T>
+void CowMatrix<T>::append_column(size_t col) {
+    detach();
+    m_data->append_column(col);
+}
+
+// Remove selected column
+template<typename T>
+void CowMatrix<T>::remove_column(size_t col) {
+    detach();
+    m_data->remove_column(col);
+}
+
+// Insert count rows of zeroes before row pos, see Matrix
+template<typename T>
+void CowMatrix<T>::insert_rows(size_t pos, size_t count) {
+    detach();
+    m_data->insert_rows(pos, count);
+}
+
+// Insert count columns of zeroes to the left of column pos, see Matrix
+template<typename T>
+void CowMatrix<T>::insert_columns(size_t pos, size_t count) {
+    detach();
+    m_data->insert_columns(pos, count);
+}
+
+// Remove the given sorted rows
+template<typename T>
+void CowMatrix<T>::remove_rows(const std::vector<size_t> & sorted_rows) {
+    detach();
+    m_data->remove_rows(sorted_rows);
+}
+
+// Remove the given sorted columns
+template<typename T>
+void CowMatrix<T>::remove_columns(const std::vector<size_t> & sorted_cols) {
+    detach();
+    m_data->remove_columns(sorted_cols);
+}
+
+// New matrix made of the given rows - read only, never clones
+template<typename T>
+CowMatrix<T> CowMatrix<T>::gather_rows(const std::vector<size_t> & rows) const {
+    return CowMatrix<T>(m_data->gather_rows(rows));
+}
+
+// Overwrite row rows[i] with row i of source - clones shared storage first
+template<typename T>
+void CowMatrix<T>::scatter_rows(const std::vector<size_t> & rows, const CowMatrix<T> & source) {
+    detach();
+    m_data->scatter_rows(rows, *source.m_data);
+}
+
+// Empty matrix shared by all moved-from objects, so a move needs no allocation. Writes to it detach first.
+template<typename T>
+const std::shared_ptr<Matrix<T>> & CowMatrix<T>::empty_storage() {
+    static const std::shared_ptr<Matrix<T>> empty = std::make_shared<Matrix<T>>();
+    return empty;
+}
+
+// Clone the elements if another copy shares them. If the count is 1 no other CowMatrix owns the storage,
+// and none can start to, since that would need a copy of this object. use_count() is a relaxed load, so the
+// acquire fence orders our writes after everything a copy on another thread did before releasing the storage.
+template<typename T>
+void CowMatrix<T>::detach() {
+    if (m_data.use_count() > 1) {
+        m_data = std::make_shared<Matrix<T>>(*m_data);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+}
+
+// ITERATORS
+
+// begin() - clones shared storage first
+template<typename T>
+typename CowMatrix<T>::iterator CowMatrix<T>::begin() {
+    detach();
+    return m_data->begin();
+}
+
+// end() - clones shared storage first
+template<typename T>
+typename CowMatrix<T>::iterator CowMatrix<T>::end() {
+    detach();
+    return m_data->end();
+}
+
+// begin() - read only version
+template<typename T>
+typename CowMatrix<T>::const_iterator CowMatrix<T>::begin() const {
+    return m_data->cbegin();
+}
+
+// end() - read only version
+template<typename T>
+typename CowMatrix<T>::const_iterator CowMatrix<T>::end() const {
+    return m_data->cend();
+}
+
+// cbegin()
+template<typename T>
+typename CowMatrix<T>::const_iterator CowMatrix<T>::cbegin() const {
+    return m_data->cbegin();
+}
+
+// cend()
+template<typename T>
+typename CowMatrix<T>::const_iterator CowMatrix<T>::cend() const {
+    return m_data->cend();
+}
+
+// Range over one row - clones shared storage first
+template<typename T>
+MatrixRange<typename Matrix<T>::iterator> CowMatrix<T>::row(size_t row) {
+    detach();
+    return m_data->row(row);
+}
+
+// Range over one row - read only version
+template<typename T>
+MatrixRange<typename Matrix<T>::const_iterator> CowMatrix<T>::row(size_t row) const {
+    return static_cast<const Matrix<T> &>(*m_data).row(row);
+}
+
+// Range over one column - clones shared storage first
+template<typename T>
+MatrixRange<typename Matrix<T>::column_iterator> CowMatrix<T>::column(size_t col) {
+    detach();
+    return m_data->column(col);
+}
+
+// Range over one column - read only version
+template<typename T>
+MatrixRange<typename Matrix<T>::const_column_iterator> CowMatrix<T>::column(size_t col) const {
+    return static_cast<const Matrix<T> &>(*m_data).column(col);
+}
+
+// INPUT / OUTPUT
+
+// Input operator - reads into fresh storage, copies keep the old elements
+template<typename T>
+std::istream & operator>>(std::istream & is, CowMatrix<T> & m) {
+    Matrix<T> parsed;
+    is >> parsed;
+    m = CowMatrix<T>(std::move(parsed));
+    return is;
+}
+
+// Output operator
+template<typename T>
+std::ostream & operator<<(std::ostream & os, const CowMatrix<T> & m) {
+    return os << m.matrix();
+}
+
+#endif //COWMATRIX_H
@@ -13,6 +13,100 @@
 #include <algorithm>
 #include <cmath>
 #include <vector>
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+#include "MatrixStats.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// How the elements of a new matrix are first written
+enum class Placement {
+    Serial,     // The constructing thread fills the whole buffer
+    FirstTouch  // Worker threads fill the tiles they later process, so on NUMA hosts pages land next to them
+};
+
+// Random access iterator that steps a fixed number of elements, used to walk a column of a row-major buffer.
+// It keeps the start of the column and an element index, so the end of a column is index rows and no pointer
+// past the buffer is ever formed.
+template <typename U>
+class StrideIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::remove_const<U>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = U*;
+    using reference = U&;
+
+    StrideIterator() : m_base(nullptr), m_index(0), m_stride(0) {}
+    StrideIterator(U * base, difference_type index, difference_type stride) : m_base(base), m_index(index), m_stride(stride) {}
+
+    reference operator*() const { return m_base[m_index * m_stride]; }
+    pointer operator->() const { return m_base + m_index * m_stride; }
+    reference operator[](difference_type n) const { return m_base[(m_index + n) * m_stride]; }
+
+    StrideIterator & operator++() { ++m_index; return *this; }
+    StrideIterator operator++(int) { StrideIterator tmp(*this); ++m_index; return tmp; }
+    StrideIterator & operator--() { --m_index; return *this; }
+    StrideIterator operator--(int) { StrideIterator tmp(*this); --m_index; return tmp; }
+    StrideIterator & operator+=(difference_type n) { m_index += n; return *this; }
+    StrideIterator & operator-=(difference_type n) { m_index -= n; return *this; }
+
+    friend StrideIterator operator+(StrideIterator it, difference_type n) { return it += n; }
+    friend StrideIterator operator+(difference_type n, StrideIterator it) { return it += n; }
+    friend StrideIterator operator-(StrideIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const StrideIterator & a, const StrideIterator & b) { return a.m_index - b.m_index; }
+
+    friend bool operator==(const StrideIterator & a, const StrideIterator & b) { return a.m_index == b.m_index; }
+    friend bool operator!=(const StrideIterator & a, const StrideIterator & b) { return a.m_index != b.m_index; }
+    friend bool operator<(const StrideIterator & a, const StrideIterator & b) { return a.m_index < b.m_index; }
+    friend bool operator>(const StrideIterator & a, const StrideIterator & b) { return a.m_index > b.m_index; }
+    friend bool operator<=(const StrideIterator & a, const StrideIterator & b) { return a.m_index <= b.m_index; }
+    friend bool operator>=(const StrideIterator & a, const StrideIterator & b) { return a.m_index >= b.m_index; }
+
+private:
+    U * m_base;                 // First element of the column
+    difference_type m_index;    // Element index within the column
+    difference_type m_stride;
+};
+
+// A [first, last) pair of iterators, e.g. one row or one column of a matrix
+template <typename It>
+struct MatrixRange {
+    It first;
+    It last;
+
+    It begin() const { return first; }
+    It end() const { return last; }
+    size_t size() const { return static_cast<size_t>(std::distance(first, last)); }
+    typename std::iterator_traits<It>::reference operator[](size_t i) const { return first[i]; }
+};
+
+// A block of whole consecutive rows. Tiles never overlap, so they can be processed concurrently.
+template <typename U>
+struct MatrixTile {
+    size_t first_row;   // First row in the tile
+    size_t last_row;    // One past the last row in the tile
+    size_t cols;
+    U * first;          // Element (first_row, 0)
+
+    U * begin() const { return first; }
+    U * end() const { return first + (last_row - first_row) * cols; }
+    size_t rows() const { return last_row - first_row; }
+    size_t size() const { return rows() * cols; }
+    MatrixRange<U*> row(size_t r) const { return {first + r * cols, first + (r + 1) * cols}; } // r is relative to first_row
+};
 
 template <typename T>
 class Matrix {
@@ -23,9 +117,12 @@ public:
     Matrix();
     explicit Matrix(size_t dim); 
     Matrix(size_t rows, size_t cols);
+    Matrix(size_t rows, size_t cols, Placement placement);
     Matrix(const std::initializer_list<T> & list);
     Matrix(const Matrix<T> & other);
     Matrix(Matrix<T> && other) noexcept;
+    template<typename U>
+    explicit Matrix(const Matrix<U> & other);
 
     Matrix<T> & operator=(const Matrix<T> & other);
     Matrix<T> & operator=(Matrix<T> && other) noexcept;
@@ -51,6 +148,14 @@ public:
     // methods
     void reset();
 
+    // element-wise transforms, split across threads for large matrices
+    template<typename F>
+    void apply(F f);
+    template<typename F>
+    Matrix<typename std::invoke_result<F, const T &>::type> map(F f) const;
+    template<typename U, typename F>
+    void zip_apply(const Matrix<U> & other, F f);
+
     void insert_row(size_t row);
     void append_row(size_t row);
     void remove_row(size_t row);
@@ -58,13 +163,50 @@ public:
     void append_column(size_t col);
     void remove_column(size_t col);
 
+    // bulk edits, each a single pass over the elements
+    void insert_rows(size_t pos, size_t count);
+    void insert_columns(size_t pos, size_t count);
+    void remove_rows(const std::vector<size_t> & sorted_rows);
+    void remove_columns(const std::vector<size_t> & sorted_cols);
+    Matrix<T> gather_rows(const std::vector<size_t> & rows) const;
+    void scatter_rows(const std::vector<size_t> & rows, const Matrix<T> & source);
+
     // iterators
     typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef StrideIterator<T> column_iterator;
+    typedef StrideIterator<const T> const_column_iterator;
 
     iterator begin();
     iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    T * data();
+    const T * data() const;
+
+    MatrixRange<iterator> row(size_t row);
+    MatrixRange<const_iterator> row(size_t row) const;
+    MatrixRange<column_iterator> column(size_t col);
+    MatrixRange<const_column_iterator> column(size_t col) const;
+
+    // Split the matrix into tiles of whole rows, e.g. for std::for_each(std::execution::par_unseq, ...).
+    // tile_rows = 0 picks a tile height automatically.
+    std::vector<MatrixTile<T>> tiles(size_t tile_rows = 0);
+    std::vector<MatrixTile<const T>> tiles(size_t tile_rows = 0) const;
 
 private:
+    template<typename U> friend class Matrix;
+
+    // Tag for a buffer that is allocated but not filled. The caller writes every element, which for trivially
+    // constructible T is also the first touch of the pages.
+    struct Unfilled {};
+    Matrix(size_t rows, size_t cols, Unfilled);
+
+    size_t default_tile_rows() const;
+
     size_t m_rows;
     size_t m_cols;
     size_t m_capacity;
@@ -82,6 +224,44 @@ std::ostream & operator<<(std::ostream & os, const Matrix<T> & m);
 template<typename T>
 Matrix<T> identity(size_t dim);
 
+template<typename T>
+Matrix<T> hstack(const Matrix<T> & left, const Matrix<T> & right);
+
+template<typename T>
+Matrix<T> vstack(const Matrix<T> & top, const Matrix<T> & bottom);
+
+template<typename A, typename B, typename C>
+void gemm_kernel(const A * a, const B * b, C * c, size_t n, size_t m, size_t p);
+
+// Element types made of a (real, imaginary) pair of doubles, such as Complex. Detected from the type itself,
+// so every translation unit that multiplies Matrix<T> sees the same answer whatever else it includes.
+template<typename T, typename = void>
+struct is_split_complex : std::false_type {};
+
+template<typename T>
+struct is_split_complex<T, typename std::enable_if<
+        std::is_same<decltype(std::declval<const T &>().real()), double>::value &&
+        std::is_same<decltype(std::declval<const T &>().imag()), double>::value &&
+        std::is_constructible<T, double, double>::value>::type> : std::true_type {};
+
+void complex_gemm_kernel(const double * ar, const double * ai, const double * br, const double * bi,
+                         double * cr, double * ci, size_t n, size_t m, size_t p);
+
+template<typename T>
+void product_kernel(const T * a, const T * b, T * c, size_t n, size_t m, size_t p);
+
+template<typename Acc, typename A, typename B>
+Matrix<Acc> multiply(const Matrix<A> & lhs, const Matrix<B> & rhs);
+
+template<typename A, typename B, typename = typename std::enable_if<!std::is_same<A, B>::value>::type>
+Matrix<decltype(A() * B())> operator*(const Matrix<A> & lhs, const Matrix<B> & rhs);
+
+template<typename Tile, typename F>
+void parallel_for_each_tile(const std::vector<Tile> & tiles, F f);
+
+bool set_worker_pinning(bool enabled);
+bool worker_pinning();
+
 //
 // Implementations
 //
@@ -95,15 +275,38 @@ Matrix<T>::Matrix() : m_rows(0), m_cols(0), m_capacity(0), m_vec(nullptr) {}
 // Square matrix with default elements constructor
 template<typename T>
 Matrix<T>::Matrix(size_t dim) : m_rows(dim), m_cols(dim), m_capacity(dim*dim), m_vec(new T[dim*dim]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
    std::fill_n(m_vec, dim*dim, T()); // Elements are initialised to default element of type T
 }  
 
 // Defined row and column size with default elements constructor
 template<typename T>
 Matrix<T>::Matrix(size_t rows, size_t cols) : m_rows(rows), m_cols(cols), m_capacity(rows*cols), m_vec(new T[rows*cols]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
     std::fill_n(m_vec, rows*cols, T());
 } 
 
+// Defined row and column size with default elements, choosing how the buffer is first written.
+// new T[] leaves trivially constructible elements untouched, so with FirstTouch the pages are only mapped
+// when parallel_for_each_tile's workers write them. Other types are constructed by new T[] already.
+template<typename T>
+Matrix<T>::Matrix(size_t rows, size_t cols, Placement placement) : m_rows(rows), m_cols(cols), m_capacity(rows*cols), m_vec(new T[rows*cols]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
+    if (placement == Placement::FirstTouch) {
+        parallel_for_each_tile(tiles(), [](const MatrixTile<T> & tile) {
+            std::fill(tile.begin(), tile.end(), T());
+        });
+    } else {
+        std::fill_n(m_vec, rows*cols, T());
+    }
+}
+
+// Defined row and column size, elements left for the caller to write
+template<typename T>
+Matrix<T>::Matrix(size_t rows, size_t cols, Unfilled) : m_rows(rows), m_cols(cols), m_capacity(rows*cols), m_vec(new T[rows*cols]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
+}
+
 // Create square matrix using list that decides the elements. List length must be perfect square. 
 template<typename T>
 Matrix<T>::Matrix(const std::initializer_list<T> & list) {
@@ -112,6 +315,7 @@ Matrix<T>::Matrix(const std::initializer_list<T> & list) {
         m_rows = m_cols = squareRoot;
         m_capacity = list.size();
         m_vec = new T[m_capacity];
+        MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
 
         // Each element in the list becomes an element in the matrix
         size_t i = 0;
@@ -124,14 +328,28 @@ Matrix<T>::Matrix(const std::initializer_list<T> & list) {
     
 }
 
-// Copy constructor
+// Copy constructor - copies only the elements in use, not spare capacity left by reset() or remove_rows()
 template<typename T>
-Matrix<T>::Matrix(const Matrix<T> & other) : m_rows(other.m_rows), m_cols(other.m_cols), m_capacity(other.m_capacity), m_vec(new T[other.m_capacity]) {
+Matrix<T>::Matrix(const Matrix<T> & other) : m_rows(other.m_rows), m_cols(other.m_cols), m_capacity(other.m_rows*other.m_cols), m_vec(new T[m_capacity]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
+    MATRIX_STATS_SCOPE(MatrixOp::Copy, 0, 2 * m_capacity * sizeof(T));
     for (size_t i = 0; i < m_capacity; i++) {
         m_vec[i] = other.m_vec[i];
     }
 }
 
+// Converting constructor - each element is converted with static_cast
+template<typename T>
+template<typename U>
+Matrix<T>::Matrix(const Matrix<U> & other) : m_rows(other.rows()), m_cols(other.cols()), m_capacity(other.rows()*other.cols()), m_vec(new T[m_capacity]) {
+    MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
+    MATRIX_STATS_SCOPE(MatrixOp::Copy, 0, m_capacity * (sizeof(T) + sizeof(U)));
+    const U * src = other.data();
+    for (size_t i = 0; i < m_capacity; i++) {
+        m_vec[i] = static_cast<T>(src[i]);
+    }
+}
+
 // Move constructor
 template<typename T>
 Matrix<T>::Matrix(Matrix<T> && other) noexcept : m_rows(other.m_rows), m_cols(other.m_cols), m_capacity(other.m_capacity), m_vec(other.m_vec) {
@@ -145,10 +363,12 @@ Matrix<T> & Matrix<T>::operator=(const Matrix<T> & other) {
     if(this != &other){
         m_rows = other.m_rows;
         m_cols = other.m_cols;
-        m_capacity = other.m_capacity;
+        m_capacity = other.m_rows * other.m_cols; // Spare capacity of other is not copied
         
         delete[] m_vec;
         m_vec = new T[m_capacity];
+        MATRIX_STATS_ALLOCATION(m_capacity * sizeof(T));
+        MATRIX_STATS_SCOPE(MatrixOp::Copy, 0, 2 * m_capacity * sizeof(T));
 
         for (size_t i = 0; i < m_capacity; i++) {
             m_vec[i] = other.m_vec[i];
@@ -218,20 +438,10 @@ const T & Matrix<T>::operator()(size_t row, size_t col) const {
 // Multiplication of matrices
 template<typename T>
 Matrix<T> Matrix<T>::operator*(const Matrix<T> & other) const {
+    MATRIX_STATS_SCOPE(MatrixOp::Multiply, 2 * m_rows * m_cols * other.m_cols, (m_rows * m_cols + other.m_rows * other.m_cols + m_rows * other.m_cols) * sizeof(T));
     if(m_cols == other.m_rows){
         Matrix<T> resultMatrix(m_rows, other.m_cols);
-        
-        // Go through each row of matrix 1 and multiply with each column of matrix 2 by calculating the dot product. 
-        for (size_t i = 0; i < m_rows; i++) {
-            for (size_t j = 0; j < other.m_cols; j++) {
-                // Calculate the dot product
-                T sum = 0;
-                for (size_t k = 0; k < m_cols; k++) {
-                    sum += m_vec[i * m_cols + k] * other.m_vec[k * other.m_cols + j];
-                }
-                resultMatrix(i, j) = sum;
-            }
-        }
+        product_kernel(m_vec, other.m_vec, resultMatrix.m_vec, m_rows, m_cols, other.m_cols);
         return resultMatrix;
     }
     throw std::out_of_range("Wrong dimensions!");
@@ -240,11 +450,18 @@ Matrix<T> Matrix<T>::operator*(const Matrix<T> & other) const {
 // Addition of matrices
 template<typename T>
 Matrix<T> Matrix<T>::operator+(const Matrix<T> & other) const {
+    MATRIX_STATS_SCOPE(MatrixOp::Add, m_rows * m_cols, 3 * m_rows * m_cols * sizeof(T));
     if(m_rows == other.m_rows && m_cols == other.m_cols){
-        Matrix<T> resultMatrix(m_rows, m_cols);
-        for (size_t i = 0; i < resultMatrix.m_capacity; i++) {
-            resultMatrix.m_vec[i] = m_vec[i] + other.m_vec[i]; // Add each corresponding element
-        }
+        Matrix<T> resultMatrix(m_rows, m_cols, Unfilled());
+        const T * rhs = other.m_vec;
+        T * out = resultMatrix.m_vec;
+        parallel_for_each_tile(tiles(), [rhs, out, this](const MatrixTile<const T> & tile) {
+            const size_t offset = tile.first_row * m_cols;
+            const size_t n = tile.size();
+            for (size_t i = 0; i < n; i++) {
+                out[offset + i] = m_vec[offset + i] + rhs[offset + i]; // Add each corresponding element
+            }
+        });
         return resultMatrix;
     }
     throw std::out_of_range("Wrong dimensions!");
@@ -253,11 +470,18 @@ Matrix<T> Matrix<T>::operator+(const Matrix<T> & other) const {
 // Subtraction of matrices
 template<typename T>
 Matrix<T> Matrix<T>::operator-(const Matrix<T> & other) const {
+    MATRIX_STATS_SCOPE(MatrixOp::Add, m_rows * m_cols, 3 * m_rows * m_cols * sizeof(T));
     if(m_rows == other.m_rows && m_cols == other.m_cols){
-        Matrix<T> resultMatrix(m_rows, m_cols);
-        for (size_t i = 0; i < resultMatrix.m_capacity; i++) {
-            resultMatrix.m_vec[i] = m_vec[i] - other.m_vec[i]; // Subtract each corresponding element
-        }
+        Matrix<T> resultMatrix(m_rows, m_cols, Unfilled());
+        const T * rhs = other.m_vec;
+        T * out = resultMatrix.m_vec;
+        parallel_for_each_tile(tiles(), [rhs, out, this](const MatrixTile<const T> & tile) {
+            const size_t offset = tile.first_row * m_cols;
+            const size_t n = tile.size();
+            for (size_t i = 0; i < n; i++) {
+                out[offset + i] = m_vec[offset + i] - rhs[offset + i]; // Subtract each corresponding element
+            }
+        });
         return resultMatrix;
     }
     throw std::out_of_range("Wrong dimensions!");
@@ -291,9 +515,63 @@ void Matrix<T>::reset() {
     m_cols = 0;
 }
 
+// Replace every element x with f(x)
+template<typename T>
+template<typename F>
+void Matrix<T>::apply(F f) {
+    MATRIX_STATS_SCOPE(MatrixOp::Transform, m_rows * m_cols, 2 * m_rows * m_cols * sizeof(T));
+    parallel_for_each_tile(tiles(), [&f](const MatrixTile<T> & tile) {
+        T * elems = tile.begin();
+        const size_t n = tile.size();
+        for (size_t i = 0; i < n; i++) {
+            elems[i] = f(elems[i]);
+        }
+    });
+}
+
+// New matrix with f(x) for every element x. The element type is whatever f returns.
+// The result is first written by the workers that compute it, so its pages are placed like the input's.
+template<typename T>
+template<typename F>
+Matrix<typename std::invoke_result<F, const T &>::type> Matrix<T>::map(F f) const {
+    MATRIX_STATS_SCOPE(MatrixOp::Transform, m_rows * m_cols, 2 * m_rows * m_cols * sizeof(T));
+    typedef typename std::invoke_result<F, const T &>::type R;
+    Matrix<R> resultMatrix(m_rows, m_cols, typename Matrix<R>::Unfilled());
+    R * out = resultMatrix.data();
+    parallel_for_each_tile(tiles(), [&f, out, this](const MatrixTile<const T> & tile) {
+        const T * elems = tile.begin();
+        R * dst = out + tile.first_row * m_cols;
+        const size_t n = tile.size();
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = f(elems[i]);
+        }
+    });
+    return resultMatrix;
+}
+
+// Replace every element x with f(x, y), where y is the element in the same position of other
+template<typename T>
+template<typename U, typename F>
+void Matrix<T>::zip_apply(const Matrix<U> & other, F f) {
+    MATRIX_STATS_SCOPE(MatrixOp::Transform, m_rows * m_cols, m_rows * m_cols * (2 * sizeof(T) + sizeof(U)));
+    if (m_rows != other.rows() || m_cols != other.cols()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    const U * in = other.data();
+    parallel_for_each_tile(tiles(), [&f, in, this](const MatrixTile<T> & tile) {
+        T * elems = tile.begin();
+        const U * src = in + tile.first_row * m_cols;
+        const size_t n = tile.size();
+        for (size_t i = 0; i < n; i++) {
+            elems[i] = f(elems[i], src[i]);
+        }
+    });
+}
+
 // Insert row of zeroes before selected row
 template<typename T>
 void Matrix<T>::insert_row(size_t row) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (row < m_rows) {
         Matrix<T> newMatrix(m_rows + 1, m_cols); // New matrix with extra row
 
@@ -321,6 +599,7 @@ void Matrix<T>::insert_row(size_t row) {
 // Append row of zeroes after selected row
 template<typename T>
 void Matrix<T>::append_row(size_t row) { 
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (row < m_rows) {
         Matrix<T> newMatrix(m_rows + 1, m_cols); // New matrix with extra row
         for (size_t i = 0; i < row+1; i++) {      // Rows above new row are in same position
@@ -348,6 +627,7 @@ void Matrix<T>::append_row(size_t row) {
 // Remove selected row
 template<typename T>
 void Matrix<T>::remove_row(size_t row) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (row < m_rows) {
         Matrix<T> newMatrix(m_rows - 1, m_cols);    // New matrix with one less row
 
@@ -373,6 +653,7 @@ void Matrix<T>::remove_row(size_t row) {
 // Insert column of zeroes to the left of a selected column
 template<typename T>
 void Matrix<T>::insert_column(size_t col) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (col < m_cols) {
         Matrix<T> newMatrix(m_rows, m_cols + 1); // New matrix with extra column
 
@@ -400,6 +681,7 @@ void Matrix<T>::insert_column(size_t col) {
 // Append column of zeroes to the right of a selected column
 template<typename T>
 void Matrix<T>::append_column(size_t col) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (col < m_cols) {
         Matrix<T> newMatrix(m_rows, m_cols + 1); // New matrix with extra column
         
@@ -427,6 +709,7 @@ void Matrix<T>::append_column(size_t col) {
 // Remove selected column
 template<typename T>
 void Matrix<T>::remove_column(size_t col) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
     if (col < m_cols) {
         Matrix<T> newMatrix(m_rows, m_cols - 1); // New matrix with one less row
 
@@ -449,6 +732,117 @@ void Matrix<T>::remove_column(size_t col) {
     }
 }
 
+// Insert count rows of zeroes before row pos. pos == rows() appends them at the bottom.
+template<typename T>
+void Matrix<T>::insert_rows(size_t pos, size_t count) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
+    if (pos > m_rows) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> newMatrix(m_rows + count, m_cols);
+    std::move(m_vec, m_vec + pos * m_cols, newMatrix.m_vec);                                     // Rows above
+    std::move(m_vec + pos * m_cols, m_vec + m_rows * m_cols, newMatrix.m_vec + (pos + count) * m_cols); // Rows below
+    *this = std::move(newMatrix);
+}
+
+// Insert count columns of zeroes to the left of column pos. pos == cols() appends them on the right.
+template<typename T>
+void Matrix<T>::insert_columns(size_t pos, size_t count) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
+    if (pos > m_cols) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> newMatrix(m_rows, m_cols + count);
+    for (size_t i = 0; i < m_rows; i++) {
+        T * src = m_vec + i * m_cols;
+        T * dst = newMatrix.m_vec + i * newMatrix.m_cols;
+        std::move(src, src + pos, dst);
+        std::move(src + pos, src + m_cols, dst + pos + count);
+    }
+    *this = std::move(newMatrix);
+}
+
+// Remove the given rows, which must be sorted and unique. Kept rows are moved up in place, so the
+// buffer keeps its capacity like reset() does.
+template<typename T>
+void Matrix<T>::remove_rows(const std::vector<size_t> & sorted_rows) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
+    for (size_t i = 0; i < sorted_rows.size(); i++) {
+        if (sorted_rows[i] >= m_rows || (i > 0 && sorted_rows[i] <= sorted_rows[i - 1])) {
+            throw std::out_of_range("Wrong dimensions!");
+        }
+    }
+    size_t write = 0;   // Next row position to fill
+    size_t next = 0;    // Next entry of sorted_rows to skip
+    for (size_t read = 0; read < m_rows; read++) {
+        if (next < sorted_rows.size() && sorted_rows[next] == read) {
+            next++;
+            continue;
+        }
+        if (write != read) {
+            std::move(m_vec + read * m_cols, m_vec + (read + 1) * m_cols, m_vec + write * m_cols);
+        }
+        write++;
+    }
+    m_rows = write;
+}
+
+// Remove the given columns, which must be sorted and unique. Elements are compacted in place in one
+// forward pass, since the write position never passes the read position.
+template<typename T>
+void Matrix<T>::remove_columns(const std::vector<size_t> & sorted_cols) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * m_rows * m_cols * sizeof(T));
+    std::vector<bool> removed(m_cols, false);
+    for (size_t i = 0; i < sorted_cols.size(); i++) {
+        if (sorted_cols[i] >= m_cols || (i > 0 && sorted_cols[i] <= sorted_cols[i - 1])) {
+            throw std::out_of_range("Wrong dimensions!");
+        }
+        removed[sorted_cols[i]] = true;
+    }
+    T * write = m_vec;
+    for (size_t i = 0; i < m_rows; i++) {
+        for (size_t j = 0; j < m_cols; j++) {
+            if (!removed[j]) {
+                T * read = m_vec + i * m_cols + j;
+                if (write != read) {
+                    *write = std::move(*read);
+                }
+                write++;
+            }
+        }
+    }
+    m_cols -= sorted_cols.size();
+}
+
+// New matrix made of the given rows, in the given order. Rows may repeat.
+template<typename T>
+Matrix<T> Matrix<T>::gather_rows(const std::vector<size_t> & rows) const {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * rows.size() * m_cols * sizeof(T));
+    Matrix<T> resultMatrix(rows.size(), m_cols);
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (rows[i] >= m_rows) {
+            throw std::out_of_range("Wrong dimensions!");
+        }
+        std::copy(m_vec + rows[i] * m_cols, m_vec + (rows[i] + 1) * m_cols, resultMatrix.m_vec + i * m_cols);
+    }
+    return resultMatrix;
+}
+
+// Overwrite row rows[i] with row i of source
+template<typename T>
+void Matrix<T>::scatter_rows(const std::vector<size_t> & rows, const Matrix<T> & source) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * rows.size() * m_cols * sizeof(T));
+    if (source.m_rows != rows.size() || source.m_cols != m_cols) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (rows[i] >= m_rows) {
+            throw std::out_of_range("Wrong dimensions!");
+        }
+        std::copy(source.m_vec + i * m_cols, source.m_vec + (i + 1) * m_cols, m_vec + rows[i] * m_cols);
+    }
+}
+
 // ITERATORS
 
 // begin()
@@ -463,6 +857,118 @@ typename Matrix<T>::iterator Matrix<T>::end() {
     return m_vec + m_rows * m_cols;
 }
 
+// begin() - read only version
+template<typename T>
+typename Matrix<T>::const_iterator Matrix<T>::begin() const {
+    return m_vec;
+}
+
+// end() - read only version
+template<typename T>
+typename Matrix<T>::const_iterator Matrix<T>::end() const {
+    return m_vec + m_rows * m_cols;
+}
+
+// cbegin()
+template<typename T>
+typename Matrix<T>::const_iterator Matrix<T>::cbegin() const {
+    return begin();
+}
+
+// cend()
+template<typename T>
+typename Matrix<T>::const_iterator Matrix<T>::cend() const {
+    return end();
+}
+
+// Raw pointer to the row-major element buffer
+template<typename T>
+T * Matrix<T>::data() {
+    return m_vec;
+}
+
+// Raw pointer to the row-major element buffer - read only version
+template<typename T>
+const T * Matrix<T>::data() const {
+    return m_vec;
+}
+
+// Range over the elements of one row
+template<typename T>
+MatrixRange<typename Matrix<T>::iterator> Matrix<T>::row(size_t row) {
+    if (row < m_rows) {
+        return {m_vec + row * m_cols, m_vec + (row + 1) * m_cols};
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Range over the elements of one row - read only version
+template<typename T>
+MatrixRange<typename Matrix<T>::const_iterator> Matrix<T>::row(size_t row) const {
+    if (row < m_rows) {
+        return {m_vec + row * m_cols, m_vec + (row + 1) * m_cols};
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Range over the elements of one column. The iterator steps one full row at a time.
+template<typename T>
+MatrixRange<typename Matrix<T>::column_iterator> Matrix<T>::column(size_t col) {
+    if (col < m_cols) {
+        return {column_iterator(m_vec + col, 0, m_cols), column_iterator(m_vec + col, m_rows, m_cols)};
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Range over the elements of one column - read only version
+template<typename T>
+MatrixRange<typename Matrix<T>::const_column_iterator> Matrix<T>::column(size_t col) const {
+    if (col < m_cols) {
+        return {const_column_iterator(m_vec + col, 0, m_cols), const_column_iterator(m_vec + col, m_rows, m_cols)};
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Tile height giving roughly 16K elements per tile, which keeps a tile in L2 while leaving enough tiles to share out
+template<typename T>
+size_t Matrix<T>::default_tile_rows() const {
+    const size_t elementsPerTile = 16384;
+    if (m_cols == 0 || m_cols >= elementsPerTile) {
+        return 1;
+    }
+    return elementsPerTile / m_cols;
+}
+
+// Split into tiles of tile_rows rows. The last tile holds the remaining rows.
+template<typename T>
+std::vector<MatrixTile<T>> Matrix<T>::tiles(size_t tile_rows) {
+    if (tile_rows == 0) {
+        tile_rows = default_tile_rows();
+    }
+    std::vector<MatrixTile<T>> result;
+    result.reserve((m_rows + tile_rows - 1) / tile_rows);
+    for (size_t r = 0; r < m_rows; r += tile_rows) {
+        size_t last = std::min(r + tile_rows, m_rows);
+        result.push_back({r, last, m_cols, m_vec + r * m_cols});
+    }
+    return result;
+}
+
+// Split into tiles of tile_rows rows - read only version
+template<typename T>
+std::vector<MatrixTile<const T>> Matrix<T>::tiles(size_t tile_rows) const {
+    if (tile_rows == 0) {
+        tile_rows = default_tile_rows();
+    }
+    std::vector<MatrixTile<const T>> result;
+    result.reserve((m_rows + tile_rows - 1) / tile_rows);
+    for (size_t r = 0; r < m_rows; r += tile_rows) {
+        size_t last = std::min(r + tile_rows, m_rows);
+        result.push_back({r, last, m_cols, m_vec + r * m_cols});
+    }
+    return result;
+}
+
 // INPUT / OUTPUT
 
 // Input operator
@@ -492,6 +998,7 @@ std::istream & operator>>(std::istream & is, Matrix<T> & m) {
     if(rows > 0 ){
         columns = parsedMatrix[0].size();
     }
+    MATRIX_STATS_SCOPE(MatrixOp::Input, 0, rows * columns * sizeof(T));
     m = Matrix<T>(rows, columns);  // Resize the matrix that is reading from input stream
     for (size_t i = 0; i < rows; i++) {  // Copy values from parsedMatrix to m
         for (size_t j = 0; j < columns; j++) {
@@ -504,6 +1011,7 @@ std::istream & operator>>(std::istream & is, Matrix<T> & m) {
 // Output operator
 template<typename T>
 std::ostream & operator<<(std::ostream & os, const Matrix<T> & m) {
+    MATRIX_STATS_SCOPE(MatrixOp::Output, 0, m.rows() * m.cols() * sizeof(T));
     for (size_t i = 0; i < m.rows(); i++) {
         if (i == 0) {
             os << "[ ";
@@ -535,4 +1043,362 @@ Matrix<T> identity(size_t dim) {
     return id;
 }
 
+// Place two matrices with the same number of rows side by side
+template<typename T>
+Matrix<T> hstack(const Matrix<T> & left, const Matrix<T> & right) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * (left.rows() * left.cols() + right.rows() * right.cols()) * sizeof(T));
+    if (left.rows() != right.rows()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(left.rows(), left.cols() + right.cols());
+    for (size_t i = 0; i < left.rows(); i++) {
+        T * dst = std::copy(left.row(i).begin(), left.row(i).end(), result.row(i).begin());
+        std::copy(right.row(i).begin(), right.row(i).end(), dst);
+    }
+    return result;
+}
+
+// Place two matrices with the same number of columns on top of each other
+template<typename T>
+Matrix<T> vstack(const Matrix<T> & top, const Matrix<T> & bottom) {
+    MATRIX_STATS_SCOPE(MatrixOp::RowColumnEdit, 0, 2 * (top.rows() * top.cols() + bottom.rows() * bottom.cols()) * sizeof(T));
+    if (top.cols() != bottom.cols()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(top.rows() + bottom.rows(), top.cols());
+    std::copy(bottom.begin(), bottom.end(), std::copy(top.begin(), top.end(), result.begin()));
+    return result;
+}
+
+// Blocked matrix product c += a * b on row-major buffers, where a is n x m, b is m x p and c is n x p.
+// The k-loop is hoisted out of the j-loop so the innermost loop streams through contiguous rows of b and c,
+// which the compiler can vectorize. Blocking over k and j keeps the touched part of b in cache.
+// The element types may differ: every product and sum is done in c's type, so a wider C gives a wider
+// accumulator (e.g. float inputs into a double buffer) at the same loop structure.
+template<typename A, typename B, typename C>
+void gemm_kernel(const A * a, const B * b, C * c, size_t n, size_t m, size_t p) {
+    const size_t kBlock = 128;
+    const size_t jBlock = 512;
+    for (size_t kk = 0; kk < m; kk += kBlock) {
+        size_t kEnd = std::min(kk + kBlock, m);
+        for (size_t jj = 0; jj < p; jj += jBlock) {
+            size_t jEnd = std::min(jj + jBlock, p);
+            for (size_t i = 0; i < n; i++) {
+                C * cRow = c + i * p;
+                for (size_t k = kk; k < kEnd; k++) {
+                    const C aik = static_cast<C>(a[i * m + k]);
+                    const B * bRow = b + k * p;
+                    for (size_t j = jj; j < jEnd; j++) {
+                        cRow[j] += aik * static_cast<C>(bRow[j]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Blocked product c += a * b on split planes. Same loop order as gemm_kernel, but each pass over a row of b
+// updates both output planes, so every loaded element feeds two multiply-adds and the inner loop has no
+// Complex temporaries for the compiler to keep interleaved.
+inline void complex_gemm_kernel(const double * ar, const double * ai, const double * br, const double * bi,
+                                double * cr, double * ci, size_t n, size_t m, size_t p) {
+    const size_t kBlock = 128;
+    const size_t jBlock = 512;
+    for (size_t kk = 0; kk < m; kk += kBlock) {
+        size_t kEnd = std::min(kk + kBlock, m);
+        for (size_t jj = 0; jj < p; jj += jBlock) {
+            size_t jEnd = std::min(jj + jBlock, p);
+            for (size_t i = 0; i < n; i++) {
+                double * crRow = cr + i * p;
+                double * ciRow = ci + i * p;
+                for (size_t k = kk; k < kEnd; k++) {
+                    const double xr = ar[i * m + k];
+                    const double xi = ai[i * m + k];
+                    const double * brRow = br + k * p;
+                    const double * biRow = bi + k * p;
+                    for (size_t j = jj; j < jEnd; j++) {
+                        crRow[j] += xr * brRow[j] - xi * biRow[j];
+                        ciRow[j] += xr * biRow[j] + xi * brRow[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Generic element type: the blocked kernel on the elements as stored
+template<typename T>
+void product_kernel(const T * a, const T * b, T * c, size_t n, size_t m, size_t p, std::false_type) {
+    gemm_kernel(a, b, c, n, m, p);
+}
+
+// Complex element type: split into real and imaginary planes, multiply the planes, merge back
+template<typename T>
+void product_kernel(const T * a, const T * b, T * c, size_t n, size_t m, size_t p, std::true_type) {
+    std::vector<double> ar(n * m), ai(n * m), br(m * p), bi(m * p), cr(n * p), ci(n * p);
+    for (size_t i = 0; i < n * m; i++) {
+        ar[i] = a[i].real();
+        ai[i] = a[i].imag();
+    }
+    for (size_t i = 0; i < m * p; i++) {
+        br[i] = b[i].real();
+        bi[i] = b[i].imag();
+    }
+    for (size_t i = 0; i < n * p; i++) {
+        cr[i] = c[i].real();
+        ci[i] = c[i].imag();
+    }
+    complex_gemm_kernel(ar.data(), ai.data(), br.data(), bi.data(), cr.data(), ci.data(), n, m, p);
+    for (size_t i = 0; i < n * p; i++) {
+        c[i] = T(cr[i], ci[i]);
+    }
+}
+
+// c += a * b for Matrix<T>::operator*, picking the kernel from the element type
+template<typename T>
+void product_kernel(const T * a, const T * b, T * c, size_t n, size_t m, size_t p) {
+    product_kernel(a, b, c, n, m, p, is_split_complex<T>());
+}
+
+// Product with every multiply-add done in Acc, e.g. multiply<double>(floats) or multiply<int32_t>(int16s).
+// The result keeps the accumulator type; convert back with Matrix<T>(result) if needed.
+template<typename Acc, typename A, typename B>
+Matrix<Acc> multiply(const Matrix<A> & lhs, const Matrix<B> & rhs) {
+    MATRIX_STATS_SCOPE(MatrixOp::Multiply, 2 * lhs.rows() * lhs.cols() * rhs.cols(), lhs.rows() * lhs.cols() * sizeof(A) + rhs.rows() * rhs.cols() * sizeof(B) + lhs.rows() * rhs.cols() * sizeof(Acc));
+    if (lhs.cols() != rhs.rows()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<Acc> result(lhs.rows(), rhs.cols());
+    gemm_kernel(lhs.data(), rhs.data(), result.data(), lhs.rows(), lhs.cols(), rhs.cols());
+    return result;
+}
+
+// Product of matrices with different element types. The result has the type of A() * B() (so int16_t
+// operands give int), and the products are accumulated in that type.
+template<typename A, typename B, typename>
+Matrix<decltype(A() * B())> operator*(const Matrix<A> & lhs, const Matrix<B> & rhs) {
+    return multiply<decltype(A() * B())>(lhs, rhs);
+}
+
+// CPUs the process may run on when first asked, in increasing order. Empty where the mask cannot be read.
+inline const std::vector<int> & allowed_cpus() {
+    static const std::vector<int> cpus = [] {
+        std::vector<int> list;
+#ifdef __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &mask)) {
+                    list.push_back(cpu);
+                }
+            }
+        }
+#endif
+        return list;
+    }();
+    return cpus;
+}
+
+// Whether parallel_for_each_tile pins its workers, one per CPU of allowed_cpus(). Off by default.
+inline std::atomic<bool> & worker_pinning_flag() {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+}
+
+// Turn worker pinning on or off. Returns false, and leaves pinning off, where the CPU mask cannot be read
+// (e.g. outside Linux); kernels then run on unpinned workers as before.
+inline bool set_worker_pinning(bool enabled) {
+    if (enabled && allowed_cpus().empty()) {
+        worker_pinning_flag() = false;
+        return false;
+    }
+    worker_pinning_flag() = enabled;
+    return true;
+}
+
+inline bool worker_pinning() {
+    return worker_pinning_flag();
+}
+
+// Pin the calling thread to one CPU. Returns false where pinning is not supported or the CPU is not allowed.
+inline bool pin_current_thread(int cpu) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Let the calling thread run on every CPU of allowed_cpus() again
+inline bool unpin_current_thread() {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : allowed_cpus()) {
+        CPU_SET(cpu, &cpus);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    return true;
+#endif
+}
+
+// Set while the calling thread runs tiles, so a kernel called from inside f runs serially instead of
+// waiting on the pool it is part of
+inline bool & in_tile_worker() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+// Threads kept between parallel_for_each_tile calls: they are started on first use and only woken afterwards.
+// Pool thread w always runs block w of a call, so the same thread touches the same tiles every time.
+class TileWorkerPool {
+public:
+    static TileWorkerPool & instance();
+    ~TileWorkerPool();
+
+    // Run job(w) for w in [first, last) on the pool threads, plus job(0) on the calling thread when first is 1,
+    // and wait for all of them. job must not throw. With pin, thread w first moves to CPU w of allowed_cpus();
+    // a thread that cannot be pinned runs its block unpinned.
+    void run(size_t first, size_t last, bool pin, const std::function<void(size_t)> & job);
+
+private:
+    TileWorkerPool() {}
+    void loop(size_t index, size_t generation);
+
+    std::mutex m_runMutex;  // One call at a time
+    std::mutex m_mutex;     // Guards the fields below
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_threads;
+    const std::function<void(size_t)> * m_job = nullptr;
+    size_t m_first = 0;
+    size_t m_last = 0;
+    bool m_pin = false;
+    size_t m_generation = 0;    // Bumped once per call
+    size_t m_pending = 0;       // Pool threads still running the current call
+    bool m_stop = false;
+};
+
+inline TileWorkerPool & TileWorkerPool::instance() {
+    static TileWorkerPool pool;
+    return pool;
+}
+
+// Stop and join the threads
+inline TileWorkerPool::~TileWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread & thread : m_threads) {
+        thread.join();
+    }
+}
+
+// Publish the call, start threads the pool does not have yet, and wait until every block has run
+inline void TileWorkerPool::run(size_t first, size_t last, bool pin, const std::function<void(size_t)> & job) {
+    std::lock_guard<std::mutex> call(m_runMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (m_threads.size() < last) {
+            m_threads.emplace_back(&TileWorkerPool::loop, this, m_threads.size(), m_generation);
+        }
+        m_job = &job;
+        m_first = first;
+        m_last = last;
+        m_pin = pin;
+        m_pending = last - first;
+        m_generation++;
+    }
+    m_wake.notify_all();
+    if (first == 1) {
+        in_tile_worker() = true;
+        job(0);
+        in_tile_worker() = false;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+}
+
+// Body of pool thread index: wait for a new call, run its block if it has one, report back
+inline void TileWorkerPool::loop(size_t index, size_t generation) {
+    in_tile_worker() = true;
+    bool pinned = false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+        if (m_stop) {
+            return;
+        }
+        generation = m_generation;
+        if (index < m_first || index >= m_last) {
+            continue;
+        }
+        const std::function<void(size_t)> & job = *m_job;
+        const bool pin = m_pin;
+        lock.unlock();
+        if (pin && !pinned) {
+            pinned = pin_current_thread(allowed_cpus()[index % allowed_cpus().size()]);
+        } else if (!pin && pinned) {
+            pinned = !unpin_current_thread();
+        }
+        job(index);
+        lock.lock();
+        if (--m_pending == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+// Call f(tile) once for every tile. Small workloads, and calls made from inside f, run on the calling thread;
+// larger ones are split into one contiguous block of tiles per hardware thread, run by TileWorkerPool.
+// The split only depends on the tile list and the thread count, so a kernel run on a matrix touches each tile
+// from the same worker as the first-touch initialisation did. With worker pinning on, every block runs on a
+// pool thread pinned to its own CPU of the affinity mask and the caller only waits; without it the caller
+// runs block 0 itself. The first exception thrown by f is rethrown on the calling thread after all workers
+// have finished.
+template<typename Tile, typename F>
+void parallel_for_each_tile(const std::vector<Tile> & tiles, F f) {
+    const size_t parallelThreshold = 1 << 16; // Elements below which waking threads costs more than it saves
+    size_t elements = 0;
+    for (const Tile & tile : tiles) {
+        elements += tile.size();
+    }
+    const bool pin = worker_pinning() && !allowed_cpus().empty();
+    size_t workers = std::min<size_t>(pin ? allowed_cpus().size() : std::thread::hardware_concurrency(), tiles.size());
+    if (elements < parallelThreshold || workers <= 1 || in_tile_worker()) {
+        for (const Tile & tile : tiles) {
+            f(tile);
+        }
+        return;
+    }
+
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    std::function<void(size_t)> work = [&](size_t worker) {
+        size_t first = worker * tiles.size() / workers;
+        size_t last = (worker + 1) * tiles.size() / workers;
+        for (size_t i = first; i < last && !failed; i++) {
+            try {
+                f(tiles[i]);
+            } catch (...) {
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+    TileWorkerPool::instance().run(pin ? 0 : 1, workers, pin, work);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 #endif //MATRIX_H
\ No newline at end of file
@@ -0,0 +1,208 @@
+/*
+* Instrumentation counters for Matrix operations
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef MATRIXSTATS_H
+#define MATRIXSTATS_H
+
+// Counting is compiled in only when MATRIX_STATS is defined (e.g. g++ -DMATRIX_STATS ...).
+// Without it the hooks in Matrix.h expand to nothing and matrix_stats() always returns zeroes.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+enum class MatrixOp {
+    Copy,           // Copy construction and copy assignment
+    Multiply,
+    Add,            // Addition and subtraction
+    RowColumnEdit,  // Single and bulk row/column inserts, removals, gathers and scatters
+    Transform,      // apply, map and zip_apply
+    Input,
+    Output,
+    Count           // Number of operation types, not an operation
+};
+
+struct MatrixOpStats {
+    uint64_t calls = 0;
+    uint64_t flops = 0;
+    uint64_t bytes = 0;         // Bytes read and written by the operation
+    uint64_t nanoseconds = 0;   // Wall time
+};
+
+struct MatrixStats {
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    MatrixOpStats ops[static_cast<size_t>(MatrixOp::Count)];
+
+    const MatrixOpStats & operator[](MatrixOp op) const { return ops[static_cast<size_t>(op)]; }
+};
+
+const char * matrix_op_name(MatrixOp op);
+constexpr bool matrix_stats_enabled();
+MatrixStats matrix_stats();
+void reset_matrix_stats();
+void dump_matrix_stats(std::ostream & os);
+
+//
+// Implementations
+//
+
+// Counters shared by all matrices, updated with relaxed atomics so threads never wait on each other
+struct MatrixStatsCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+    std::atomic<uint64_t> calls[static_cast<size_t>(MatrixOp::Count)] = {};
+    std::atomic<uint64_t> flops[static_cast<size_t>(MatrixOp::Count)] = {};
+    std::atomic<uint64_t> bytes[static_cast<size_t>(MatrixOp::Count)] = {};
+    std::atomic<uint64_t> nanoseconds[static_cast<size_t>(MatrixOp::Count)] = {};
+};
+
+inline MatrixStatsCounters & matrix_stats_counters() {
+    static MatrixStatsCounters counters;
+    return counters;
+}
+
+// Name used in dumps
+inline const char * matrix_op_name(MatrixOp op) {
+    switch (op) {
+        case MatrixOp::Copy: return "copy";
+        case MatrixOp::Multiply: return "multiply";
+        case MatrixOp::Add: return "add";
+        case MatrixOp::RowColumnEdit: return "row/column edit";
+        case MatrixOp::Transform: return "transform";
+        case MatrixOp::Input: return "input";
+        case MatrixOp::Output: return "output";
+        default: return "unknown";
+    }
+}
+
+// True if the library was compiled with MATRIX_STATS
+constexpr bool matrix_stats_enabled() {
+#ifdef MATRIX_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Snapshot of all counters
+inline MatrixStats matrix_stats() {
+    MatrixStatsCounters & c = matrix_stats_counters();
+    MatrixStats stats;
+    stats.allocations = c.allocations.load(std::memory_order_relaxed);
+    stats.allocated_bytes = c.allocated_bytes.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < static_cast<size_t>(MatrixOp::Count); i++) {
+        stats.ops[i].calls = c.calls[i].load(std::memory_order_relaxed);
+        stats.ops[i].flops = c.flops[i].load(std::memory_order_relaxed);
+        stats.ops[i].bytes = c.bytes[i].load(std::memory_order_relaxed);
+        stats.ops[i].nanoseconds = c.nanoseconds[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+// Set all counters to 0
+inline void reset_matrix_stats() {
+    MatrixStatsCounters & c = matrix_stats_counters();
+    c.allocations = 0;
+    c.allocated_bytes = 0;
+    for (size_t i = 0; i < static_cast<size_t>(MatrixOp::Count); i++) {
+        c.calls[i] = 0;
+        c.flops[i] = 0;
+        c.bytes[i] = 0;
+        c.nanoseconds[i] = 0;
+    }
+}
+
+// One line per operation type that has been called, plus the allocation totals
+inline void dump_matrix_stats(std::ostream & os) {
+    MatrixStats stats = matrix_stats();
+    os << "matrix allocations: " << stats.allocations << " (" << stats.allocated_bytes << " bytes)" << std::endl;
+    for (size_t i = 0; i < static_cast<size_t>(MatrixOp::Count); i++) {
+        const MatrixOpStats & op = stats.ops[i];
+        if (op.calls == 0) {
+            continue;
+        }
+        os << "matrix " << matrix_op_name(static_cast<MatrixOp>(i)) << ": " << op.calls << " calls, "
+           << op.flops << " flops, " << op.bytes << " bytes, " << op.nanoseconds / 1000 << " us" << std::endl;
+    }
+}
+
+// Record one allocation of the given size
+inline void matrix_stats_allocation(uint64_t bytes) {
+    MatrixStatsCounters & c = matrix_stats_counters();
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Counts one call of an operation and its wall time, from construction to destruction
+class MatrixStatsScope {
+public:
+    MatrixStatsScope(MatrixOp op, uint64_t flops, uint64_t bytes) : m_op(static_cast<size_t>(op)), m_start(std::chrono::steady_clock::now()) {
+        MatrixStatsCounters & c = matrix_stats_counters();
+        c.calls[m_op].fetch_add(1, std::memory_order_relaxed);
+        c.flops[m_op].fetch_add(flops, std::memory_order_relaxed);
+        c.bytes[m_op].fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    ~MatrixStatsScope() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+        matrix_stats_counters().nanoseconds[m_op].fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+
+    MatrixStatsScope(const MatrixStatsScope &) = delete;
+    MatrixStatsScope & operator=(const MatrixStatsScope &) = delete;
+
+private:
+    size_t m_op;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Writes dump_matrix_stats to a stream every interval until destroyed
+class MatrixStatsDumper {
+public:
+    MatrixStatsDumper(std::ostream & os, std::chrono::milliseconds interval) : m_stop(false), m_thread([this, &os, interval]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_wakeup.wait_for(lock, interval, [this]() { return m_stop; })) {
+            dump_matrix_stats(os);
+        }
+    }) {}
+
+    ~MatrixStatsDumper() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_one();
+        m_thread.join();
+    }
+
+    MatrixStatsDumper(const MatrixStatsDumper &) = delete;
+    MatrixStatsDumper & operator=(const MatrixStatsDumper &) = delete;
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    bool m_stop;
+    std::thread m_thread; // Declared last so it starts after the members it uses
+};
+
+// Hooks used inside Matrix.h
+#ifdef MATRIX_STATS
+#define MATRIX_STATS_CONCAT_INNER(a, b) a##b
+#define MATRIX_STATS_CONCAT(a, b) MATRIX_STATS_CONCAT_INNER(a, b)
+#define MATRIX_STATS_SCOPE(op, flops, bytes) MatrixStatsScope MATRIX_STATS_CONCAT(matrixStatsScope, __LINE__)((op), (flops), (bytes))
+#define MATRIX_STATS_ALLOCATION(bytes) matrix_stats_allocation(bytes)
+#else
+#define MATRIX_STATS_SCOPE(op, flops, bytes) ((void)0)
+#define MATRIX_STATS_ALLOCATION(bytes) ((void)0)
+#endif
+
+#endif //MATRIXSTATS_H
@@ -0,0 +1,715 @@
+/*
+* Structured matrices: diagonal, triangular, banded and symmetric
+*
+* Author: Farhan Syed
+* Year: 2024
+*/
+
+#ifndef STRUCTUREDMATRIX_H
+#define STRUCTUREDMATRIX_H
+
+#include "Matrix.h"
+
+#include <vector>
+#include <type_traits>
+
+// Square matrices that only store the elements their structure allows to be non-zero.
+// Every type describes its non-zero pattern per row as a column range [first_col(i), last_col(i)), and
+// stored(i, j) reads an element inside that range without checks. The generic products and sums with a
+// dense Matrix<T> below only visit those ranges, so they cost O(stored elements x other dimension).
+
+enum class Triangle { Upper, Lower };
+
+template <typename T>
+class DiagonalMatrix {
+public:
+    typedef T value_type;
+
+    DiagonalMatrix();
+    explicit DiagonalMatrix(size_t dim);
+    explicit DiagonalMatrix(const std::vector<T> & diagonal);
+    static DiagonalMatrix<T> identity(size_t dim);
+
+    size_t dim() const;
+    T operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, const T & value);
+
+    size_t first_col(size_t row) const;
+    size_t last_col(size_t row) const;
+    const T & stored(size_t row, size_t col) const;
+
+    Matrix<T> to_dense() const;
+    Matrix<T> solve(const Matrix<T> & b) const;
+
+    DiagonalMatrix<T> operator*(const DiagonalMatrix<T> & other) const;
+    DiagonalMatrix<T> operator+(const DiagonalMatrix<T> & other) const;
+
+private:
+    std::vector<T> m_diag;
+};
+
+template <typename T>
+class TriangularMatrix {
+public:
+    typedef T value_type;
+
+    TriangularMatrix();
+    TriangularMatrix(size_t dim, Triangle triangle);
+
+    size_t dim() const;
+    Triangle triangle() const;
+    T operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, const T & value);
+
+    size_t first_col(size_t row) const;
+    size_t last_col(size_t row) const;
+    const T & stored(size_t row, size_t col) const;
+
+    Matrix<T> to_dense() const;
+    Matrix<T> solve(const Matrix<T> & b) const;
+
+private:
+    size_t index(size_t row, size_t col) const;
+
+    size_t m_dim;
+    Triangle m_triangle;
+    std::vector<T> m_vec; // Rows of the triangle packed one after another
+};
+
+template <typename T>
+class BandedMatrix {
+public:
+    typedef T value_type;
+
+    BandedMatrix();
+    BandedMatrix(size_t dim, size_t lower, size_t upper);
+
+    size_t dim() const;
+    size_t lower_bandwidth() const;
+    size_t upper_bandwidth() const;
+    T operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, const T & value);
+
+    size_t first_col(size_t row) const;
+    size_t last_col(size_t row) const;
+    const T & stored(size_t row, size_t col) const;
+
+    Matrix<T> to_dense() const;
+    Matrix<T> solve(const Matrix<T> & b) const;
+
+private:
+    size_t index(size_t row, size_t col) const;
+
+    size_t m_dim;
+    size_t m_lower;
+    size_t m_upper;
+    std::vector<T> m_vec; // dim rows of lower + upper + 1 elements, diagonal at position lower
+};
+
+template <typename T>
+class SymmetricMatrix {
+public:
+    typedef T value_type;
+
+    SymmetricMatrix();
+    explicit SymmetricMatrix(size_t dim);
+
+    size_t dim() const;
+    T operator()(size_t row, size_t col) const;
+    void set(size_t row, size_t col, const T & value);
+
+    size_t first_col(size_t row) const;
+    size_t last_col(size_t row) const;
+    const T & stored(size_t row, size_t col) const;
+
+    Matrix<T> to_dense() const;
+    Matrix<T> solve(const Matrix<T> & b) const;
+
+private:
+    size_t index(size_t row, size_t col) const;
+
+    size_t m_dim;
+    std::vector<T> m_vec; // Lower triangle packed row by row; (i, j) and (j, i) share one element
+};
+
+// Marks the types the generic operators below accept
+template <typename M> struct is_structured_matrix : std::false_type {};
+template <typename T> struct is_structured_matrix<DiagonalMatrix<T>> : std::true_type {};
+template <typename T> struct is_structured_matrix<TriangularMatrix<T>> : std::true_type {};
+template <typename T> struct is_structured_matrix<BandedMatrix<T>> : std::true_type {};
+template <typename T> struct is_structured_matrix<SymmetricMatrix<T>> : std::true_type {};
+
+template <typename S, typename T>
+using enable_if_structured = typename std::enable_if<is_structured_matrix<S>::value && std::is_same<typename S::value_type, T>::value, Matrix<T>>::type;
+
+// Mixed operators with dense matrices
+template<typename S, typename T>
+enable_if_structured<S, T> operator*(const S & lhs, const Matrix<T> & rhs);
+
+template<typename S, typename T>
+enable_if_structured<S, T> operator*(const Matrix<T> & lhs, const S & rhs);
+
+template<typename S, typename T>
+enable_if_structured<S, T> operator+(const S & lhs, const Matrix<T> & rhs);
+
+template<typename S, typename T>
+enable_if_structured<S, T> operator+(const Matrix<T> & lhs, const S & rhs);
+
+template<typename S, typename T>
+enable_if_structured<S, T> operator-(const Matrix<T> & lhs, const S & rhs);
+
+//
+// Implementations
+//
+
+// DIAGONAL
+
+// Empty matrix
+template<typename T>
+DiagonalMatrix<T>::DiagonalMatrix() {}
+
+// Square matrix with default elements on the diagonal
+template<typename T>
+DiagonalMatrix<T>::DiagonalMatrix(size_t dim) : m_diag(dim, T()) {}
+
+// Matrix with the given diagonal
+template<typename T>
+DiagonalMatrix<T>::DiagonalMatrix(const std::vector<T> & diagonal) : m_diag(diagonal) {}
+
+// Identity matrix, storing only the dim ones
+template<typename T>
+DiagonalMatrix<T> DiagonalMatrix<T>::identity(size_t dim) {
+    return DiagonalMatrix<T>(std::vector<T>(dim, T(1)));
+}
+
+template<typename T>
+size_t DiagonalMatrix<T>::dim() const {
+    return m_diag.size();
+}
+
+// Read any element, elements off the diagonal are 0
+template<typename T>
+T DiagonalMatrix<T>::operator()(size_t row, size_t col) const {
+    if (row < dim() && col < dim()) {
+        return (row == col) ? m_diag[row] : T();
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Write an element on the diagonal
+template<typename T>
+void DiagonalMatrix<T>::set(size_t row, size_t col, const T & value) {
+    if (row < dim() && row == col) {
+        m_diag[row] = value;
+        return;
+    }
+    throw std::out_of_range("Element is not stored!");
+}
+
+template<typename T>
+size_t DiagonalMatrix<T>::first_col(size_t row) const {
+    return row;
+}
+
+template<typename T>
+size_t DiagonalMatrix<T>::last_col(size_t row) const {
+    return row + 1;
+}
+
+template<typename T>
+const T & DiagonalMatrix<T>::stored(size_t row, size_t) const {
+    return m_diag[row];
+}
+
+// Dense copy
+template<typename T>
+Matrix<T> DiagonalMatrix<T>::to_dense() const {
+    Matrix<T> result(dim());
+    for (size_t i = 0; i < dim(); i++) {
+        result(i, i) = m_diag[i];
+    }
+    return result;
+}
+
+// Solve D X = B by dividing each row of B, O(n x columns of B)
+template<typename T>
+Matrix<T> DiagonalMatrix<T>::solve(const Matrix<T> & b) const {
+    if (b.rows() != dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> x(b);
+    for (size_t i = 0; i < dim(); i++) {
+        if (m_diag[i] == T()) {
+            throw std::out_of_range("Matrix is singular!");
+        }
+        for (T & elem : x.row(i)) {
+            elem = elem / m_diag[i];
+        }
+    }
+    return x;
+}
+
+// Product of two diagonal matrices, O(n)
+template<typename T>
+DiagonalMatrix<T> DiagonalMatrix<T>::operator*(const DiagonalMatrix<T> & other) const {
+    if (dim() != other.dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    DiagonalMatrix<T> result(dim());
+    for (size_t i = 0; i < dim(); i++) {
+        result.m_diag[i] = m_diag[i] * other.m_diag[i];
+    }
+    return result;
+}
+
+// Sum of two diagonal matrices, O(n)
+template<typename T>
+DiagonalMatrix<T> DiagonalMatrix<T>::operator+(const DiagonalMatrix<T> & other) const {
+    if (dim() != other.dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    DiagonalMatrix<T> result(dim());
+    for (size_t i = 0; i < dim(); i++) {
+        result.m_diag[i] = m_diag[i] + other.m_diag[i];
+    }
+    return result;
+}
+
+// TRIANGULAR
+
+// Empty matrix
+template<typename T>
+TriangularMatrix<T>::TriangularMatrix() : m_dim(0), m_triangle(Triangle::Upper) {}
+
+// Square triangular matrix with default elements
+template<typename T>
+TriangularMatrix<T>::TriangularMatrix(size_t dim, Triangle triangle) : m_dim(dim), m_triangle(triangle), m_vec(dim * (dim + 1) / 2, T()) {}
+
+template<typename T>
+size_t TriangularMatrix<T>::dim() const {
+    return m_dim;
+}
+
+template<typename T>
+Triangle TriangularMatrix<T>::triangle() const {
+    return m_triangle;
+}
+
+// Position of a stored element. Upper rows hold columns row..dim-1, lower rows hold columns 0..row.
+template<typename T>
+size_t TriangularMatrix<T>::index(size_t row, size_t col) const {
+    if (m_triangle == Triangle::Upper) {
+        return row * m_dim - row * (row - 1) / 2 + (col - row);
+    }
+    return row * (row + 1) / 2 + col;
+}
+
+// Read any element, elements outside the triangle are 0
+template<typename T>
+T TriangularMatrix<T>::operator()(size_t row, size_t col) const {
+    if (row < m_dim && col < m_dim) {
+        return (col >= first_col(row) && col < last_col(row)) ? m_vec[index(row, col)] : T();
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Write an element inside the triangle
+template<typename T>
+void TriangularMatrix<T>::set(size_t row, size_t col, const T & value) {
+    if (row < m_dim && col >= first_col(row) && col < last_col(row)) {
+        m_vec[index(row, col)] = value;
+        return;
+    }
+    throw std::out_of_range("Element is not stored!");
+}
+
+template<typename T>
+size_t TriangularMatrix<T>::first_col(size_t row) const {
+    return (m_triangle == Triangle::Upper) ? row : 0;
+}
+
+template<typename T>
+size_t TriangularMatrix<T>::last_col(size_t row) const {
+    return (m_triangle == Triangle::Upper) ? m_dim : row + 1;
+}
+
+template<typename T>
+const T & TriangularMatrix<T>::stored(size_t row, size_t col) const {
+    return m_vec[index(row, col)];
+}
+
+// Dense copy
+template<typename T>
+Matrix<T> TriangularMatrix<T>::to_dense() const {
+    Matrix<T> result(m_dim);
+    for (size_t i = 0; i < m_dim; i++) {
+        for (size_t j = first_col(i); j < last_col(i); j++) {
+            result(i, j) = stored(i, j);
+        }
+    }
+    return result;
+}
+
+// Solve A X = B by forward (lower) or back (upper) substitution, O(n^2 x columns of B)
+template<typename T>
+Matrix<T> TriangularMatrix<T>::solve(const Matrix<T> & b) const {
+    if (b.rows() != m_dim) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> x(b);
+    for (size_t step = 0; step < m_dim; step++) {
+        size_t i = (m_triangle == Triangle::Lower) ? step : m_dim - 1 - step;
+        const T & pivot = stored(i, i);
+        if (pivot == T()) {
+            throw std::out_of_range("Matrix is singular!");
+        }
+        MatrixRange<T*> xi = x.row(i);
+        for (size_t k = first_col(i); k < last_col(i); k++) { // Subtract the already solved rows
+            if (k == i) {
+                continue;
+            }
+            const T aik = stored(i, k);
+            MatrixRange<T*> xk = x.row(k);
+            for (size_t j = 0; j < x.cols(); j++) {
+                xi[j] -= aik * xk[j];
+            }
+        }
+        for (T & elem : xi) {
+            elem = elem / pivot;
+        }
+    }
+    return x;
+}
+
+// BANDED
+
+// Empty matrix
+template<typename T>
+BandedMatrix<T>::BandedMatrix() : m_dim(0), m_lower(0), m_upper(0) {}
+
+// Square matrix with lower sub-diagonals and upper super-diagonals, default elements
+template<typename T>
+BandedMatrix<T>::BandedMatrix(size_t dim, size_t lower, size_t upper) : m_dim(dim), m_lower(lower), m_upper(upper), m_vec(dim * (lower + upper + 1), T()) {}
+
+template<typename T>
+size_t BandedMatrix<T>::dim() const {
+    return m_dim;
+}
+
+template<typename T>
+size_t BandedMatrix<T>::lower_bandwidth() const {
+    return m_lower;
+}
+
+template<typename T>
+size_t BandedMatrix<T>::upper_bandwidth() const {
+    return m_upper;
+}
+
+// Position of a stored element
+template<typename T>
+size_t BandedMatrix<T>::index(size_t row, size_t col) const {
+    return row * (m_lower + m_upper + 1) + (col + m_lower - row);
+}
+
+// Read any element, elements outside the band are 0
+template<typename T>
+T BandedMatrix<T>::operator()(size_t row, size_t col) const {
+    if (row < m_dim && col < m_dim) {
+        return (col >= first_col(row) && col < last_col(row)) ? m_vec[index(row, col)] : T();
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Write an element inside the band
+template<typename T>
+void BandedMatrix<T>::set(size_t row, size_t col, const T & value) {
+    if (row < m_dim && col >= first_col(row) && col < last_col(row)) {
+        m_vec[index(row, col)] = value;
+        return;
+    }
+    throw std::out_of_range("Element is not stored!");
+}
+
+template<typename T>
+size_t BandedMatrix<T>::first_col(size_t row) const {
+    return (row > m_lower) ? row - m_lower : 0;
+}
+
+template<typename T>
+size_t BandedMatrix<T>::last_col(size_t row) const {
+    return std::min(row + m_upper + 1, m_dim);
+}
+
+template<typename T>
+const T & BandedMatrix<T>::stored(size_t row, size_t col) const {
+    return m_vec[index(row, col)];
+}
+
+// Dense copy
+template<typename T>
+Matrix<T> BandedMatrix<T>::to_dense() const {
+    Matrix<T> result(m_dim);
+    for (size_t i = 0; i < m_dim; i++) {
+        for (size_t j = first_col(i); j < last_col(i); j++) {
+            result(i, j) = stored(i, j);
+        }
+    }
+    return result;
+}
+
+// Solve A X = B by Gaussian elimination inside the band, O(n x lower x (upper + columns of B)).
+// There is no pivoting, so fill-in stays inside the band; the matrix should be diagonally dominant
+// or otherwise have non-zero pivots.
+template<typename T>
+Matrix<T> BandedMatrix<T>::solve(const Matrix<T> & b) const {
+    if (b.rows() != m_dim) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    BandedMatrix<T> lu(*this);
+    Matrix<T> x(b);
+
+    // Forward elimination
+    for (size_t k = 0; k < m_dim; k++) {
+        const T pivot = lu.stored(k, k);
+        if (pivot == T()) {
+            throw std::out_of_range("Matrix is singular!");
+        }
+        size_t lastRow = std::min(k + m_lower + 1, m_dim);
+        for (size_t i = k + 1; i < lastRow; i++) {
+            const T factor = lu.stored(i, k) / pivot;
+            for (size_t j = k; j < lu.last_col(k); j++) {
+                lu.m_vec[lu.index(i, j)] -= factor * lu.stored(k, j);
+            }
+            MatrixRange<T*> xi = x.row(i);
+            MatrixRange<T*> xk = x.row(k);
+            for (size_t j = 0; j < x.cols(); j++) {
+                xi[j] -= factor * xk[j];
+            }
+        }
+    }
+
+    // Back substitution on the remaining upper band
+    for (size_t step = 0; step < m_dim; step++) {
+        size_t i = m_dim - 1 - step;
+        MatrixRange<T*> xi = x.row(i);
+        for (size_t k = i + 1; k < lu.last_col(i); k++) {
+            const T aik = lu.stored(i, k);
+            MatrixRange<T*> xk = x.row(k);
+            for (size_t j = 0; j < x.cols(); j++) {
+                xi[j] -= aik * xk[j];
+            }
+        }
+        const T pivot = lu.stored(i, i);
+        for (T & elem : xi) {
+            elem = elem / pivot;
+        }
+    }
+    return x;
+}
+
+// SYMMETRIC
+
+// Empty matrix
+template<typename T>
+SymmetricMatrix<T>::SymmetricMatrix() : m_dim(0) {}
+
+// Square symmetric matrix with default elements
+template<typename T>
+SymmetricMatrix<T>::SymmetricMatrix(size_t dim) : m_dim(dim), m_vec(dim * (dim + 1) / 2, T()) {}
+
+template<typename T>
+size_t SymmetricMatrix<T>::dim() const {
+    return m_dim;
+}
+
+// Position of an element in the packed lower triangle
+template<typename T>
+size_t SymmetricMatrix<T>::index(size_t row, size_t col) const {
+    if (col > row) {
+        std::swap(row, col);
+    }
+    return row * (row + 1) / 2 + col;
+}
+
+// Read any element
+template<typename T>
+T SymmetricMatrix<T>::operator()(size_t row, size_t col) const {
+    if (row < m_dim && col < m_dim) {
+        return m_vec[index(row, col)];
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+// Write an element, which also sets its mirror
+template<typename T>
+void SymmetricMatrix<T>::set(size_t row, size_t col, const T & value) {
+    if (row < m_dim && col < m_dim) {
+        m_vec[index(row, col)] = value;
+        return;
+    }
+    throw std::out_of_range("Wrong dimensions!");
+}
+
+template<typename T>
+size_t SymmetricMatrix<T>::first_col(size_t) const {
+    return 0;
+}
+
+template<typename T>
+size_t SymmetricMatrix<T>::last_col(size_t) const {
+    return m_dim;
+}
+
+template<typename T>
+const T & SymmetricMatrix<T>::stored(size_t row, size_t col) const {
+    return m_vec[index(row, col)];
+}
+
+// Dense copy
+template<typename T>
+Matrix<T> SymmetricMatrix<T>::to_dense() const {
+    Matrix<T> result(m_dim);
+    for (size_t i = 0; i < m_dim; i++) {
+        for (size_t j = 0; j < m_dim; j++) {
+            result(i, j) = stored(i, j);
+        }
+    }
+    return result;
+}
+
+// Solve A X = B with an LDL^T factorisation in packed storage, O(n^3 / 6 + n^2 x columns of B).
+// There is no pivoting, so every leading minor must be non-singular (e.g. positive definite matrices).
+template<typename T>
+Matrix<T> SymmetricMatrix<T>::solve(const Matrix<T> & b) const {
+    if (b.rows() != m_dim) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    // Factor: L is unit lower triangular, stored below the diagonal; D is stored on the diagonal
+    SymmetricMatrix<T> ldl(*this);
+    for (size_t j = 0; j < m_dim; j++) {
+        T d = ldl.stored(j, j);
+        for (size_t k = 0; k < j; k++) {
+            d -= ldl.stored(j, k) * ldl.stored(j, k) * ldl.stored(k, k);
+        }
+        if (d == T()) {
+            throw std::out_of_range("Matrix is singular!");
+        }
+        ldl.m_vec[ldl.index(j, j)] = d;
+        for (size_t i = j + 1; i < m_dim; i++) {
+            T l = ldl.stored(i, j);
+            for (size_t k = 0; k < j; k++) {
+                l -= ldl.stored(i, k) * ldl.stored(j, k) * ldl.stored(k, k);
+            }
+            ldl.m_vec[ldl.index(i, j)] = l / d;
+        }
+    }
+
+    Matrix<T> x(b);
+    for (size_t i = 0; i < m_dim; i++) {         // L y = b
+        MatrixRange<T*> xi = x.row(i);
+        for (size_t k = 0; k < i; k++) {
+            const T lik = ldl.stored(i, k);
+            MatrixRange<T*> xk = x.row(k);
+            for (size_t j = 0; j < x.cols(); j++) {
+                xi[j] -= lik * xk[j];
+            }
+        }
+    }
+    for (size_t i = 0; i < m_dim; i++) {         // D z = y
+        for (T & elem : x.row(i)) {
+            elem = elem / ldl.stored(i, i);
+        }
+    }
+    for (size_t step = 0; step < m_dim; step++) { // L^T x = z
+        size_t i = m_dim - 1 - step;
+        MatrixRange<T*> xi = x.row(i);
+        for (size_t k = i + 1; k < m_dim; k++) {
+            const T lki = ldl.stored(k, i);
+            MatrixRange<T*> xk = x.row(k);
+            for (size_t j = 0; j < x.cols(); j++) {
+                xi[j] -= lki * xk[j];
+            }
+        }
+    }
+    return x;
+}
+
+// MIXED OPERATORS
+
+// Structured * dense: row i of the result only combines the rows of rhs inside row i's column range
+template<typename S, typename T>
+enable_if_structured<S, T> operator*(const S & lhs, const Matrix<T> & rhs) {
+    if (lhs.dim() != rhs.rows()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(lhs.dim(), rhs.cols());
+    for (size_t i = 0; i < lhs.dim(); i++) {
+        MatrixRange<T*> out = result.row(i);
+        for (size_t k = lhs.first_col(i); k < lhs.last_col(i); k++) {
+            const T aik = lhs.stored(i, k);
+            MatrixRange<const T*> in = rhs.row(k);
+            for (size_t j = 0; j < rhs.cols(); j++) {
+                out[j] += aik * in[j];
+            }
+        }
+    }
+    return result;
+}
+
+// Dense * structured: element (i, k) of lhs scales the stored part of row k of rhs
+template<typename S, typename T>
+enable_if_structured<S, T> operator*(const Matrix<T> & lhs, const S & rhs) {
+    if (lhs.cols() != rhs.dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(lhs.rows(), rhs.dim());
+    for (size_t i = 0; i < lhs.rows(); i++) {
+        MatrixRange<T*> out = result.row(i);
+        for (size_t k = 0; k < rhs.dim(); k++) {
+            const T lik = lhs(i, k);
+            for (size_t j = rhs.first_col(k); j < rhs.last_col(k); j++) {
+                out[j] += lik * rhs.stored(k, j);
+            }
+        }
+    }
+    return result;
+}
+
+// Structured + dense: copy the dense matrix and add the stored elements
+template<typename S, typename T>
+enable_if_structured<S, T> operator+(const S & lhs, const Matrix<T> & rhs) {
+    return rhs + lhs;
+}
+
+// Dense + structured
+template<typename S, typename T>
+enable_if_structured<S, T> operator+(const Matrix<T> & lhs, const S & rhs) {
+    if (lhs.rows() != rhs.dim() || lhs.cols() != rhs.dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(lhs);
+    for (size_t i = 0; i < rhs.dim(); i++) {
+        for (size_t j = rhs.first_col(i); j < rhs.last_col(i); j++) {
+            result(i, j) += rhs.stored(i, j);
+        }
+    }
+    return result;
+}
+
+// Dense - structured
+template<typename S, typename T>
+enable_if_structured<S, T> operator-(const Matrix<T> & lhs, const S & rhs) {
+    if (lhs.rows() != rhs.dim() || lhs.cols() != rhs.dim()) {
+        throw std::out_of_range("Wrong dimensions!");
+    }
+    Matrix<T> result(lhs);
+    for (size_t i = 0; i < rhs.dim(); i++) {
+        for (size_t j = rhs.first_col(i); j < rhs.last_col(i); j++) {
+            result(i, j) -= rhs.stored(i, j);
+        }
+    }
+    return result;
+}
+
+#endif //STRUCTUREDMATRIX_H
@@ -0,0 +1,293 @@
+// To compile: g++ -O3 -march=native -o benchmark benchmark.cpp -pthread
+// Usage: ./benchmark [elements for the element-wise tests, default 100000000]
+// NUMA: on a multi-socket host, compare e.g. `numactl --cpunodebind=0 --membind=1 ./benchmark` (all memory remote)
+//       with a plain run. On a single-node machine the placement test shows the page-fault cost only.
+// Stats: add -DMATRIX_STATS to print the Matrix operation counters at the end (and compare timings to see the overhead).
+
+#include "Matrix.h"
+#include "ComplexMatrix.h"
+#include "CowMatrix.h"
+#include "StructuredMatrix.h"
+#include "Convolution.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <fstream>
+
+using namespace std;
+
+// Run f once and return the elapsed time in milliseconds
+template<typename F>
+double time_ms(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(stop - start).count();
+}
+
+Matrix<Complex> randomComplexMatrix(size_t rows, size_t cols, default_random_engine & rng) {
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    Matrix<Complex> m(rows, cols);
+    for (Complex & c : m) {
+        c = Complex(dist(rng), dist(rng));
+    }
+    return m;
+}
+
+// Interleaved Complex elements through the generic kernel vs split planes with 3M and 4M
+void complexGemmTest() {
+    cout << "Complex matrix product" << endl;
+    default_random_engine rng(020416);
+
+    for (size_t n : {128, 256, 512}) {
+        Matrix<Complex> a = randomComplexMatrix(n, n, rng);
+        Matrix<Complex> b = randomComplexMatrix(n, n, rng);
+        Matrix<Complex> generic(n, n);
+        ComplexMatrix ca(a);
+        ComplexMatrix cb(b);
+        ComplexMatrix result;
+
+        double genericMs = time_ms([&] { gemm_kernel(a.data(), b.data(), generic.data(), n, n, n); });
+        double fourMs = time_ms([&] { result = ca.multiply(cb, ComplexMatrix::Algorithm::FourM); });
+        double threeMs = time_ms([&] { result = ca.multiply(cb, ComplexMatrix::Algorithm::ThreeM); });
+
+        cout << fixed << setprecision(1);
+        cout << "n = " << n << ": generic " << genericMs << " ms, 4M " << fourMs << " ms, 3M " << threeMs << " ms" << endl;
+    }
+}
+
+// Raw serial loop over begin()/end() vs apply, map and zip_apply
+void elementwiseTest(size_t elements) {
+    cout << "Element-wise transforms on " << elements << " doubles" << endl;
+    size_t cols = 10000;
+    Matrix<double> m(elements / cols, cols);
+    Matrix<double> other(elements / cols, cols);
+    double x = 0;
+    for (double & elem : m) {
+        elem = (x += 1e-7);
+    }
+
+    auto sigmoid = [](double v) { return 1.0 / (1.0 + std::exp(-v)); };
+    auto clamp = [](double v) { return std::min(std::max(v, 0.25), 0.75); };
+
+    double rawMs = time_ms([&] {
+        for (Matrix<double>::iterator it = m.begin(); it != m.end(); ++it) {
+            *it = sigmoid(*it);
+        }
+    });
+    double applyMs = time_ms([&] { m.apply(sigmoid); });
+    double clampMs = time_ms([&] { m.apply(clamp); });
+    double mapMs = time_ms([&] { other = m.map([](double v) { return std::exp(v); }); });
+    double zipMs = time_ms([&] { m.zip_apply(other, [](double a, double b) { return a * b; }); });
+
+    cout << fixed << setprecision(1);
+    cout << "raw loop sigmoid " << rawMs << " ms, apply sigmoid " << applyMs << " ms, apply clamp " << clampMs
+         << " ms, map exp " << mapMs << " ms, zip_apply multiply " << zipMs << " ms (" << thread::hardware_concurrency()
+         << " hardware threads)" << endl;
+}
+
+// Number of NUMA nodes reported by Linux, 1 if unknown
+size_t numaNodes() {
+    size_t nodes = 0;
+    while (ifstream("/sys/devices/system/node/node" + to_string(nodes) + "/cpulist")) {
+        nodes++;
+    }
+    return max<size_t>(nodes, 1);
+}
+
+// Serial fill vs first-touch fill, followed by the same streaming kernel on each matrix
+void placementTest(size_t elements) {
+    cout << "Placement on " << elements << " doubles, " << numaNodes() << " NUMA node(s)" << endl;
+    size_t cols = 10000;
+    auto stream = [](double v) { return v * 1.000001 + 1.0; };
+
+    for (bool pin : {false, true}) {
+        set_worker_pinning(pin);
+        Matrix<double> serial;
+        Matrix<double> firstTouch;
+        double serialAllocMs = time_ms([&] { serial = Matrix<double>(elements / cols, cols, Placement::Serial); });
+        double firstTouchAllocMs = time_ms([&] { firstTouch = Matrix<double>(elements / cols, cols, Placement::FirstTouch); });
+        double serialKernelMs = time_ms([&] { serial.apply(stream); });
+        double firstTouchKernelMs = time_ms([&] { firstTouch.apply(stream); });
+
+        double gigabytes = 2.0 * elements * sizeof(double) / 1e9; // One read and one write per element
+        cout << fixed << setprecision(1);
+        cout << (pin ? "pinned:   " : "unpinned: ")
+             << "serial fill " << serialAllocMs << " ms, kernel " << gigabytes / (serialKernelMs / 1000) << " GB/s | "
+             << "first-touch fill " << firstTouchAllocMs << " ms, kernel " << gigabytes / (firstTouchKernelMs / 1000) << " GB/s" << endl;
+    }
+    set_worker_pinning(false);
+}
+
+// Take many read-only snapshots of a matrix that is occasionally changed, with deep copies vs copy-on-write
+template<typename M>
+double snapshotWorkload(M & live, size_t snapshots, size_t writeEvery) {
+    vector<M> history;
+    history.reserve(snapshots);
+    double checksum = 0;
+    for (size_t i = 0; i < snapshots; i++) {
+        history.push_back(live);
+        const M & snapshot = history.back();
+        checksum += snapshot(i % snapshot.rows(), 0);
+        if (i % writeEvery == 0) {
+            live(0, 0) += 1;
+        }
+        if (history.size() > 64) {
+            history.erase(history.begin());
+        }
+    }
+    return checksum;
+}
+
+void snapshotTest() {
+    cout << "Snapshots of a 1000 x 1000 matrix, one write per 100 snapshots" << endl;
+    size_t snapshots = 2000;
+    Matrix<double> deep(1000, 1000);
+    CowMatrix<double> shared(1000, 1000);
+    double deepMs = time_ms([&] { snapshotWorkload(deep, snapshots, 100); });
+    double cowMs = time_ms([&] { snapshotWorkload(shared, snapshots, 100); });
+
+    cout << fixed << setprecision(1);
+    cout << "Matrix deep copies " << deepMs << " ms, CowMatrix " << cowMs << " ms" << endl;
+}
+
+// Identity and tridiagonal operators as dense matrices vs structured storage
+void structuredTest() {
+    cout << "Structured operators on a 1000 x 1000 matrix" << endl;
+    size_t n = 1000;
+    Matrix<double> x(n, n);
+    x.apply([](double) { return 1.5; });
+
+    Matrix<double> denseIdentity = identity<double>(n);
+    DiagonalMatrix<double> diagonalIdentity = DiagonalMatrix<double>::identity(n);
+    BandedMatrix<double> tridiagonal(n, 1, 1);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = tridiagonal.first_col(i); j < tridiagonal.last_col(i); j++) {
+            tridiagonal.set(i, j, (i == j) ? 2.0 : -1.0);
+        }
+    }
+    Matrix<double> denseTridiagonal = tridiagonal.to_dense();
+    Matrix<double> result;
+
+    double denseIdMs = time_ms([&] { result = denseIdentity * x; });
+    double diagIdMs = time_ms([&] { result = diagonalIdentity * x; });
+    double denseTriMs = time_ms([&] { result = denseTridiagonal * x; });
+    double bandTriMs = time_ms([&] { result = tridiagonal * x; });
+    double bandSolveMs = time_ms([&] { result = tridiagonal.solve(x); });
+
+    cout << fixed << setprecision(1);
+    cout << "identity: dense " << denseIdMs << " ms, diagonal " << diagIdMs << " ms | tridiagonal: dense "
+         << denseTriMs << " ms, banded " << bandTriMs << " ms, banded solve " << bandSolveMs << " ms" << endl;
+}
+
+// Direct vs im2col correlation of a 1024 x 1024 float image with banks of kernels of several sizes
+void convolutionTest() {
+    cout << "2D correlation of a 1024 x 1024 float image with a bank of kernels, same padding" << endl;
+    Matrix<float> image(1024, 1024);
+    float value = 0;
+    image.apply([&value](float) { return value += 0.001f; });
+
+    for (size_t k : {3, 5, 9}) {
+        for (size_t filters : {1, 2, 4, 8, 16}) {
+            vector<Matrix<float>> kernels;
+            for (size_t f = 0; f < filters; f++) {
+                kernels.emplace_back(k, k);
+                kernels.back().apply([k, f](float) { return (f + 1.0f) / (k * k); });
+            }
+            ConvolutionOptions options;
+            options.padding = Padding::Same;
+            vector<Matrix<float>> result;
+
+            options.method = ConvolutionMethod::Direct;
+            double directMs = time_ms([&] { result = correlate2d(image, kernels, options); });
+            options.method = ConvolutionMethod::Im2col;
+            double im2colMs = time_ms([&] { result = correlate2d(image, kernels, options); });
+
+            cout << fixed << setprecision(1);
+            cout << k << " x " << k << ", " << filters << " filter(s): direct " << directMs << " ms, im2col " << im2colMs << " ms" << endl;
+        }
+    }
+}
+
+// Removing 1000 rows one at a time vs one bulk call
+void spliceTest() {
+    cout << "Removing 1000 of 5000 rows from a 5000 x 200 matrix" << endl;
+    Matrix<double> one(5000, 200);
+    Matrix<double> bulk(5000, 200);
+    vector<size_t> rows;
+    for (size_t i = 0; i < 1000; i++) {
+        rows.push_back(i * 5);
+    }
+
+    double oneMs = time_ms([&] {
+        for (size_t i = rows.size(); i-- > 0;) { // From the bottom, so earlier indices stay valid
+            one.remove_row(rows[i]);
+        }
+    });
+    double bulkMs = time_ms([&] { bulk.remove_rows(rows); });
+    for (size_t & row : rows) {
+        row = row * 4 / 5; // Still 1000 rows, all inside the remaining 4000
+    }
+    double gatherMs = time_ms([&] { bulk = bulk.gather_rows(rows); });
+
+    cout << fixed << setprecision(1);
+    cout << "remove_row x 1000 " << oneMs << " ms, remove_rows " << bulkMs << " ms, gather_rows " << gatherMs << " ms" << endl;
+}
+
+// Float product with float vs double accumulation: time and error against a long double reference
+void mixedPrecisionTest() {
+    cout << "Float 256 x 65536 x 256 product" << endl;
+    default_random_engine rng(020416);
+    uniform_real_distribution<float> dist(0.0f, 1.0f);
+    Matrix<float> a(256, 65536);
+    Matrix<float> b(65536, 256);
+    for (float & x : a) {
+        x = dist(rng);
+    }
+    for (float & x : b) {
+        x = dist(rng);
+    }
+
+    Matrix<float> narrow;
+    Matrix<double> wide;
+    double narrowMs = time_ms([&] { narrow = a * b; });
+    double wideMs = time_ms([&] { wide = multiply<double>(a, b); });
+
+    long double reference = 0;
+    for (size_t k = 0; k < a.cols(); k++) {
+        reference += static_cast<long double>(a(0, k)) * b(k, 0);
+    }
+    cout << fixed << setprecision(1);
+    cout << "float accumulator " << narrowMs << " ms, double accumulator " << wideMs << " ms" << endl;
+    cout << scientific << setprecision(2);
+    cout << "relative error of element (0, 0): float " << fabs((narrow(0, 0) - reference) / reference)
+         << ", double " << fabs((static_cast<float>(wide(0, 0)) - reference) / reference) << endl;
+}
+
+int main(int argc, char **argv) {
+    size_t elements = (argc > 1) ? stoull(argv[1]) : 100000000;
+
+    complexGemmTest();
+    cout << "\n";
+    elementwiseTest(elements);
+    cout << "\n";
+    placementTest(elements);
+    cout << "\n";
+    snapshotTest();
+    cout << "\n";
+    structuredTest();
+    cout << "\n";
+    convolutionTest();
+    cout << "\n";
+    spliceTest();
+    cout << "\n";
+    mixedPrecisionTest();
+
+    if (matrix_stats_enabled()) {
+        cout << "\n";
+        dump_matrix_stats(cout);
+    }
+}
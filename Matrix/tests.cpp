@@ -1,5 +1,10 @@
 #include "Matrix.h"
+#include "ComplexMatrix.h"
+#include "CowMatrix.h"
+#include "StructuredMatrix.h"
+#include "Convolution.h"
 #include <gtest/gtest.h>
+#include <numeric>
 
 // To compile: g++ -o tests tests.cpp Matrix.h -lgtest -lgtest_main -pthread
 // Running valgrind: valgrind --leak-check=full --show-leak-kinds=all ./tests
@@ -352,6 +357,718 @@ TEST(Identity, IdentityIsCorrect) {
     EXPECT_EQ(1, m(1,1));
 }
 
+// Const iterators - Iterate over a const matrix
+TEST(Iterators, ConstIteratorsCoverAllElements) {
+    const Matrix<int> m({1,2,3,4});
+    EXPECT_EQ(10, std::accumulate(m.begin(), m.end(), 0));
+    EXPECT_EQ(4, m.cend() - m.cbegin());
+}
+
+// Row range - Contains the elements of one row
+TEST(Iterators, RowRangeIsCorrect) {
+    Matrix<int> m({1,2,3,4,5,6,7,8,9});
+    auto r = m.row(1);
+    EXPECT_EQ(3, r.size());
+    EXPECT_EQ(15, std::accumulate(r.begin(), r.end(), 0));
+
+    for (int & x : m.row(2)) {
+        x = 0;
+    }
+    EXPECT_EQ(0, m(2,0));
+    EXPECT_EQ(0, m(2,2));
+    EXPECT_THROW(m.row(3), std::out_of_range);
+}
+
+// Column range - Strided iterator walks down one column
+TEST(Iterators, ColumnRangeIsCorrect) {
+    Matrix<int> m({1,2,3,4,5,6,7,8,9});
+    auto c = m.column(1);
+    EXPECT_EQ(3, c.size());
+    EXPECT_EQ(15, std::accumulate(c.begin(), c.end(), 0));
+    EXPECT_EQ(8, c[2]);
+
+    std::fill(c.begin(), c.end(), -1);
+    EXPECT_EQ(-1, m(0,1));
+    EXPECT_EQ(-1, m(2,1));
+    EXPECT_EQ(1, m(0,0));
+
+    const Matrix<int> & cm = m;
+    std::vector<int> col(cm.column(2).begin(), cm.column(2).end());
+    EXPECT_EQ(std::vector<int>({3,6,9}), col);
+    std::vector<int> reversed(std::make_reverse_iterator(cm.column(2).end()), std::make_reverse_iterator(cm.column(2).begin()));
+    EXPECT_EQ(std::vector<int>({9,6,3}), reversed);
+    EXPECT_THROW(m.column(3), std::out_of_range);
+}
+
+// Tiles - Cover every row exactly once
+TEST(Iterators, TilesCoverMatrix) {
+    Matrix<int> m(10, 3);
+    auto tiles = m.tiles(4);
+    EXPECT_EQ(3, tiles.size());
+    EXPECT_EQ(2, tiles[2].rows());
+
+    std::for_each(tiles.begin(), tiles.end(), [](const MatrixTile<int> & tile) {
+        for (size_t r = 0; r < tile.rows(); r++) {
+            for (int & x : tile.row(r)) {
+                x = tile.first_row + r;
+            }
+        }
+    });
+    for (size_t i = 0; i < m.rows(); i++) {
+        EXPECT_EQ(i, m(i,2));
+    }
+
+    const Matrix<int> & cm = m;
+    size_t total = 0;
+    for (const auto & tile : cm.tiles()) {
+        total += tile.size();
+    }
+    EXPECT_EQ(30, total);
+}
+
+// Complex matrix product - 3M and 4M agree with the element-wise product
+TEST(ComplexMatrixOperators, MultiplicationIsCorrect) {
+    Matrix<Complex> a(3, 2);
+    Matrix<Complex> b(2, 4);
+    for (size_t i = 0; i < a.rows(); i++) {
+        for (size_t j = 0; j < a.cols(); j++) {
+            a(i, j) = Complex(i + 1.0, j - 1.0);
+        }
+    }
+    for (size_t i = 0; i < b.rows(); i++) {
+        for (size_t j = 0; j < b.cols(); j++) {
+            b(i, j) = Complex(j * 0.5, i + 2.0);
+        }
+    }
+
+    Matrix<Complex> expected(3, 4);
+    gemm_kernel(a.data(), b.data(), expected.data(), 3, 2, 4);
+
+    ComplexMatrix ca(a);
+    ComplexMatrix cb(b);
+    ComplexMatrix threeM = ca.multiply(cb, ComplexMatrix::Algorithm::ThreeM);
+    ComplexMatrix fourM = ca.multiply(cb, ComplexMatrix::Algorithm::FourM);
+    Matrix<Complex> product = a * b;
+
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            EXPECT_NEAR(expected(i, j).real(), threeM(i, j).real(), 1e-12);
+            EXPECT_NEAR(expected(i, j).imag(), threeM(i, j).imag(), 1e-12);
+            EXPECT_EQ(expected(i, j), fourM(i, j));
+            EXPECT_NEAR(expected(i, j).real(), product(i, j).real(), 1e-12);
+            EXPECT_NEAR(expected(i, j).imag(), product(i, j).imag(), 1e-12);
+        }
+    }
+    EXPECT_TRUE(is_split_complex<Complex>::value);
+    EXPECT_FALSE(is_split_complex<double>::value);
+    EXPECT_FALSE(is_split_complex<ComplexF>::value);
+    EXPECT_THROW(b * a, std::out_of_range);
+    EXPECT_THROW(cb * ca.multiply(cb), std::out_of_range);
+}
+
+// Complex matrix - Split and merge keep the elements
+TEST(ComplexMatrixAccessors, SplitAndMergeAreConsistent) {
+    Matrix<Complex> m(2, 2);
+    m(0, 1) = Complex(1.5, -2.5);
+    ComplexMatrix cm(m);
+    EXPECT_EQ(1.5, cm.real()(0, 1));
+    EXPECT_EQ(-2.5, cm.imag()(0, 1));
+
+    cm.set(1, 0, Complex(3, 4));
+    Matrix<Complex> merged = cm.to_matrix();
+    EXPECT_EQ(Complex(1.5, -2.5), merged(0, 1));
+    EXPECT_EQ(Complex(3, 4), merged(1, 0));
+    EXPECT_EQ(Complex(0, 0), merged(1, 1));
+}
+
+// Apply - Every element is transformed in place
+TEST(ElementwiseTransforms, ApplyIsCorrect) {
+    Matrix<int> m({1,2,3,4});
+    m.apply([](int x) { return x * x; });
+    EXPECT_EQ(1, m(0,0));
+    EXPECT_EQ(4, m(0,1));
+    EXPECT_EQ(9, m(1,0));
+    EXPECT_EQ(16, m(1,1));
+}
+
+// Map - Returns a new matrix, possibly of another element type
+TEST(ElementwiseTransforms, MapIsCorrect) {
+    const Matrix<int> m({1,2,3,4});
+    Matrix<double> half = m.map([](int x) { return x / 2.0; });
+    EXPECT_EQ(2, half.rows());
+    EXPECT_EQ(0.5, half(0,0));
+    EXPECT_EQ(2.0, half(1,1));
+    EXPECT_EQ(4, m(1,1));
+}
+
+// Zip apply - Combines with the element in the same position of another matrix
+TEST(ElementwiseTransforms, ZipApplyIsCorrect) {
+    Matrix<int> m({1,2,3,4});
+    Matrix<int> m2({10,20,30,40});
+    m.zip_apply(m2, [](int x, int y) { return y - x; });
+    EXPECT_EQ(9, m(0,0));
+    EXPECT_EQ(36, m(1,1));
+    EXPECT_THROW(m.zip_apply(Matrix<int>(3), [](int x, int y) { return x + y; }), std::out_of_range);
+}
+
+// Large matrices - Threaded path gives the same result as the serial one
+TEST(ElementwiseTransforms, LargeMatrixIsCorrect) {
+    Matrix<double> m(1000, 300);
+    double i = 0;
+    for (double & x : m) {
+        x = i++;
+    }
+    Matrix<double> doubled = m.map([](double x) { return 2 * x; });
+    m.zip_apply(doubled, [](double x, double y) { return y - x; });
+    m.apply([](double x) { return x + 1; });
+    for (size_t r = 0; r < m.rows(); r += 97) {
+        EXPECT_EQ(r * 300.0 + 1, m(r, 0));
+    }
+    EXPECT_EQ(300000.0, m(999, 299));
+
+    Matrix<double> sum = m + doubled;
+    Matrix<double> difference = doubled - m;
+    EXPECT_EQ(899998.0, sum(999, 299));
+    EXPECT_EQ(299998.0, difference(999, 299));
+
+    EXPECT_THROW(m.apply([](double x) -> double { if (x > 1000) { throw std::runtime_error("too large"); } return x; }), std::runtime_error);
+}
+
+// First-touch placement - Elements are default initialised like the serial constructor
+TEST(MatrixConstructors, FirstTouchCorrectSize) {
+    Matrix<double> m(700, 200, Placement::FirstTouch);
+    EXPECT_EQ(700, m.rows());
+    EXPECT_EQ(200, m.cols());
+    EXPECT_EQ(0.0, std::accumulate(m.begin(), m.end(), 0.0));
+
+    Matrix<int> small(2, 3, Placement::Serial);
+    EXPECT_EQ(0, small(1,2));
+}
+
+// Worker pinning - Kernels still visit every tile once
+TEST(ElementwiseTransforms, PinnedWorkersAreCorrect) {
+    EXPECT_TRUE(set_worker_pinning(true));
+    EXPECT_TRUE(worker_pinning());
+
+    Matrix<double> m(700, 200, Placement::FirstTouch);
+    m.apply([](double x) { return x + 1; });
+    EXPECT_EQ(140000.0, std::accumulate(m.begin(), m.end(), 0.0));
+
+    set_worker_pinning(false);
+    EXPECT_FALSE(worker_pinning());
+}
+
+// Kernels called from inside a tile callback run serially instead of waiting on the busy workers
+TEST(ElementwiseTransforms, NestedKernelsAreCorrect) {
+    Matrix<double> m(700, 200);
+    Matrix<double> inner(700, 200);
+    std::atomic<size_t> correct(0);
+    parallel_for_each_tile(m.tiles(350), [&](const MatrixTile<double> &) {
+        Matrix<double> shifted = inner.map([](double x) { return x + 2; });
+        if (shifted(699, 199) == 2.0) {
+            correct++;
+        }
+    });
+    EXPECT_EQ(2, correct);
+}
+
+// Copy-on-write - Copies share storage until one of them is changed
+TEST(CowMatrix, CopySharesUntilWrite) {
+    CowMatrix<int> m({1,2,3,4});
+    CowMatrix<int> snapshot = m;
+    EXPECT_TRUE(m.is_shared());
+    EXPECT_EQ(m.matrix().data(), snapshot.matrix().data());
+
+    m(0,0) = 10;
+    EXPECT_FALSE(m.is_shared());
+    EXPECT_FALSE(snapshot.is_shared());
+    EXPECT_EQ(10, m(0,0));
+    EXPECT_EQ(1, snapshot(0,0));
+}
+
+// Copy-on-write - Iterators and row/column edits also clone
+TEST(CowMatrix, EditsCloneSharedStorage) {
+    CowMatrix<int> m({1,2,3,4});
+    CowMatrix<int> byIterator = m;
+    CowMatrix<int> byRow = m;
+    CowMatrix<int> byEdit = m;
+
+    std::fill(byIterator.begin(), byIterator.end(), 0);
+    for (int & x : byRow.row(1)) {
+        x = -1;
+    }
+    byEdit.remove_column(0);
+
+    EXPECT_EQ(0, byIterator(1,1));
+    EXPECT_EQ(-1, byRow(1,0));
+    EXPECT_EQ(1, byEdit.cols());
+    EXPECT_EQ(2, m.cols());
+    EXPECT_EQ(10, std::accumulate(m.cbegin(), m.cend(), 0));
+
+    const CowMatrix<int> & cm = m;
+    EXPECT_EQ(6, std::accumulate(cm.column(1).begin(), cm.column(1).end(), 0));
+
+    CowMatrix<int> byBulkEdit = m;
+    byBulkEdit.insert_rows(0, 2);
+    byBulkEdit.insert_columns(2, 1);
+    byBulkEdit.remove_rows({1});
+    byBulkEdit.remove_columns({0});
+    EXPECT_EQ(3, byBulkEdit.rows());
+    EXPECT_EQ(2, byBulkEdit.cols());
+    EXPECT_EQ(2, byBulkEdit(1,0));
+
+    CowMatrix<int> byScatter = m;
+    CowMatrix<int> swapped = m.gather_rows({1, 0});
+    byScatter.scatter_rows({0, 1}, swapped);
+    EXPECT_EQ(3, byScatter(0,0));
+    EXPECT_EQ(2, swapped(1,1));
+    EXPECT_EQ(10, std::accumulate(m.cbegin(), m.cend(), 0));
+    EXPECT_EQ(1, m(0,0));
+}
+
+// Copy-on-write - Moved-from matrices are valid empty matrices that can be reused
+TEST(CowMatrix, MovedFromIsEmpty) {
+    CowMatrix<int> m({1,2,3,4});
+    CowMatrix<int> moved(std::move(m));
+    EXPECT_EQ(0, m.rows());
+    EXPECT_EQ(0, m.cols());
+    EXPECT_EQ(m.cbegin(), m.cend());
+    EXPECT_EQ(4, moved(1,1));
+
+    CowMatrix<int> assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(0, moved.rows());
+    EXPECT_EQ(0, moved.cols());
+    EXPECT_EQ(4, assigned(1,1));
+
+    m.mutable_matrix() = Matrix<int>(3);
+    EXPECT_EQ(3, m.rows());
+    EXPECT_EQ(0, moved.rows());
+    m = assigned;
+    EXPECT_EQ(1, m(0,0));
+}
+
+// Copy-on-write - Threads copying one snapshot and changing their copies do not disturb each other
+TEST(CowMatrix, ConcurrentCopiesAreIndependent) {
+    const CowMatrix<int> snapshot(200, 200);
+    std::vector<std::thread> threads;
+    std::vector<int> sums(8);
+    for (size_t t = 0; t < sums.size(); t++) {
+        threads.emplace_back([&snapshot, &sums, t]() {
+            for (int round = 0; round < 50; round++) {
+                CowMatrix<int> copy = snapshot;
+                copy(t, t) = static_cast<int>(t) + 1;
+                sums[t] = std::accumulate(copy.cbegin(), copy.cend(), 0);
+            }
+        });
+    }
+    for (std::thread & thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < sums.size(); t++) {
+        EXPECT_EQ(static_cast<int>(t) + 1, sums[t]);
+    }
+    EXPECT_EQ(0, std::accumulate(snapshot.begin(), snapshot.end(), 0));
+    EXPECT_FALSE(snapshot.is_shared());
+}
+
+// Fills a dense 4 x 4 matrix with distinct values
+Matrix<double> denseTestMatrix() {
+    Matrix<double> m(4, 4);
+    double value = 1;
+    for (double & x : m) {
+        x = value;
+        value += 1.5;
+    }
+    return m;
+}
+
+// Checks that a structured product/sum matches the same operation on its dense copy
+template<typename S>
+void expectMatchesDense(const S & s) {
+    Matrix<double> dense = denseTestMatrix();
+    Matrix<double> sDense = s.to_dense();
+    Matrix<double> expected[] = {sDense * dense, dense * sDense, sDense + dense, dense - sDense};
+    Matrix<double> actual[] = {s * dense, dense * s, s + dense, dense - s};
+    for (size_t n = 0; n < 4; n++) {
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = 0; j < 4; j++) {
+                EXPECT_NEAR(expected[n](i, j), actual[n](i, j), 1e-9);
+            }
+        }
+    }
+}
+
+// Checks that s * solve(b) gives back b
+template<typename S>
+void expectSolves(const S & s) {
+    Matrix<double> b = denseTestMatrix();
+    Matrix<double> x = s.solve(b);
+    Matrix<double> back = s * x;
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            EXPECT_NEAR(b(i, j), back(i, j), 1e-9);
+        }
+    }
+}
+
+// Diagonal matrix - Identity stores dim elements and products match the dense product
+TEST(StructuredMatrix, DiagonalIsCorrect) {
+    DiagonalMatrix<double> id = DiagonalMatrix<double>::identity(4);
+    EXPECT_EQ(1.0, id(2,2));
+    EXPECT_EQ(0.0, id(2,1));
+    Matrix<double> dense = denseTestMatrix();
+    Matrix<double> product = id * dense;
+    EXPECT_EQ(dense(3,1), product(3,1));
+
+    DiagonalMatrix<double> d({2, -1, 4, 0.5});
+    expectMatchesDense(d);
+    expectSolves(d);
+    EXPECT_EQ(-2.0, (d * d + id)(1,1) - 4);
+    EXPECT_THROW(d.set(0, 1, 3), std::out_of_range);
+    EXPECT_THROW(DiagonalMatrix<double>(4).solve(dense), std::out_of_range);
+}
+
+// Triangular matrices - Packed storage, products and substitution
+TEST(StructuredMatrix, TriangularIsCorrect) {
+    for (Triangle triangle : {Triangle::Upper, Triangle::Lower}) {
+        TriangularMatrix<double> t(4, triangle);
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = t.first_col(i); j < t.last_col(i); j++) {
+                t.set(i, j, (i == j) ? 4.0 : 1.0 + i - 0.5 * j);
+            }
+        }
+        EXPECT_EQ(0.0, (triangle == Triangle::Upper) ? t(3,0) : t(0,3));
+        EXPECT_THROW(t.set((triangle == Triangle::Upper) ? 3 : 0, (triangle == Triangle::Upper) ? 0 : 3, 1.0), std::out_of_range);
+        expectMatchesDense(t);
+        expectSolves(t);
+    }
+}
+
+// Banded matrix - Products and banded elimination
+TEST(StructuredMatrix, BandedIsCorrect) {
+    BandedMatrix<double> b(4, 1, 2);
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = b.first_col(i); j < b.last_col(i); j++) {
+            b.set(i, j, (i == j) ? 6.0 : 1.0 + j);
+        }
+    }
+    EXPECT_EQ(0.0, b(3,0));
+    EXPECT_EQ(0.0, b(0,3));
+    EXPECT_EQ(2.0, b(2,1));
+    EXPECT_THROW(b.set(3, 0, 1.0), std::out_of_range);
+    expectMatchesDense(b);
+    expectSolves(b);
+}
+
+// Symmetric matrix - Mirrored elements share storage
+TEST(StructuredMatrix, SymmetricIsCorrect) {
+    SymmetricMatrix<double> s(4);
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j <= i; j++) {
+            s.set(i, j, (i == j) ? 10.0 : 1.0 + i + j);
+        }
+    }
+    s.set(0, 3, -2.0);
+    EXPECT_EQ(-2.0, s(3,0));
+    expectMatchesDense(s);
+    expectSolves(s);
+}
+
+// Reference correlation straight from the definition, with padding handled by bounds checks
+Matrix<double> naiveCorrelate(const Matrix<double> & in, const Matrix<double> & k, size_t padTop, size_t padLeft,
+                              size_t outRows, size_t outCols, size_t stride) {
+    Matrix<double> out(outRows, outCols);
+    for (size_t r = 0; r < outRows; r++) {
+        for (size_t c = 0; c < outCols; c++) {
+            for (size_t u = 0; u < k.rows(); u++) {
+                for (size_t v = 0; v < k.cols(); v++) {
+                    long i = long(r * stride + u) - long(padTop);
+                    long j = long(c * stride + v) - long(padLeft);
+                    if (i >= 0 && j >= 0 && i < long(in.rows()) && j < long(in.cols())) {
+                        out(r, c) += k(u, v) * in(i, j);
+                    }
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Correlation - Both methods match the definition for every padding mode and stride
+TEST(Convolution, CorrelationMatchesDefinition) {
+    Matrix<double> in(9, 11);
+    Matrix<double> k(3, 4);
+    double value = 0;
+    for (double & x : in) {
+        x = std::sin(value += 0.7);
+    }
+    for (double & x : k) {
+        x = std::cos(value += 1.3);
+    }
+
+    for (size_t stride : {1, 2}) {
+        for (ConvolutionMethod method : {ConvolutionMethod::Direct, ConvolutionMethod::Im2col}) {
+            ConvolutionOptions options;
+            options.stride_rows = options.stride_cols = stride;
+            options.method = method;
+
+            options.padding = Padding::Valid;
+            Matrix<double> valid = correlate2d(in, k, options);
+            Matrix<double> expectedValid = naiveCorrelate(in, k, 0, 0, (9 - 3) / stride + 1, (11 - 4) / stride + 1, stride);
+
+            options.padding = Padding::Same;
+            Matrix<double> same = correlate2d(in, k, options);
+            Matrix<double> expectedSame = naiveCorrelate(in, k, 1, 1, (9 - 1) / stride + 1, (11 - 1) / stride + 1, stride);
+
+            options.padding = Padding::Full;
+            Matrix<double> full = correlate2d(in, k, options);
+            Matrix<double> expectedFull = naiveCorrelate(in, k, 2, 3, (9 + 1) / stride + 1, (11 + 2) / stride + 1, stride);
+
+            for (auto pair : {std::make_pair(&valid, &expectedValid), std::make_pair(&same, &expectedSame), std::make_pair(&full, &expectedFull)}) {
+                ASSERT_EQ(pair.second->rows(), pair.first->rows());
+                ASSERT_EQ(pair.second->cols(), pair.first->cols());
+                for (size_t i = 0; i < pair.first->rows(); i++) {
+                    for (size_t j = 0; j < pair.first->cols(); j++) {
+                        EXPECT_NEAR((*pair.second)(i, j), (*pair.first)(i, j), 1e-12);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Filter banks - Each output matches the single-kernel correlation, whichever method runs
+TEST(Convolution, FilterBankMatchesSingleKernels) {
+    Matrix<double> in(40, 37);
+    double value = 0;
+    for (double & x : in) {
+        x = std::sin(value += 0.3);
+    }
+    std::vector<Matrix<double>> kernels;
+    for (size_t f = 0; f < 5; f++) {  // One block of 4 filters and one left over
+        kernels.emplace_back(3, 3);
+        for (double & x : kernels.back()) {
+            x = std::cos(value += 0.9);
+        }
+    }
+
+    for (ConvolutionMethod method : {ConvolutionMethod::Auto, ConvolutionMethod::Direct, ConvolutionMethod::Im2col}) {
+        ConvolutionOptions options;
+        options.padding = Padding::Same;
+        options.method = method;
+        std::vector<Matrix<double>> outs = correlate2d(in, kernels, options);
+        ASSERT_EQ(5, outs.size());
+        for (size_t f = 0; f < kernels.size(); f++) {
+            Matrix<double> expected = naiveCorrelate(in, kernels[f], 1, 1, 40, 37, 1);
+            for (size_t i = 0; i < expected.rows(); i++) {
+                for (size_t j = 0; j < expected.cols(); j++) {
+                    EXPECT_NEAR(expected(i, j), outs[f](i, j), 1e-12);
+                }
+            }
+        }
+    }
+
+    kernels.emplace_back(2, 3);
+    EXPECT_THROW(correlate2d(in, kernels), std::out_of_range);
+    EXPECT_TRUE(correlate2d(in, std::vector<Matrix<double>>()).empty());
+}
+
+// Convolution - Flips the kernel; an impulse reproduces the kernel
+TEST(Convolution, ConvolutionFlipsKernel) {
+    Matrix<int> impulse(5, 5);
+    impulse(2, 2) = 1;
+    Matrix<int> k({1,2,3,4,5,6,7,8,9});
+    ConvolutionOptions options;
+    options.padding = Padding::Same;
+    Matrix<int> out = convolve2d(impulse, k, options);
+    EXPECT_EQ(1, out(1,1));
+    EXPECT_EQ(5, out(2,2));
+    EXPECT_EQ(9, out(3,3));
+    EXPECT_EQ(0, out(0,0));
+
+    Matrix<int> correlated = correlate2d(impulse, k, options);
+    EXPECT_EQ(9, correlated(1,1));
+    std::vector<Matrix<int>> bank = convolve2d(impulse, std::vector<Matrix<int>>{k, k}, options);
+    EXPECT_EQ(1, bank[0](1,1));
+    EXPECT_EQ(9, bank[1](3,3));
+    EXPECT_THROW(correlate2d(Matrix<int>(2), k), std::out_of_range);
+}
+
+// Bulk row insert - Rows of zeroes in the middle and at the end
+TEST(RowOperations, InsertRowsIsCorrect) {
+    Matrix<int> m({1,2,3,4});
+    m.insert_rows(1, 2);
+    EXPECT_EQ(4, m.rows());
+    EXPECT_EQ(1, m(0,0));
+    EXPECT_EQ(0, m(1,1));
+    EXPECT_EQ(0, m(2,0));
+    EXPECT_EQ(4, m(3,1));
+    m.insert_rows(4, 1);
+    EXPECT_EQ(5, m.rows());
+    EXPECT_EQ(0, m(4,1));
+    EXPECT_THROW(m.insert_rows(6, 1), std::out_of_range);
+}
+
+// Bulk column insert - Columns of zeroes to the left of pos
+TEST(ColOperations, InsertColumnsIsCorrect) {
+    Matrix<int> m({1,2,3,4});
+    m.insert_columns(1, 2);
+    EXPECT_EQ(4, m.cols());
+    EXPECT_EQ(1, m(0,0));
+    EXPECT_EQ(0, m(0,1));
+    EXPECT_EQ(2, m(0,3));
+    EXPECT_EQ(4, m(1,3));
+}
+
+// Bulk row removal - Many rows removed at once, remaining order kept
+TEST(RowOperations, RemoveRowsIsCorrect) {
+    Matrix<int> m(6, 2);
+    for (size_t i = 0; i < 6; i++) {
+        m(i, 0) = m(i, 1) = i;
+    }
+    m.remove_rows({0, 2, 3});
+    EXPECT_EQ(3, m.rows());
+    EXPECT_EQ(1, m(0,1));
+    EXPECT_EQ(4, m(1,0));
+    EXPECT_EQ(5, m(2,1));
+    EXPECT_EQ(6, m.end() - m.begin());
+    Matrix<int> copy = m;
+    EXPECT_EQ(5, copy(2,1));
+    EXPECT_EQ(6, copy.end() - copy.begin());
+    EXPECT_THROW(m.remove_rows({2, 1}), std::out_of_range);
+    EXPECT_THROW(m.remove_rows({3}), std::out_of_range);
+}
+
+// Bulk column removal - Compacted in place
+TEST(ColOperations, RemoveColumnsIsCorrect) {
+    Matrix<int> m({1,2,3,4,5,6,7,8,9});
+    m.remove_columns({0, 2});
+    EXPECT_EQ(3, m.rows());
+    EXPECT_EQ(1, m.cols());
+    EXPECT_EQ(2, m(0,0));
+    EXPECT_EQ(5, m(1,0));
+    EXPECT_EQ(8, m(2,0));
+    EXPECT_THROW(m.remove_columns({0, 0}), std::out_of_range);
+}
+
+// Gather and scatter - Rows picked and written back by index
+TEST(RowOperations, GatherScatterIsCorrect) {
+    Matrix<int> m({1,2,3,4,5,6,7,8,9});
+    Matrix<int> picked = m.gather_rows({2, 0, 2});
+    EXPECT_EQ(3, picked.rows());
+    EXPECT_EQ(7, picked(0,0));
+    EXPECT_EQ(3, picked(1,2));
+    EXPECT_EQ(9, picked(2,2));
+
+    picked.apply([](int x) { return -x; });
+    m.scatter_rows({1, 0, 2}, picked);
+    EXPECT_EQ(-7, m(1,0));
+    EXPECT_EQ(-1, m(0,0));
+    EXPECT_EQ(-9, m(2,2));
+    EXPECT_THROW(m.gather_rows({3}), std::out_of_range);
+    EXPECT_THROW(m.scatter_rows({0}, picked), std::out_of_range);
+}
+
+// Stacking - Side by side and on top of each other
+TEST(Stacking, HstackVstackAreCorrect) {
+    Matrix<int> a({1,2,3,4});
+    Matrix<int> b(2, 1);
+    b(0,0) = 5;
+    b(1,0) = 6;
+    Matrix<int> h = hstack(a, b);
+    EXPECT_EQ(2, h.rows());
+    EXPECT_EQ(3, h.cols());
+    EXPECT_EQ(5, h(0,2));
+    EXPECT_EQ(3, h(1,0));
+
+    Matrix<int> v = vstack(a, Matrix<int>({7,8,9,10}));
+    EXPECT_EQ(4, v.rows());
+    EXPECT_EQ(2, v(0,1));
+    EXPECT_EQ(9, v(3,0));
+    EXPECT_THROW(hstack(a, Matrix<int>(3)), std::out_of_range);
+    EXPECT_THROW(vstack(a, b), std::out_of_range);
+}
+
+// Mixed precision - Float inputs accumulated in double stay accurate over a long inner dimension
+TEST(MixedPrecision, WideAccumulatorIsAccurate) {
+    const size_t n = 1 << 20;
+    Matrix<float> row(1, n);
+    Matrix<float> col(n, 1);
+    row.apply([](float) { return 0.1f; });
+    col.apply([](float) { return 1.0f; });
+    const double exact = n * static_cast<double>(0.1f);
+
+    Matrix<float> narrow = row * col;
+    Matrix<double> wide = multiply<double>(row, col);
+    Matrix<float> rounded(wide);
+    EXPECT_NEAR(exact, wide(0,0), 1e-6);
+    EXPECT_EQ(static_cast<float>(exact), rounded(0,0));
+    EXPECT_GT(std::abs(narrow(0,0) - exact), std::abs(rounded(0,0) - exact));
+}
+
+// Mixed precision - int16 products accumulated in int32 do not overflow
+TEST(MixedPrecision, Int16ProductPromotes) {
+    Matrix<int16_t> a(2, 100);
+    Matrix<int16_t> b(100, 2);
+    a.apply([](int16_t) { return int16_t(300); });
+    b.apply([](int16_t) { return int16_t(-300); });
+    Matrix<int32_t> product = multiply<int32_t>(a, b);
+    EXPECT_EQ(-9000000, product(1,1));
+
+    Matrix<int> promoted = a * Matrix<int>(b);
+    EXPECT_EQ(-9000000, promoted(0,1));
+}
+
+// Cross-type product - Result has the promoted element type
+TEST(MixedPrecision, CrossTypeProduct) {
+    Matrix<float> f({1.5f, 2, 3, 4});
+    Matrix<double> d({0.25, 0, 0, 0.25});
+    auto product = f * d;
+    static_assert(std::is_same<decltype(product), Matrix<double>>::value, "float * double gives double");
+    EXPECT_EQ(0.375, product(0,0));
+    EXPECT_EQ(1.0, product(1,1));
+    EXPECT_THROW(f * Matrix<double>(3), std::out_of_range);
+}
+
+// Stats - Counters record calls, flops and bytes per operation, all zero when MATRIX_STATS is off
+TEST(Stats, CountsOperations) {
+    Matrix<double> a(4, 8);
+    Matrix<double> b(8, 2);
+    reset_matrix_stats();
+    Matrix<double> product = a * b;
+    Matrix<double> sum = product + product;
+    sum.insert_row(0);
+    std::stringstream ss;
+    ss << sum;
+
+    MatrixStats stats = matrix_stats();
+    if (matrix_stats_enabled()) {
+        EXPECT_EQ(1u, stats[MatrixOp::Multiply].calls);
+        EXPECT_EQ(2u * 4 * 8 * 2, stats[MatrixOp::Multiply].flops);
+        EXPECT_EQ(1u, stats[MatrixOp::Add].calls);
+        EXPECT_EQ(1u, stats[MatrixOp::RowColumnEdit].calls);
+        EXPECT_EQ(1u, stats[MatrixOp::Output].calls);
+        EXPECT_GE(stats.allocations, 2u);
+        EXPECT_GT(stats[MatrixOp::Multiply].bytes, 0u);
+    } else {
+        EXPECT_EQ(0u, stats.allocations);
+        EXPECT_EQ(0u, stats[MatrixOp::Multiply].calls);
+    }
+    reset_matrix_stats();
+    EXPECT_EQ(0u, matrix_stats()[MatrixOp::Add].calls);
+}
+
+// Stats - The dumper writes a report to its stream every interval until it is destroyed
+TEST(Stats, PeriodicDump) {
+    std::stringstream ss;
+    {
+        MatrixStatsDumper dumper(ss, std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_NE(std::string::npos, ss.str().find("matrix allocations"));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();